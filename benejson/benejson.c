@@ -4,9 +4,53 @@
 #include <assert.h>
 #include "benejson.h"
 
+#ifdef BNJ_FLOAT_SUPPORT
+/* For strtod fallback. */
+#include <stdlib.h>
+#endif
+
+#ifdef BNJ_SIMD_SUPPORT
+	#if defined(__AVX2__)
+		#include <immintrin.h>
+		#define BNJ_AVX2
+	#elif defined(__SSE2__)
+		#include <emmintrin.h>
+		#define BNJ_SSE2
+	#endif
+#endif
+
 #define TOP3 ((SIGNIFICAND)(0x7) << (sizeof(SIGNIFICAND) * 8 - 3))
 #define SETSTATE(x,s) x = s
 
+#if defined(BNJ_THREADED_DISPATCH) && defined(__GNUC__)
+/* Each parser state case is also a label, so the parser jumps from one
+ * state straight to the next rather than back through the switch. */
+#define STATE_CASE(s) case s: L_##s
+#define DEFAULT_CASE default: L_DEFAULT
+
+/* Continue parsing in state s; state->flags must already be s. */
+#define GOTO_STATE(s) do{ if(i == end) goto parse_end; goto L_##s; }while(0)
+
+/* Continue parsing in the state held by state->flags. */
+#define NEXT_STATE() \
+	do{ if(i == end) goto parse_end; goto *s_dispatch[state->flags]; }while(0)
+
+/* GCC will not inline a function containing a computed goto. */
+#define PARSE_INLINE
+
+#else
+#undef BNJ_THREADED_DISPATCH
+#define STATE_CASE(s) case s
+#define DEFAULT_CASE default
+#define GOTO_STATE(s) break
+#define NEXT_STATE() break
+#ifdef __GNUC__
+#define PARSE_INLINE inline __attribute__((always_inline))
+#else
+#define PARSE_INLINE inline
+#endif
+#endif
+
 enum {
 	/* Character is invalid . */
 	CINV = 0x1,
@@ -26,7 +70,21 @@ enum {
 
 enum {
 	/** @brief OK to read comma, used in stack context. */
-	BNJ_EXPECT_COMMA = 0x8
+	BNJ_EXPECT_COMMA = 0x8,
+
+	/** @brief Projection left out the number or literal being parsed. */
+	BNJ_PROJ_DROP = 0x10,
+
+	/** @brief Projection is skipping a map or list one deeper. */
+	BNJ_PROJ_SKIP = 0x20,
+
+	/** @brief Projection left out the rest of this list. */
+	BNJ_PROJ_REST = 0x40,
+
+	/** @brief With a projection, list element index is kept in the high bits. */
+	BNJ_PROJ_INDEX_SHIFT = 8,
+	BNJ_PROJ_INDEX_ONE = 1 << BNJ_PROJ_INDEX_SHIFT,
+	BNJ_PROJ_INDEX_SUP = 0xFFFFFF00
 };
 
 /* Valid whitespace characters are 0x09, 0x0A, 0x0D, 0x20 */
@@ -100,6 +158,11 @@ enum {
 	BNJ_OTHER_VALS,
 	BNJ_STRING_START,
 
+	/* bnj_skip: outside strings, inside, and just after a backslash. */
+	BNJ_SKIP,
+	BNJ_SKIP_STR,
+	BNJ_SKIP_ESC,
+
 	BNJ_COUNT_STATES
 };
 
@@ -116,6 +179,343 @@ static uint8_t s_hex(uint8_t c){
 	return (c <= '9') ? c - '0' : (c & 0xDF) -'7';
 }
 
+/* Bit scans of 64 bit masks; x must be nonzero for s_ctz64 and s_clz64.
+ * Loops stand in where the GCC builtins are missing. */
+static inline unsigned s_ctz64(uint64_t x){
+#ifdef __GNUC__
+	return __builtin_ctzll(x);
+#else
+	unsigned n = 0;
+	for(; !(x & 1); x >>= 1)
+		++n;
+	return n;
+#endif
+}
+
+static inline unsigned s_clz64(uint64_t x){
+#ifdef __GNUC__
+	return __builtin_clzll(x);
+#else
+	unsigned n = 0;
+	for(; !(x >> 63); x <<= 1)
+		++n;
+	return n;
+#endif
+}
+
+static inline unsigned s_popcount64(uint64_t x){
+#ifdef __GNUC__
+	return __builtin_popcountll(x);
+#else
+	unsigned n = 0;
+	for(; x; x &= x - 1)
+		++n;
+	return n;
+#endif
+}
+
+/* Word-at-a-time helpers. Only valid on little endian machines, since the
+ * lowest flagged byte must be the first byte in memory. */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	#define BNJ_SWAR
+	#define SWAR_ONES ((uint64_t)0x0101010101010101ULL)
+	#define SWAR_HIGHS ((uint64_t)0x8080808080808080ULL)
+
+/* High bit set in each byte of x that is less than n (n <= 128).
+ * False positives only appear above a true positive. */
+#define SWAR_LESS(x,n) (((x) - SWAR_ONES * (n)) & ~(x) & SWAR_HIGHS)
+
+/* High bit set in each byte of x that equals c. Same caveat as above. */
+#define SWAR_EQ(x,c) SWAR_LESS((x) ^ (SWAR_ONES * (c)), 1)
+
+/* High bit set in each byte of x that is zero. Exact, no false positives. */
+#define SWAR_ZERO(x) \
+	(~((((x) & ~SWAR_HIGHS) + ~SWAR_HIGHS) | (x)) & SWAR_HIGHS)
+#endif
+
+#ifdef BNJ_SWAR
+/* Largest significand that takes 8 more digits without reaching
+ * SIGNIFICAND_MAX; beyond that the per digit overflow check decides. */
+#define SWAR_DIGITS_SUP ((SIGNIFICAND_MAX - 99999999) / 100000000)
+
+/* Nonzero byte in each position of x that is not an ASCII digit.
+ * Exact up to and including the first such byte. */
+static inline uint64_t s_swar_nondigits(uint64_t x){
+	const uint64_t hi = x & 0xF0F0F0F0F0F0F0F0ULL;
+	const uint64_t carry = ((x + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4;
+	return (hi | carry) ^ 0x3333333333333333ULL;
+}
+
+static const uint32_t s_pow10[8] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000
+};
+
+/* Value of 8 ASCII digits, first digit most significant. */
+static inline uint32_t s_swar_value(uint64_t x){
+	x -= 0x3030303030303030ULL;
+	/* Pairs, then quads, then all eight. */
+	x = (x * 10) + (x >> 8);
+	x = (((x & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+		+ (((x >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+	return x;
+}
+#endif
+
+/* Find end of a run of plain ASCII string content.
+ * @return First byte in [i, end) that is a '"', '\\', control character or
+ * has its high bit set; end if there is no such byte. */
+static inline const uint8_t* s_scan_ascii(const uint8_t* i,
+	const uint8_t* const end)
+{
+#if defined(BNJ_AVX2)
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i bslash = _mm256_set1_epi8('\\');
+	const __m256i space = _mm256_set1_epi8(' ');
+	while(end - i >= 32){
+		__m256i v = _mm256_loadu_si256((const __m256i*)i);
+
+		/* Signed compare catches both control chars and bytes >= 0x80. */
+		__m256i m = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, bslash)),
+			_mm256_cmpgt_epi8(space, v));
+		uint32_t mask = _mm256_movemask_epi8(m);
+		if(mask)
+			return i + __builtin_ctz(mask);
+		i += 32;
+	}
+#endif
+
+#if defined(BNJ_AVX2) || defined(BNJ_SSE2)
+	{
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i bslash = _mm_set1_epi8('\\');
+		const __m128i space = _mm_set1_epi8(' ');
+		while(end - i >= 16){
+			__m128i v = _mm_loadu_si128((const __m128i*)i);
+			__m128i m = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash)),
+				_mm_cmplt_epi8(v, space));
+			unsigned mask = _mm_movemask_epi8(m);
+			if(mask)
+				return i + __builtin_ctz(mask);
+			i += 16;
+		}
+	}
+#elif defined(BNJ_SWAR)
+	while(end - i >= 8){
+		uint64_t x;
+		memcpy(&x, i, 8);
+		uint64_t m = (x & SWAR_HIGHS) | SWAR_LESS(x, 0x20)
+			| SWAR_EQ(x, '"') | SWAR_EQ(x, '\\');
+		if(m)
+			return i + (__builtin_ctzll(m) >> 3);
+		i += 8;
+	}
+#endif
+
+	/* Tail bytes. */
+	while(i != end && *i >= 0x20 && *i < 0x80 && *i != '"' && *i != '\\')
+		++i;
+	return i;
+}
+
+/* Skip a run of JSON whitespace.
+ * @return First byte in [i, end) that is not whitespace; end if none. */
+static inline const uint8_t* s_skip_ws(const uint8_t* i,
+	const uint8_t* const end)
+{
+	/* Single separating spaces are common; do not bother with blocks. */
+	if(i == end || !(s_lookup[*i] & CWHI))
+		return i;
+
+#if defined(BNJ_AVX2)
+	{
+		const __m256i sp = _mm256_set1_epi8(' ');
+		const __m256i tab = _mm256_set1_epi8('\t');
+		const __m256i nl = _mm256_set1_epi8('\n');
+		const __m256i cr = _mm256_set1_epi8('\r');
+		while(end - i >= 32){
+			__m256i v = _mm256_loadu_si256((const __m256i*)i);
+			__m256i m = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, tab)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, nl), _mm256_cmpeq_epi8(v, cr)));
+			uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(m);
+			if(mask)
+				return i + __builtin_ctz(mask);
+			i += 32;
+		}
+	}
+#endif
+
+#if defined(BNJ_AVX2) || defined(BNJ_SSE2)
+	{
+		const __m128i sp = _mm_set1_epi8(' ');
+		const __m128i tab = _mm_set1_epi8('\t');
+		const __m128i nl = _mm_set1_epi8('\n');
+		const __m128i cr = _mm_set1_epi8('\r');
+		while(end - i >= 16){
+			__m128i v = _mm_loadu_si128((const __m128i*)i);
+			__m128i m = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)),
+				_mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr)));
+			unsigned mask = ~_mm_movemask_epi8(m) & 0xFFFF;
+			if(mask)
+				return i + __builtin_ctz(mask);
+			i += 16;
+		}
+	}
+#elif defined(BNJ_SWAR)
+	while(end - i >= 8){
+		uint64_t x;
+		memcpy(&x, i, 8);
+		/* Need exact per byte matches here, since a false whitespace
+		 * match would skip a real token. */
+		uint64_t m = SWAR_ZERO(x ^ (SWAR_ONES * ' '))
+			| SWAR_ZERO(x ^ (SWAR_ONES * '\t'))
+			| SWAR_ZERO(x ^ (SWAR_ONES * '\n'))
+			| SWAR_ZERO(x ^ (SWAR_ONES * '\r'));
+		m = ~m & SWAR_HIGHS;
+		if(m)
+			return i + (__builtin_ctzll(m) >> 3);
+		i += 8;
+	}
+#endif
+
+	while(i != end && (s_lookup[*i] & CWHI))
+		++i;
+	return i;
+}
+
+/* Consume a run of complete, valid UTF-8 characters, adding each to the
+ * code point counts of v. Plain ASCII inside the run is accepted as well.
+ * Stops before '"', '\\', control characters, invalid or overlong sequences,
+ * encoded surrogates, code points beyond U+10FFFF and a final character that
+ * is cut off by end; the byte-wise states deal with those.
+ * @return First byte not consumed. */
+static inline const uint8_t* s_scan_utf8(const uint8_t* i,
+	const uint8_t* const end, bnj_val* v)
+{
+	unsigned cp1 = 0, cp2 = 0, cp3 = 0, cp4 = 0;
+
+#if defined(BNJ_AVX2) || defined(BNJ_SSE2)
+	/* Byte classes by signed compare:
+	 * 0x80-0xBF continuation, 0xC2-0xDF 2 byte lead, 0xE0-0xEF 3 byte lead,
+	 * 0xF0-0xF4 4 byte lead, 0x20-0x7F ASCII. Anything else stops the run.
+	 * The extra byte loaded past the block checks the second byte of a
+	 * character that begins at the last position. */
+	while(end - i > 16){
+		const __m128i v0 = _mm_loadu_si128((const __m128i*)i);
+		const __m128i v1 = _mm_loadu_si128((const __m128i*)(i + 1));
+
+		const unsigned a = _mm_movemask_epi8(
+			_mm_andnot_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v0, _mm_set1_epi8('"')),
+					_mm_cmpeq_epi8(v0, _mm_set1_epi8('\\'))),
+				_mm_cmpgt_epi8(v0, _mm_set1_epi8(0x1F))));
+		const unsigned c = _mm_movemask_epi8(
+			_mm_cmplt_epi8(v0, _mm_set1_epi8((char)0xC0)));
+		const unsigned l2 = _mm_movemask_epi8(
+			_mm_and_si128(_mm_cmpgt_epi8(v0, _mm_set1_epi8((char)0xC1)),
+				_mm_cmplt_epi8(v0, _mm_set1_epi8((char)0xE0))));
+		const unsigned l3 = _mm_movemask_epi8(
+			_mm_and_si128(_mm_cmpgt_epi8(v0, _mm_set1_epi8((char)0xDF)),
+				_mm_cmplt_epi8(v0, _mm_set1_epi8((char)0xF0))));
+		const unsigned l4 = _mm_movemask_epi8(
+			_mm_and_si128(_mm_cmpgt_epi8(v0, _mm_set1_epi8((char)0xEF)),
+				_mm_cmplt_epi8(v0, _mm_set1_epi8((char)0xF5))));
+
+		/* Leads whose second byte range is restricted. */
+		const unsigned lo_a0 = _mm_movemask_epi8(
+			_mm_cmplt_epi8(v1, _mm_set1_epi8((char)0xA0)));
+		const unsigned lo_90 = _mm_movemask_epi8(
+			_mm_cmplt_epi8(v1, _mm_set1_epi8((char)0x90)));
+		const unsigned special =
+			(_mm_movemask_epi8(_mm_cmpeq_epi8(v0, _mm_set1_epi8((char)0xE0))) & lo_a0)
+			| (_mm_movemask_epi8(_mm_cmpeq_epi8(v0, _mm_set1_epi8((char)0xED))) & ~lo_a0)
+			| (_mm_movemask_epi8(_mm_cmpeq_epi8(v0, _mm_set1_epi8((char)0xF0))) & lo_90)
+			| (_mm_movemask_epi8(_mm_cmpeq_epi8(v0, _mm_set1_epi8((char)0xF4))) & ~lo_90);
+
+		/* Positions the leads say must be continuation bytes. */
+		const unsigned expect = (((l2 | l3 | l4) << 1)
+			| ((l3 | l4) << 2) | (l4 << 3)) & 0xFFFF;
+		const unsigned stop = (~(a | c | l2 | l3 | l4) & 0xFFFF)
+			| (expect ^ c) | special;
+
+		/* Leads of characters that run past this block. */
+		const unsigned partial = (l2 & 0x8000) | (l3 & 0xC000) | (l4 & 0xE000);
+
+		unsigned len = 16;
+		if(stop){
+			/* Back up to the first byte of the character holding the error. */
+			const unsigned first = __builtin_ctz(stop);
+			const unsigned starts = ~expect & ((2u << first) - 1);
+			len = 31 - __builtin_clz(starts);
+		}
+		if(partial && (unsigned)__builtin_ctz(partial) < len)
+			len = __builtin_ctz(partial);
+
+		const unsigned keep = (1u << len) - 1;
+		cp1 += __builtin_popcount(a & keep);
+		cp2 += __builtin_popcount(l2 & keep);
+		cp3 += __builtin_popcount(l3 & keep);
+		cp4 += __builtin_popcount(l4 & keep);
+		i += len;
+		if(len != 16)
+			goto done;
+	}
+#endif
+
+	/* Character at a time. */
+	while(i != end){
+		const uint8_t b = *i;
+		if(b < 0x80){
+			if(b < 0x20 || '"' == b || '\\' == b)
+				break;
+			++cp1;
+			i += 1;
+		}
+		else if(b < 0xC2){
+			break;
+		}
+		else if(b < 0xE0){
+			if(end - i < 2 || (i[1] & 0xC0) != 0x80)
+				break;
+			++cp2;
+			i += 2;
+		}
+		else if(b < 0xF0){
+			if(end - i < 3
+				|| i[1] < ((0xE0 == b) ? 0xA0 : 0x80)
+				|| i[1] > ((0xED == b) ? 0x9F : 0xBF)
+				|| (i[2] & 0xC0) != 0x80)
+				break;
+			++cp3;
+			i += 3;
+		}
+		else if(b < 0xF5){
+			if(end - i < 4
+				|| i[1] < ((0xF0 == b) ? 0x90 : 0x80)
+				|| i[1] > ((0xF4 == b) ? 0x8F : 0xBF)
+				|| (i[2] & 0xC0) != 0x80 || (i[3] & 0xC0) != 0x80)
+				break;
+			++cp4;
+			i += 4;
+		}
+		else{
+			break;
+		}
+	}
+
+#if defined(BNJ_AVX2) || defined(BNJ_SSE2)
+done:
+#endif
+	v->cp1_count += cp1;
+	v->cp2_count += cp2;
+	v->cp3_count += cp3;
+	v->exp_val += cp4;
+	return i;
+}
+
 static inline void s_reset_state(bnj_state* state){
 	state->depth_change = 0;
 	state->vi = 0;
@@ -124,25 +524,65 @@ static inline void s_reset_state(bnj_state* state){
 	state->v[0].key_enum = 0;
 }
 
+/* Key set or key matcher of ctx, identifying what a key is matched with. */
+static inline const void* s_key_source(const bnj_ctx* ctx){
+	return ctx->key_matcher ? (const void*)ctx->key_matcher
+		: (const void*)ctx->key_set;
+}
+
+/* Context whose keys to match at depth; a projection level's if it has keys.
+ * @param level_ctx Filled in when returned. */
+static inline bnj_ctx* s_key_ctx(bnj_ctx* ctx, uint32_t depth,
+	bnj_ctx* level_ctx)
+{
+	const bnj_projection* p = ctx->projection;
+	if(!p || !depth || depth > p->length || !p->levels[depth - 1].key_set)
+		return ctx;
+	level_ctx->key_set = p->levels[depth - 1].key_set;
+	level_ctx->key_set_length = p->levels[depth - 1].key_set_length;
+	level_ctx->key_matcher = NULL;
+	return level_ctx;
+}
+
+/* Whether projection p leaves out the value v starting at state->depth > 0.
+ * @return 0 to report it, 1 to leave it out, 2 to leave out the rest of
+ * its list. */
+static inline unsigned s_proj_out(const bnj_state* state,
+	const bnj_projection* p, const bnj_val* v)
+{
+	if(state->depth > p->length)
+		return 0;
+
+	const bnj_projlevel* level = p->levels + state->depth - 1;
+	const uint32_t ctx = state->stack[state->depth];
+	if(ctx & BNJ_OBJECT)
+		return level->key_set && v->key_enum >= level->key_set_length;
+
+	const uint32_t index = ctx >> BNJ_PROJ_INDEX_SHIFT;
+	if(index >= level->last)
+		return 2;
+	return index < level->first;
+}
+
 static inline void s_match_key(bnj_state* state, bnj_ctx* ctx, uint8_t target){
 	const char* const *const key_set = ctx->key_set;
 	uint16_t* key_enum = &(state->v[state->vi].key_enum);
 	const uint32_t* key_length = &(state->_key_len);
 	/* Adjust minimum if necessary. */
 	if(target !=
-			key_set[*key_enum][*key_length])
+			(uint8_t)key_set[*key_enum][*key_length])
 	{
 		/* Binary search for least index with matching char. */
 		unsigned idx_high = state->_key_set_sup;
 		do{
 			unsigned mid = (*key_enum + idx_high) >> 1;
-			if(target > key_set[mid][*key_length]){
+			if(target > (uint8_t)key_set[mid][*key_length]){
 				/* Move up idx */
 				*key_enum = mid + 1;
 			}
 			else{ 
 				/* If satisfies max condition, update max. */
-				if(target < key_set[mid][*key_length])
+				if(target < (uint8_t)key_set[mid][*key_length])
 					state->_key_set_sup = mid;
 				idx_high = mid;
 			}
@@ -154,7 +594,7 @@ static inline void s_match_key(bnj_state* state, bnj_ctx* ctx, uint8_t target){
 	}
 
 	/* Adjust maximum if necessary. */
-	if(target != key_set[state->_key_set_sup - 1][*key_length]){
+	if(target != (uint8_t)key_set[state->_key_set_sup - 1][*key_length]){
 		/* May as well decrement supremum, since the if() just failed. */
 		--state->_key_set_sup;
 
@@ -163,7 +603,7 @@ static inline void s_match_key(bnj_state* state, bnj_ctx* ctx, uint8_t target){
 		do{
 			unsigned mid = (state->_key_set_sup + max_match) >> 1;
 			/* If mid > target, lower supremum. Otherwise raise lower bound. */
-			if(target < key_set[mid][*key_length])
+			if(target < (uint8_t)key_set[mid][*key_length])
 				state->_key_set_sup = mid;
 			else
 				max_match = mid;
@@ -171,6 +611,333 @@ static inline void s_match_key(bnj_state* state, bnj_ctx* ctx, uint8_t target){
 	}
 }
 
+/* Compare n bytes using overlapping loads instead of a byte loop.
+ * @return Nonzero if equal. */
+static inline unsigned s_keytail_eq(const uint8_t* a, const uint8_t* b,
+	uint32_t n)
+{
+	if(n >= 8){
+		uint64_t x, y;
+		uint32_t o;
+		for(o = 0; o + 8 < n; o += 8){
+			memcpy(&x, a + o, 8);
+			memcpy(&y, b + o, 8);
+			if(x != y)
+				return 0;
+		}
+		memcpy(&x, a + n - 8, 8);
+		memcpy(&y, b + n - 8, 8);
+		return x == y;
+	}
+	if(n >= 4){
+		uint32_t x0, y0, x1, y1;
+		memcpy(&x0, a, 4);
+		memcpy(&y0, b, 4);
+		memcpy(&x1, a + n - 4, 4);
+		memcpy(&y1, b + n - 4, 4);
+		return !((x0 ^ y0) | (x1 ^ y1));
+	}
+	if(n)
+		return !((a[0] ^ b[0]) | (a[n >> 1] ^ b[n >> 1]) | (a[n - 1] ^ b[n - 1]));
+	return 1;
+}
+
+/* Advance key matcher row by one key byte. Row 0 never leaves row 0.
+ * Matcher state lives in _key_set_sup while matching a key. */
+static inline uint32_t s_keymatcher_next(const bnj_keymatcher* km,
+	uint32_t row, uint8_t c)
+{
+	return km->table[row * km->stride + km->byte_class[c]];
+}
+
+/* Match one byte of a key's unescaped text. */
+static inline void s_key_match(bnj_state* state, bnj_ctx* ctx, bnj_val* v,
+	uint8_t c)
+{
+	if(v->type & BNJ_VFLAG_KEY_FRAGMENT){
+		if(ctx->key_matcher)
+			state->_key_set_sup =
+				s_keymatcher_next(ctx->key_matcher, state->_key_set_sup, c);
+		else if(ctx->key_set && state->_key_set_sup != v->key_enum)
+			s_match_key(state, ctx, c);
+		++(state->_key_len);
+	}
+}
+
+/* Account for one byte of an escape inside a key. The escape is matched
+ * once decoded; see s_key_cp(). */
+static inline void s_key_esc(bnj_val* v){
+	if(v->type & BNJ_VFLAG_KEY_FRAGMENT)
+		++(v->key_length);
+}
+
+/* Match the code point of a completed escape inside a key as UTF-8. */
+static inline void s_key_cp(bnj_state* state, bnj_ctx* ctx, bnj_val* v,
+	uint32_t cp)
+{
+	if(v->type & BNJ_VFLAG_KEY_FRAGMENT){
+		uint8_t utf8[4];
+		const uint8_t* end = bnj_utf8_char(utf8, 4, cp);
+		for(const uint8_t* c = utf8; c != end; ++c)
+			s_key_match(state, ctx, v, *c);
+	}
+}
+
+/* Account for one byte of a multibyte char inside a key. */
+static inline void s_key_byte(bnj_state* state, bnj_ctx* ctx, bnj_val* v,
+	uint8_t c)
+{
+	s_key_match(state, ctx, v, c);
+	if(v->type & BNJ_VFLAG_KEY_FRAGMENT)
+		++(v->key_length);
+}
+
+/* Account for a run [i, run_end) of plain ASCII string content. */
+static inline void s_ascii_run(bnj_state* state, bnj_ctx* ctx, bnj_val* v,
+	const uint8_t* i, const uint8_t* const run_end)
+{
+	const unsigned run_len = run_end - i;
+	if(v->type & BNJ_VFLAG_KEY_FRAGMENT){
+		if(ctx->key_matcher){
+			const bnj_keymatcher* km = ctx->key_matcher;
+			uint32_t row = state->_key_set_sup;
+			const uint8_t* c = i;
+			while(c != run_end && row){
+				row = s_keymatcher_next(km, row, *c++);
+
+				/* Past the last branch only one key is left. Its remaining rows
+				 * are consecutive up to the row where it ends, so compare the
+				 * rest of the run with it at once. */
+				const uint32_t last = km->table[row * km->stride + km->stride - 2];
+				if(last){
+					const uint32_t rest = run_end - c;
+					const uint8_t* k = (const uint8_t*)km->key_set[
+						km->table[last * km->stride + km->stride - 1]]
+						+ state->_key_len + (c - i);
+					row = (rest <= last - row && s_keytail_eq(c, k, rest)) ? row + rest : 0;
+					break;
+				}
+			}
+			state->_key_set_sup = row;
+		}
+		/* Do enum check one char at a time until no key can match. */
+		else if(ctx->key_set){
+			while(i != run_end && (state->_key_set_sup != v->key_enum)){
+				s_match_key(state, ctx, *i);
+				++i;
+				++(state->_key_len);
+			}
+		}
+		state->_key_len += run_end - i;
+		v->key_length += run_len;
+	}
+
+	/* Increase both cp1 and character count. */
+	v->cp1_count += run_len;
+}
+
+/* Bytes escaped by a backslash. Escapes are rare, so walk them one by one.
+ * @param carry In: whether first byte is escaped. Out: same for next block. */
+static inline uint64_t s_escaped(uint64_t bslash, uint64_t* carry){
+	uint64_t escaped = *carry;
+	bslash &= ~escaped;
+	*carry = 0;
+	while(bslash){
+		const unsigned p = s_ctz64(bslash);
+		if(63 == p){
+			*carry = 1;
+			break;
+		}
+		escaped |= (uint64_t)2 << p;
+		bslash &= ~((uint64_t)3 << p);
+	}
+	return escaped;
+}
+
+/* Bit n of result is the parity of bits [0, n] of x. */
+static inline uint64_t s_prefix_xor(uint64_t x){
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
+
+/* Quote, backslash and bracket bitmaps of a 64 byte block, for skipping.
+ * Bit n describes byte n. */
+static inline void s_brackets64(const uint8_t* b, uint64_t* quote,
+	uint64_t* bslash, uint64_t* bracket)
+{
+#if defined(BNJ_AVX2) || defined(BNJ_SSE2)
+	uint64_t q = 0, bs = 0, br = 0;
+	unsigned k;
+	for(k = 0; k < 4; ++k){
+		const __m128i v = _mm_loadu_si128((const __m128i*)(b + 16 * k));
+		const __m128i v20 = _mm_or_si128(v, _mm_set1_epi8(0x20));
+		const unsigned shift = 16 * k;
+		q |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << shift;
+		bs |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << shift;
+		br |= (uint64_t)_mm_movemask_epi8(_mm_or_si128(
+			_mm_cmpeq_epi8(v20, _mm_set1_epi8('{')),
+			_mm_cmpeq_epi8(v20, _mm_set1_epi8('}')))) << shift;
+	}
+	*quote = q;
+	*bslash = bs;
+	*bracket = br;
+#else
+	unsigned k;
+	*quote = *bslash = *bracket = 0;
+	for(k = 0; k < 64; ++k){
+		const uint64_t bit = (uint64_t)1 << k;
+		switch(b[k]){
+			case '"':
+				*quote |= bit;
+				break;
+			case '\\':
+				*bslash |= bit;
+				break;
+			case '{':
+			case '}':
+			case '[':
+			case ']':
+				*bracket |= bit;
+				break;
+		}
+	}
+#endif
+}
+
+/* Enter a map or list while skipping.
+ * @return 0, or error code. */
+static inline uint32_t s_skip_open(bnj_state* state, uint8_t c){
+	if(state->depth == state->stack_length - 1)
+		return BNJ_ERR_STACK_OVERFLOW;
+	++state->depth_change;
+	++state->depth;
+	state->stack[state->depth] = ('{' == c) ? BNJ_OBJECT : BNJ_ARRAY;
+	return 0;
+}
+
+/* Leave a map or list while skipping; clears skip_depth when leaving the
+ * skipped one.
+ * @return 0, or error code. */
+static inline uint32_t s_skip_close(bnj_state* state, uint8_t c){
+	const char check = (state->stack[state->depth] & BNJ_OBJECT) ? '}' : ']';
+	if(c != check)
+		return BNJ_ERR_LISTMAP_MISMATCH;
+	--state->depth_change;
+	--state->depth;
+	if(state->depth < state->skip_depth)
+		state->skip_depth = 0;
+	return 0;
+}
+
+/* Skip over the value set up by bnj_skip, looking only at quotes,
+ * backslashes and brackets; whole 64 byte blocks at a time while possible.
+ * Clears skip_depth once past the value.
+ * @return First byte after the value, end, or the offending byte on error. */
+static const uint8_t* s_skip(bnj_state* state, const uint8_t* i,
+	const uint8_t* const end)
+{
+	uint32_t st = state->flags;
+	uint32_t err = 0;
+	while(i != end){
+		if(BNJ_SKIP_ESC == st){
+			++i;
+			st = BNJ_SKIP_STR;
+		}
+		else if(end - i >= 64){
+			uint64_t quote, bslash, bracket;
+			uint64_t esc = 0;
+			s_brackets64(i, &quote, &bslash, &bracket);
+
+			/* Mask out strings the same way bnj_index_build does. */
+			const uint64_t q = quote & ~s_escaped(bslash, &esc);
+			const uint64_t inside = s_prefix_xor(q)
+				^ ((BNJ_SKIP_STR == st) ? ~(uint64_t)0 : 0);
+
+			if(state->depth < state->skip_depth){
+				/* Only skipping a string; it ends at the first real quote. */
+				if(q){
+					state->skip_depth = 0;
+					state->flags = BNJ_SKIP;
+					return i + s_ctz64(q) + 1;
+				}
+			}
+			else{
+				uint64_t bits = bracket & ~inside;
+				while(bits){
+					const unsigned p = s_ctz64(bits);
+					err = ('}' == (i[p] | 0x20))
+						? s_skip_close(state, i[p]) : s_skip_open(state, i[p]);
+					if(err){
+						state->flags = err;
+						return i + p;
+					}
+					if(!state->skip_depth){
+						state->flags = BNJ_SKIP;
+						return i + p + 1;
+					}
+					bits &= bits - 1;
+				}
+			}
+
+			st = esc ? BNJ_SKIP_ESC : ((inside >> 63) ? BNJ_SKIP_STR : BNJ_SKIP);
+			i += 64;
+		}
+		else if(BNJ_SKIP_STR == st){
+			if('"' == *i){
+				st = BNJ_SKIP;
+				if(state->depth < state->skip_depth){
+					state->skip_depth = 0;
+					state->flags = st;
+					return i + 1;
+				}
+			}
+			else if('\\' == *i){
+				st = BNJ_SKIP_ESC;
+			}
+			++i;
+		}
+		else{
+			switch(*i){
+				case '"':
+					st = BNJ_SKIP_STR;
+					break;
+				case '{':
+				case '[':
+					err = s_skip_open(state, *i);
+					break;
+				case '}':
+				case ']':
+					err = s_skip_close(state, *i);
+					break;
+			}
+			if(err){
+				state->flags = err;
+				return i;
+			}
+			++i;
+			if(!state->skip_depth){
+				state->flags = st;
+				return i;
+			}
+		}
+	}
+	state->flags = st;
+	return i;
+}
+
+/* Length of numeric text from strval_offset to i, saturated to fit. */
+static inline BUFF_OFFSET s_numtext_len(const bnj_val* v, const uint8_t* buffer,
+	const uint8_t* i)
+{
+	const size_t len = (i - buffer) - v->strval_offset;
+	return (len < BUFF_OFFSET_MAX) ? len : BUFF_OFFSET_MAX;
+}
+
 bnj_state* bnj_state_init(bnj_state* ret, uint32_t* stack, uint32_t stack_length){
 	uint8_t* i = (uint8_t*) ret;
 	uint8_t* end = i + sizeof(bnj_state);
@@ -190,11 +957,16 @@ bnj_state* bnj_state_init(bnj_state* ret, uint32_t* stack, uint32_t stack_length
 	return ret;
 }
 
-const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
-	const uint8_t* buffer, uint32_t len)
+/* Parser body shared by bnj_parse and bnj_parse_padded.
+ * Inlined when possible so the pad tests fold away in bnj_parse.
+ * Block scans may read up to lim; if lim is past end, a 0 at end stops them. */
+static PARSE_INLINE const uint8_t* s_parse(
+	bnj_state* state, bnj_ctx* uctx, const uint8_t* buffer, uint32_t len,
+	uint32_t pad)
 {
 	const uint8_t* i = buffer;
 	const uint8_t * const end = buffer + len;
+	const uint8_t * const lim = end + pad;
 
 	/* The purpose of first_cp_frag is to track the placement of string fragments
 	 * with respect to the buffer. The buffer can have two possible fragments:
@@ -214,6 +986,10 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 	bnj_val* curval = state->v;
 	s_reset_state(state);
 
+	/* Keys are matched with kctx; a projection may supply them per depth. */
+	bnj_ctx level_ctx;
+	bnj_ctx* kctx = s_key_ctx(uctx, state->depth, &level_ctx);
+
 	/* PAF restore. Only restore exp_val if NOT a string type. */
 	curval->key_enum = state->_paf_key_enum;
 	curval->type = state->_paf_type;
@@ -222,6 +998,8 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 	curval->cp1_count = 0;
 	curval->cp2_count = 0;
 	curval->cp3_count = 0;
+	curval->num_length = 0;
+	curval->trunc_count = 0;
 
 	/* Copy significand value directly if code point fragment value is not
 	 * set to valid char. Otherwise copy fragmented char into it. */
@@ -231,13 +1009,58 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 	/* Offsets are always zeroed. */
 	curval->key_offset = 0;
 	curval->strval_offset = 0;
+	state->key_dropped = 0;
 
-	/* Initialize parsing state. */
-	while(i != end){
-		const unsigned st = state->flags;
-		const unsigned ctx = state->stack[state->depth];
+	/* A key begun with other keys to match matches nothing now. */
+	if((curval->type & BNJ_VFLAG_KEY_FRAGMENT)
+		&& state->_key_source != s_key_source(kctx))
+	{
+		curval->key_enum = kctx->key_set_length;
+		state->_key_set_sup = kctx->key_matcher ? 0 : kctx->key_set_length;
+		state->_key_source = s_key_source(kctx);
+	}
+
+#ifdef BNJ_THREADED_DISPATCH
+	static const void* const s_dispatch[BNJ_COUNT_STATES] = {
+		[0] = &&L_DEFAULT,
+		[BNJ_VALUE_START] = &&L_BNJ_VALUE_START,
+		[BNJ_INTERSTITIAL] = &&L_BNJ_INTERSTITIAL,
+		[BNJ_INTERSTITIAL2] = &&L_BNJ_INTERSTITIAL2,
+		[BNJ_INTERSTITIAL3] = &&L_BNJ_INTERSTITIAL3,
+		[BNJ_STRING_ST] = &&L_BNJ_STRING_ST,
+		[BNJ_SIGNIFICAND] = &&L_BNJ_SIGNIFICAND,
+		[BNJ_EXP_SIGN] = &&L_BNJ_EXP_SIGN,
+		[BNJ_EXPONENT] = &&L_BNJ_EXPONENT,
+		[BNJ_RESERVED] = &&L_BNJ_RESERVED,
+		[BNJ_VALUE_END] = &&L_DEFAULT,
+		[BNJ_STR_ESC] = &&L_BNJ_STR_ESC,
+		[BNJ_STR_U0] = &&L_BNJ_STR_U0,
+		[BNJ_STR_U1] = &&L_BNJ_STR_U1,
+		[BNJ_STR_U2] = &&L_BNJ_STR_U2,
+		[BNJ_STR_U3] = &&L_BNJ_STR_U3,
+		[BNJ_STR_SURROGATE] = &&L_BNJ_STR_SURROGATE,
+		[BNJ_STR_SURROGATE_1] = &&L_BNJ_STR_SURROGATE_1,
+		[BNJ_STR_SURROGATE_2] = &&L_BNJ_STR_SURROGATE_2,
+		[BNJ_STR_SURROGATE_3] = &&L_BNJ_STR_SURROGATE_3,
+		[BNJ_STR_UTF3] = &&L_BNJ_STR_UTF3,
+		[BNJ_STR_UTF2] = &&L_BNJ_STR_UTF2,
+		[BNJ_STR_UTF1] = &&L_BNJ_STR_UTF1,
+		[BNJ_END_VALUE] = &&L_BNJ_END_VALUE,
+		[BNJ_END_VALUE2] = &&L_BNJ_END_VALUE2,
+		[BNJ_COLON] = &&L_BNJ_COLON,
+		[BNJ_MINUS] = &&L_BNJ_MINUS,
+		[BNJ_OTHER_VALS] = &&L_BNJ_OTHER_VALS,
+		[BNJ_STRING_START] = &&L_BNJ_STRING_START,
+		[BNJ_SKIP] = &&L_BNJ_SKIP,
+		[BNJ_SKIP_STR] = &&L_BNJ_SKIP_STR,
+		[BNJ_SKIP_ESC] = &&L_BNJ_SKIP_ESC
+	};
+#endif
 
-		switch(st){
+	/* Initialize parsing state. The switch is only the entry point when
+	 * BNJ_THREADED_DISPATCH; states then jump to each other directly. */
+	while(i != end){
+		switch(state->flags){
 
 			/* INTERSTITIAL zone:
 			 * Notes about BNJ_INTERSTITIAL*:
@@ -247,16 +1070,24 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 			 *  if statement ordering:
 			 *  Assume that most JSON is compact, so test for ',' and ':' values first.
 			 *  */
-			case BNJ_INTERSTITIAL:
+			STATE_CASE(BNJ_INTERSTITIAL):
 				{
 					if(',' == *i){
-						if(!(ctx & BNJ_EXPECT_COMMA)){
+						if(!(state->stack[state->depth] & BNJ_EXPECT_COMMA)){
 							SETSTATE(state->flags, BNJ_ERR_EXTRA_COMMA);
 							return i;
 						}
 						state->stack[state->depth] &= ~BNJ_EXPECT_COMMA;
 						++i;
 
+						/* Count list elements for the projection. */
+						if(uctx->projection
+							&& !(state->stack[state->depth] & BNJ_OBJECT)
+							&& state->stack[state->depth] < BNJ_PROJ_INDEX_SUP)
+						{
+							state->stack[state->depth] += BNJ_PROJ_INDEX_ONE;
+						}
+
 						/* If values saved to state->v and negative depth change,
 						 * return those values to the user. */
 						if(state->depth_change < 0){
@@ -272,17 +1103,17 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 								/* Otherwise jump out of the function to return data. */
 								SETSTATE(state->flags, BNJ_INTERSTITIAL2);
 								return i;
-			case BNJ_INTERSTITIAL2:
+			STATE_CASE(BNJ_INTERSTITIAL2):
 								SETSTATE(state->flags, BNJ_INTERSTITIAL);
 							}
 						}
 
 						/*  */
 						state->stack[state->depth] |= BNJ_VAL_INCOMPLETE;
-						if(ctx & BNJ_OBJECT)
+						if(state->stack[state->depth] & BNJ_OBJECT)
 							state->stack[state->depth] |= BNJ_KEY_INCOMPLETE;
 
-						break;
+						GOTO_STATE(BNJ_INTERSTITIAL);
 					}
 					else if(s_lookup[*i] & CEND){
 						/* ensure list/map match against the stack! */
@@ -314,7 +1145,7 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 								/* Otherwise jump out of the function to return data. */
 								SETSTATE(state->flags, BNJ_INTERSTITIAL3);
 								return i;
-			case BNJ_INTERSTITIAL3:
+			STATE_CASE(BNJ_INTERSTITIAL3):
 								SETSTATE(state->flags, BNJ_INTERSTITIAL);
 							}
 						}
@@ -322,8 +1153,16 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						/* Now consume the character. */
 						++i;
 
+						/* Maps and lists entered without a depth change are left
+						 * without one too. */
+						const unsigned silent =
+							state->drop_depth && state->depth >= state->drop_depth;
+						if(state->depth == state->drop_depth)
+							state->drop_depth = 0;
+
 						/* Decrement depth. */
-						--state->depth_change;
+						if(!silent)
+							--state->depth_change;
 						--state->depth;
 
 						/* Terminate on reaching 0 depth.*/
@@ -342,11 +1181,11 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						/* Complete value. */
 						state->stack[state->depth] &= ~BNJ_VAL_INCOMPLETE;
 
-						break;
+						GOTO_STATE(BNJ_INTERSTITIAL);
 					}
 					else if(s_lookup[*i] & CWHI){
-						++i;
-						break;
+						i = s_skip_ws(i + 1, lim);
+						GOTO_STATE(BNJ_INTERSTITIAL);
 					}
 
 					/* FALLTHROUGH to value start. */
@@ -361,7 +1200,95 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 				}
 
 				/* Value Type Resolution zone. */
-			case BNJ_VALUE_START:
+			STATE_CASE(BNJ_VALUE_START):
+
+				/* Pass over values the projection leaves out. */
+				if(uctx->projection && state->depth
+					&& !(state->stack[state->depth] & BNJ_KEY_INCOMPLETE)
+					&& !(s_lookup[*i] & CWHI))
+				{
+					/* Everything inside a value left out is left out. */
+					const unsigned out =
+						((state->drop_depth && state->depth >= state->drop_depth)
+							|| (state->stack[state->depth] & BNJ_PROJ_REST))
+						? 1 : s_proj_out(state, uctx->projection, curval);
+
+					/* A key continued from the last call has a 0 offset. */
+					if(out && curval == state->v && !curval->key_offset
+						&& (curval->type & BNJ_VFLAG_MIDDLE))
+					{
+						state->key_dropped = 1;
+					}
+
+					/* A skipped value must not leave its key looking incomplete. */
+					if(out && ('"' == *i || 2 == out || (s_lookup[*i] & CBEG)))
+						curval->type = 0;
+
+					/* Parse the rest of this list without reporting it. */
+					if(2 == out && !uctx->projection->structural)
+						state->stack[state->depth] |= BNJ_PROJ_REST;
+
+					if(2 == out && uctx->projection->structural){
+						/* Alert user to entering the list before skipping to its
+						 * end; otherwise its close cancels the entry. */
+						if(state->depth_change > 0){
+							if(uctx->user_cb){
+								if(uctx->user_cb(state, uctx, buffer)){
+									SETSTATE(state->flags, BNJ_ERR_USER);
+									return i;
+								}
+								s_reset_state(state);
+								curval = state->v;
+							}
+							else{
+								SETSTATE(state->flags, BNJ_VALUE_START);
+								return i;
+							}
+						}
+
+						/* Nothing more of this list; skip to its end. */
+						bnj_skip(state, state->depth);
+						GOTO_STATE(BNJ_SKIP);
+					}
+					else if(out && !uctx->projection->structural){
+						/* Parse the value without reporting it. Maps and lists are
+						 * entered without a depth change; see drop_depth. */
+						if(s_lookup[*i] & CBEG){
+							if(!state->drop_depth)
+								state->drop_depth = state->depth + 1;
+						}
+						else{
+							state->stack[state->depth] |= BNJ_PROJ_DROP;
+						}
+					}
+					else if(out){
+						if('"' == *i){
+							++i;
+							state->skip_depth = state->depth + 1;
+							SETSTATE(state->flags, BNJ_SKIP_STR);
+							GOTO_STATE(BNJ_SKIP_STR);
+						}
+						else if(s_lookup[*i] & CBEG){
+							if(state->depth == state->stack_length - 1){
+								SETSTATE(state->flags, BNJ_ERR_STACK_OVERFLOW);
+								return i;
+							}
+
+							/* Enter without a depth change; none is reported. */
+							state->stack[state->depth] |= BNJ_PROJ_SKIP;
+							++state->depth;
+							state->stack[state->depth] =
+								('[' == *i) ? BNJ_ARRAY : BNJ_OBJECT;
+							++i;
+							state->skip_depth = state->depth;
+							SETSTATE(state->flags, BNJ_SKIP);
+							GOTO_STATE(BNJ_SKIP);
+						}
+
+						/* Validate number or literal, but do not emit it. */
+						state->stack[state->depth] |= BNJ_PROJ_DROP;
+					}
+				}
 
 				/* First check for start of string. */
 				if('"' == *i){
@@ -382,7 +1309,7 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						}
 					}
 
-			case BNJ_STRING_START:
+			STATE_CASE(BNJ_STRING_START):
 					SETSTATE(state->flags, BNJ_STRING_ST);
 					++i;
 
@@ -392,8 +1319,11 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						curval->key_enum = 0;
 						curval->key_length = 0;
 						curval->key_offset = i - buffer;
-						state->_key_set_sup = uctx->key_set_length;
+						kctx = s_key_ctx(uctx, state->depth, &level_ctx);
+						state->_key_set_sup =
+							kctx->key_matcher ? 1 : kctx->key_set_length;
 						state->_key_len = 0;
+						state->_key_source = s_key_source(kctx);
 					}
 					else {
 						/* Otherwise this is a string value. */
@@ -410,12 +1340,12 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						/* "empty" char value is high bit set. */
 						curval->significand_val = BNJ_EMPTY_CP;
 					}
-					break;
+					GOTO_STATE(BNJ_STRING_ST);
 				}
 				else if(s_lookup[*i] & CWHI){
 					/* Skip over whitespace. */
-					++i;
-					break;
+					i = s_skip_ws(i + 1, lim);
+					GOTO_STATE(BNJ_VALUE_START);
 				}
 				else if(state->stack[state->depth] & BNJ_KEY_INCOMPLETE){
 					/* No other character may follow a '{' */
@@ -436,24 +1366,18 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 
 					assert(state->depth_change >= 0);
 
-					/* Increment depth. */
-					++state->depth_change;
+					/* Increment depth. Nothing left out is reported. */
 					++state->depth;
+					const unsigned silent =
+						state->drop_depth && state->depth >= state->drop_depth;
+					if(!silent)
+						++state->depth_change;
 
 					/* If this is an object, initialize with incomplete key read. */
 					state->stack[state->depth] = type;
 					if(BNJ_OBJECT == type)
 						state->stack[state->depth] |= BNJ_KEY_INCOMPLETE;
 
-					/* If currently parsing map, then add this to value list. */
-					if(state->stack[state->depth - 1] & 1){
-						curval->type = (BNJ_OBJECT == type) ? BNJ_OBJ_BEGIN : BNJ_ARR_BEGIN;
-						++state->vi;
-						curval = state->v + state->vi;
-						curval->key_length = 0;
-						state->_key_len = 0;
-					}
-					curval->type = 0;
 					state->_paf_type = 0;
 					state->_paf_key_enum = 0;
 
@@ -462,19 +1386,43 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						state->stack[state->depth - 1] |= BNJ_EXPECT_COMMA;
 
 					SETSTATE(state->flags, BNJ_INTERSTITIAL);
-					break;
-				}
-				else{
-					SETSTATE(state->flags, BNJ_MINUS);
-				}
 
-				/* Alert user to depth change before reporting values.*/
-				if(state->depth_change){
-					if(uctx->user_cb){
-						if(uctx->user_cb(state, uctx, buffer)){
-							SETSTATE(state->flags, BNJ_ERR_USER);
-							return i;
-						}
+					/* If currently parsing map, then add this to value list. */
+					if(!silent && (state->stack[state->depth - 1] & 1)){
+						curval->type = (BNJ_OBJECT == type) ? BNJ_OBJ_BEGIN : BNJ_ARR_BEGIN;
+						++state->vi;
+						state->_key_len = 0;
+
+						/* If v is full, report now rather than at the next value. */
+						if(state->vi == state->vlen){
+							if(uctx->user_cb){
+								if(uctx->user_cb(state, uctx, buffer)){
+									SETSTATE(state->flags, BNJ_ERR_USER);
+									return i;
+								}
+								s_reset_state(state);
+							}
+							else{
+								return i;
+							}
+						}
+						curval = state->v + state->vi;
+						curval->key_length = 0;
+					}
+					curval->type = 0;
+					GOTO_STATE(BNJ_INTERSTITIAL);
+				}
+				else{
+					SETSTATE(state->flags, BNJ_MINUS);
+				}
+
+				/* Alert user to depth change before reporting values.*/
+				if(state->depth_change){
+					if(uctx->user_cb){
+						if(uctx->user_cb(state, uctx, buffer)){
+							SETSTATE(state->flags, BNJ_ERR_USER);
+							return i;
+						}
 						s_reset_state(state);
 						curval = state->v;
 					}
@@ -484,17 +1432,19 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 					}
 				}
 
-			case BNJ_MINUS:
+			STATE_CASE(BNJ_MINUS):
 				if('-' == *i){
 					curval->type |= BNJ_VFLAG_VAL_FRAGMENT | BNJ_VFLAG_NEGATIVE_SIGNIFICAND;
 					++i;
 					if(i == end){
+						/* Number text begins in the next buffer. */
+						curval->strval_offset = i - buffer;
 						SETSTATE(state->flags, BNJ_OTHER_VALS);
 						break;
 					}
 				}
 
-			case BNJ_OTHER_VALS:
+			STATE_CASE(BNJ_OTHER_VALS):
 				/* Record beginning of data value here. */
 				curval->strval_offset = i - buffer;
 
@@ -543,32 +1493,63 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						curval->type |= BNJ_VFLAG_VAL_FRAGMENT | BNJ_NUMERIC;
 						curval->type &= ~BNJ_VFLAG_MIDDLE;
 						state->digit_count = 0;
+						state->trunc_count = 0;
 						state->_decimal_offset = -1;
 				}
-				break;
+				NEXT_STATE();
 
 			/* Significand section. */
-			case BNJ_SIGNIFICAND:
+			STATE_CASE(BNJ_SIGNIFICAND):
 				if(*i >= '0' && *i <= '9'){
-					/* state->sig = 8 * state->sig + (2 * state->sig + digit) */
+#ifdef BNJ_SWAR
+					/* Fold in up to 8 digits at a time while they cannot overflow. */
+					if(lim - i >= 8 && curval->significand_val < SWAR_DIGITS_SUP){
+						const uint8_t* const start = i;
+						do{
+							uint64_t x;
+							memcpy(&x, i, 8);
+							const uint64_t nd = s_swar_nondigits(x);
+							if(!nd){
+								curval->significand_val = curval->significand_val * 100000000
+									+ s_swar_value(x);
+								i += 8;
+								continue;
+							}
 
-					/* compute major addend */
-					SIGNIFICAND tmp = curval->significand_val << 1;
-					tmp += *i - '0';
-					SIGNIFICAND tmp2 = curval->significand_val << 3;
-					++i;
+							/* Shift the leading digits up, padding with '0' in front. */
+							const unsigned n = __builtin_ctzll(nd) >> 3;
+							if(n){
+								x = (x << (64 - 8 * n)) | (0x3030303030303030ULL >> (8 * n));
+								curval->significand_val = curval->significand_val * s_pow10[n]
+									+ s_swar_value(x);
+								i += n;
+							}
+							break;
+						} while(lim - i >= 8 && curval->significand_val < SWAR_DIGITS_SUP);
 
-					/* Addition overflow check. */
-					if(SIGNIFICAND_MAX - tmp > tmp2){
-						curval->significand_val = tmp + tmp2;
+						state->digit_count += i - start;
+						GOTO_STATE(BNJ_SIGNIFICAND);
+					}
+#endif
+
+					/* state->sig = 10 * state->sig + digit, unless the result would
+					 * reach SIGNIFICAND_MAX. Once a digit does not fit, drop it and
+					 * all that follow; the exponent accounts for them at the end. */
+					const unsigned digit = *i - '0';
+					const SIGNIFICAND sig = curval->significand_val;
+					++i;
+					if(!state->trunc_count && (sig < SIGNIFICAND_MAX / 10
+						|| (sig == SIGNIFICAND_MAX / 10 && digit < SIGNIFICAND_MAX % 10)))
+					{
+						curval->significand_val = sig * 10 + digit;
 					}
 					else{
-						/* FIXME: Some kind of support for bignumbers. */
+						++state->trunc_count;
 					}
 
 					/* Increment digit count. */
 					++state->digit_count;
-					break;
+					GOTO_STATE(BNJ_SIGNIFICAND);
 				}
 
 				/* Make sure at least one digit read by now. */
@@ -607,19 +1588,23 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 					++i;
 				}
 				else {
-					/* Assume end of integer. Modify exponent with decimal point. */
+					/* Assume end of integer. Modify exponent with decimal point
+					 * and truncated digits. */
 					if(-1 != state->_decimal_offset)
 						curval->exp_val = -(state->digit_count - state->_decimal_offset);
+					curval->exp_val += state->trunc_count;
+					curval->trunc_count = state->trunc_count;
+					curval->num_length = s_numtext_len(curval, buffer, i);
 
 					/* Clear PAF significand and exp_val since final value settled. */
 					state->_paf_exp_val = 0;
 					state->_paf_significand_val = 0;
 					SETSTATE(state->flags,  BNJ_END_VALUE);
 				}
-				break;
+				NEXT_STATE();
 			/* End significand section. */
 
-			case BNJ_EXP_SIGN:
+			STATE_CASE(BNJ_EXP_SIGN):
 				if('-' == *i){
 					/* Record negative exponent. */
 					curval->type |= BNJ_VFLAG_NEGATIVE_EXPONENT;
@@ -631,9 +1616,9 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 				}
 
 				SETSTATE(state->flags, BNJ_EXPONENT);
-				break;
+				GOTO_STATE(BNJ_EXPONENT);
 
-			case BNJ_EXPONENT:
+			STATE_CASE(BNJ_EXPONENT):
 				if(*i >= '0' && *i <= '9'){
 					/* Add to exponent value. */
 					curval->exp_val *= 10;
@@ -644,7 +1629,7 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 					}
 					++i;
 					++state->_key_set_sup;
-					break;
+					GOTO_STATE(BNJ_EXPONENT);
 				}
 
 				/* Must have at least one exponent digit. */
@@ -664,18 +1649,31 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 				if(-1 == state->_decimal_offset)
 					state->_decimal_offset = state->digit_count;
 				curval->exp_val -= state->digit_count - state->_decimal_offset;
+				curval->exp_val += state->trunc_count;
+				curval->trunc_count = state->trunc_count;
+				curval->num_length = s_numtext_len(curval, buffer, i);
 				SETSTATE(state->flags,  BNJ_END_VALUE);
-				break;
+				GOTO_STATE(BNJ_END_VALUE);
 
 
 			/* String section. */
-			case BNJ_STRING_ST:
+			STATE_CASE(BNJ_STRING_ST):
 				{
 					if(s_lookup[*i] & CINV){
 						SETSTATE(state->flags, BNJ_ERR_INVALID);
 						return i;
 					}
 					else if(*i & 0x80){
+						/* Validate and count whole characters at once when possible.
+						 * Keys still go byte by byte for key matching. */
+						if(!(curval->type & BNJ_VFLAG_KEY_FRAGMENT)){
+							const uint8_t* run_end = s_scan_utf8(i, lim, curval);
+							if(run_end != i){
+								i = run_end;
+								GOTO_STATE(BNJ_STRING_ST);
+							}
+						}
+
 						/* Process first byte. */
 						state->_cp_fragment = *i;
 						if((*i & 0xF8) == 0xF0){
@@ -707,15 +1705,15 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 							return i;
 						}
 
-						/* Advance. If at end, return and switch back to
-						 * appropriate parse point. */
+						s_key_byte(state, kctx, curval, *i);
+
+						/* Advance. If at end, the fragment is saved and parsing
+						 * resumes at the appropriate parse point. */
 						++i;
-						if(i == end)
-							return i;
-						break;
+						NEXT_STATE();
 
 						/* Process third to last byte. */
-			case BNJ_STR_UTF3:
+			STATE_CASE(BNJ_STR_UTF3):
 						if((*i & 0xC0) != 0x80){
 							SETSTATE(state->flags, BNJ_ERR_UTF_8);
 							return i;
@@ -727,34 +1725,37 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						 * ignore this char (by advancing offset) when copied later. */
 						state->_cp_fragment <<= 6;
 						state->_cp_fragment |= *i & 0x3F;
+						s_key_byte(state, kctx, curval, *i);
 						++i;
 						if(i == end){
 							SETSTATE(state->flags, BNJ_STR_UTF2);
-							return i;
+							break;
 						}
 
 						/* Process penultimate byte. */
-			case BNJ_STR_UTF2:
+			STATE_CASE(BNJ_STR_UTF2):
 						if((*i & 0xC0) != 0x80){
 							SETSTATE(state->flags, BNJ_ERR_UTF_8);
 							return i;
 						}
 						state->_cp_fragment <<= 6;
 						state->_cp_fragment |= *i & 0x3F;
+						s_key_byte(state, kctx, curval, *i);
 						++i;
 						if(i == end){
 							SETSTATE(state->flags, BNJ_STR_UTF1);
-							return i;
+							break;
 						}
 
 						/* Process last byte. */
-			case BNJ_STR_UTF1:
+			STATE_CASE(BNJ_STR_UTF1):
 						if((*i & 0xC0) != 0x80){
 							SETSTATE(state->flags, BNJ_ERR_UTF_8);
 							return i;
 						}
 						state->_cp_fragment <<= 6;
 						state->_cp_fragment |= *i & 0x3F;
+						s_key_byte(state, kctx, curval, *i);
 
 						/* Check for overlong encodings. */
 						switch(state->_cp_fragment >> 29){
@@ -764,6 +1765,11 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 									SETSTATE(state->flags, BNJ_ERR_UTF_8_OVERLONG);
 									return i;
 								}
+								/* Beyond the last Unicode code point. */
+								if((state->_cp_fragment & 0xFFFFFF) > 0x10FFFF){
+									SETSTATE(state->flags, BNJ_ERR_UTF_8);
+									return i;
+								}
 								break;
 
 							/* 3 byte encoding. */
@@ -808,7 +1814,7 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						if(first_cp_frag != BNJ_EMPTY_CP){
 							curval->strval_offset = i - buffer + 1;
 							curval->significand_val = state->_cp_fragment;
-							first_cp_frag = 0;
+							first_cp_frag = BNJ_EMPTY_CP;
 						}
 
 						/* Reset the fragment value. */
@@ -827,8 +1833,18 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 							curval->type &= ~BNJ_VFLAG_KEY_FRAGMENT;
 							curval->type |= BNJ_VFLAG_MIDDLE;
 							state->stack[state->depth] &= ~BNJ_KEY_INCOMPLETE;
-							if(state->_key_set_sup == curval->key_enum)
-								curval->key_enum = uctx->key_set_length;
+							if(kctx->key_matcher){
+								const bnj_keymatcher* km = kctx->key_matcher;
+								curval->key_enum = km->table[
+									state->_key_set_sup * km->stride + km->stride - 1];
+							}
+							/* The least candidate matches only if it ends here;
+							 * otherwise the key is merely a prefix of it. */
+							else if(state->_key_set_sup == curval->key_enum
+								|| kctx->key_set[curval->key_enum][state->_key_len])
+							{
+								curval->key_enum = kctx->key_set_length;
+							}
 
 							/* Preemptive reset. */
 							state->_key_len = 0;
@@ -842,6 +1858,9 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 					else if(*i == '\\'){
 						/* Escape sequence, initialize fragment to 0. */
 						state->_cp_fragment = 0;
+						if(curval->type & BNJ_VFLAG_VAL_FRAGMENT)
+							curval->type |= BNJ_VFLAG_ESCAPED;
+						s_key_esc(curval);
 						++i;
 						if(i == end){
 							SETSTATE(state->flags, BNJ_STR_ESC);
@@ -849,7 +1868,7 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						}
 
 
-			case BNJ_STR_ESC:
+			STATE_CASE(BNJ_STR_ESC):
 						if('u' == *i){
 
 							/* Starting new UTF-16 code point, so reset cp frag.
@@ -859,40 +1878,43 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 								SETSTATE(state->flags, BNJ_STR_U0);
 							}
 							else{
-			case BNJ_STR_SURROGATE:
+			STATE_CASE(BNJ_STR_SURROGATE):
 								if(*i != '\\'){
 									SETSTATE(state->flags, BNJ_ERR_UTF_SURROGATE);
 									return i;
 								}
+								s_key_esc(curval);
 								++i;
 								if(i == end){
 									SETSTATE(state->flags, BNJ_STR_SURROGATE_1);
-									return i;
+									break;
 								}
 
-			case BNJ_STR_SURROGATE_1:
+			STATE_CASE(BNJ_STR_SURROGATE_1):
 								if(*i != 'u'){
 									SETSTATE(state->flags, BNJ_ERR_UTF_SURROGATE);
 									return i;
 								}
+								s_key_esc(curval);
 								++i;
 								if(i == end){
 									SETSTATE(state->flags, BNJ_STR_SURROGATE_2);
-									return i;
+									break;
 								}
 
-			case BNJ_STR_SURROGATE_2:
+			STATE_CASE(BNJ_STR_SURROGATE_2):
 								if(s_hex(*i) != 0xD){
 									SETSTATE(state->flags, BNJ_ERR_UTF_SURROGATE);
 									return i;
 								}
+								s_key_esc(curval);
 								++i;
 								if(i == end){
 									SETSTATE(state->flags, BNJ_STR_SURROGATE_3);
-									return i;
+									break;
 								}
 
-			case BNJ_STR_SURROGATE_3:
+			STATE_CASE(BNJ_STR_SURROGATE_3):
 								if(s_hex(*i) < 0xC){
 									SETSTATE(state->flags, BNJ_ERR_UTF_SURROGATE);
 									return i;
@@ -906,12 +1928,13 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 								state->_cp_fragment += 0x100;
 								SETSTATE(state->flags, BNJ_STR_U2);
 							}
+							s_key_esc(curval);
 							++i;
 
-			case BNJ_STR_U0:
-			case BNJ_STR_U1:
-			case BNJ_STR_U2:
-			case BNJ_STR_U3:
+			STATE_CASE(BNJ_STR_U0):
+			STATE_CASE(BNJ_STR_U1):
+			STATE_CASE(BNJ_STR_U2):
+			STATE_CASE(BNJ_STR_U3):
 							while(i != end){
 								if(!(s_lookup[*i] & CHEX)){
 									state->flags = BNJ_ERR_INV_HEXESC;
@@ -920,6 +1943,7 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 
 								state->_cp_fragment <<= 4;
 								state->_cp_fragment |= s_hex(*i);
+								s_key_esc(curval);
 								++i;
 
 								if(BNJ_STR_U3 != state->flags){
@@ -948,10 +1972,12 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 										/* If at beginning of parse _cp_fragment was not BNJ_EMPTY_CP,
 										 * copy the completed _cp_fragment to significand_val. */
 										if(first_cp_frag != BNJ_EMPTY_CP){
-											curval->strval_offset = i - buffer + 1;
+											/* i is already past the last hex digit. */
+											curval->strval_offset = i - buffer;
 											curval->significand_val = state->_cp_fragment;
-											first_cp_frag = 0;
+											first_cp_frag = BNJ_EMPTY_CP;
 										}
+										s_key_cp(state, kctx, curval, state->_cp_fragment);
 
 										/* Reset the fragment value. */
 										state->_cp_fragment = BNJ_EMPTY_CP;
@@ -979,39 +2005,35 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 								return i;
 							}
 
+							/* Unescaped character. */
+							uint8_t c;
+							switch(*i){
+								case 'b':
+									c = '\b';
+									break;
+								case 'f':
+									c = '\f';
+									break;
+								case 'n':
+									c = '\n';
+									break;
+								case 'r':
+									c = '\r';
+									break;
+								case 't':
+									c = '\t';
+									break;
+								default:
+									/* '"', '\\' and '/' stand for themselves. */
+									c = *i;
+							}
+
 							/* If at beginning of parse _cp_fragment was not BNJ_EMPTY_CP,
 							 * copy the completed _cp_fragment to significand_val. */
 							if(first_cp_frag != BNJ_EMPTY_CP){
-								switch(*i){
-									case '"':
-										curval->significand_val = '"';
-										break;
-									case '\\':
-										curval->significand_val = '\\';
-										break;
-									case '/':
-										curval->significand_val = '/';
-										break;
-									case 'b':
-										curval->significand_val = '\b';
-										break;
-									case 'f':
-										curval->significand_val = '\f';
-										break;
-									case 'n':
-										curval->significand_val = '\n';
-										break;
-									case 'r':
-										curval->significand_val = '\r';
-										break;
-									case 't':
-										curval->significand_val = '\t';
-										break;
-									default:
-										assert(0);
-								}
+								curval->significand_val = c;
 								curval->strval_offset = i - buffer + 1;
-								first_cp_frag = 0;
+								first_cp_frag = BNJ_EMPTY_CP;
 							}
 
 							/* Reset the fragment value. */
@@ -1019,32 +2041,25 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 
 							/* Increase cp1 count. */
 							++(curval->cp1_count);
+							s_key_esc(curval);
+							s_key_match(state, kctx, curval, c);
 							SETSTATE(state->flags, BNJ_STRING_ST);
 						}
 					}
 					else{
-						/* Normal character, just increment proper length. */
-						if(curval->type & BNJ_VFLAG_KEY_FRAGMENT){
-							/* Do enum check. */
-							if(uctx->key_set
-									&& (state->_key_set_sup != curval->key_enum))
-							{
-								s_match_key(state, uctx, *i);
-							}
-							++(curval->key_length);
-							++(state->_key_len);
-						}
-
-						/* Increase both cp1 and character count. */
-						++(curval->cp1_count);
+						/* Normal character. Consume the whole run of them at once. */
+						const uint8_t* run_end = s_scan_ascii(i + 1, lim);
+						s_ascii_run(state, kctx, curval, i, run_end);
+						i = run_end;
+						GOTO_STATE(BNJ_STRING_ST);
 					}
 
 					/* Character accepted, increment i. */
 					++i;
 				}
-				break;
+				NEXT_STATE();
 
-			case BNJ_RESERVED:
+			STATE_CASE(BNJ_RESERVED):
 				{
 					/* Attempt to compare rest of string. */
 					const char* rest =
@@ -1067,9 +2082,9 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 						curval->exp_val = rest - s_reserved_arr[curval->significand_val];
 					}
 				}
-				break;
+				NEXT_STATE();
 
-			case BNJ_END_VALUE:
+			STATE_CASE(BNJ_END_VALUE):
 				{
 					/* Should NEVER encounter key fragment here. */
 					assert(!(state->v[state->vi].type & BNJ_VFLAG_KEY_FRAGMENT));;
@@ -1078,25 +2093,31 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 					state->v[state->vi].type &= ~BNJ_VFLAG_VAL_FRAGMENT;
 					state->stack[state->depth] &= ~BNJ_VAL_INCOMPLETE;
 
-					/* Call user cb. */
-					++state->vi;
-					if(state->vi == state->vlen){
-						if(uctx->user_cb){
-							if(uctx->user_cb(state, uctx, buffer)){
-								SETSTATE(state->flags, BNJ_ERR_USER);
+					if(state->stack[state->depth] & BNJ_PROJ_DROP){
+						/* Left out by the projection; reuse the slot. */
+						state->stack[state->depth] &= ~BNJ_PROJ_DROP;
+					}
+					else{
+						/* Call user cb. */
+						++state->vi;
+						if(state->vi == state->vlen){
+							if(uctx->user_cb){
+								if(uctx->user_cb(state, uctx, buffer)){
+									SETSTATE(state->flags, BNJ_ERR_USER);
+									return i;
+								}
+								s_reset_state(state);
+							}
+							else{
+								SETSTATE(state->flags, (0 == state->depth) ? BNJ_SUCCESS : BNJ_END_VALUE2);
 								return i;
 							}
-							s_reset_state(state);
-						}
-						else{
-							SETSTATE(state->flags, (0 == state->depth) ? BNJ_SUCCESS : BNJ_END_VALUE2);
-							return i;
 						}
+						curval = state->v + state->vi;
 					}
-					curval = state->v + state->vi;
 					curval->key_length = 0;
 
-			case BNJ_END_VALUE2:
+			STATE_CASE(BNJ_END_VALUE2):
 					curval->type = 0;
 					state->_paf_type = 0;
 					state->_paf_key_enum = 0;
@@ -1113,36 +2134,91 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 					/* Otherwise nonempty. */
 					SETSTATE(state->flags , BNJ_INTERSTITIAL);
 				}
-				break;
+				GOTO_STATE(BNJ_INTERSTITIAL);
 
 
-			case BNJ_COLON:
+			STATE_CASE(BNJ_COLON):
 				if(':' == *i){
 					SETSTATE(state->flags, BNJ_INTERSTITIAL);
 					++i;
 				}
 				else if(s_lookup[*i] & CWHI){
-					++i;
+					i = s_skip_ws(i + 1, lim);
 				}
 				else{
 					SETSTATE(state->flags, BNJ_ERR_MISSING_COLON);
 					return i;
 				}
-				break;
+				NEXT_STATE();
+
+			/* Skipping a value for bnj_skip. */
+			STATE_CASE(BNJ_SKIP):
+			STATE_CASE(BNJ_SKIP_STR):
+			STATE_CASE(BNJ_SKIP_ESC):
+				if(state->skip_depth && !(state->flags & BNJ_ERROR_MASK))
+					i = s_skip(state, i, end);
+				if(state->flags & BNJ_ERROR_MASK)
+					return i;
 
-			default:
+				/* Otherwise ran out of buffer. */
+				if(state->skip_depth)
+					NEXT_STATE();
+
+				/* Past the skipped value; nothing of it is reported. */
+				curval->type = 0;
+				state->_paf_type = 0;
+				state->_paf_key_enum = 0;
+
+				/* Leaving a map or list the projection skipped was never
+				 * reported either. */
+				if(state->stack[state->depth] & BNJ_PROJ_SKIP){
+					state->stack[state->depth] &= ~BNJ_PROJ_SKIP;
+					++state->depth_change;
+				}
+
+				/* Terminate on reaching 0 depth.*/
+				if(0 == state->depth){
+					SETSTATE(state->flags, BNJ_SUCCESS);
+					if(uctx->user_cb){
+						if(uctx->user_cb(state, uctx, buffer)){
+							SETSTATE(state->flags, BNJ_ERR_USER);
+							return i;
+						}
+						s_reset_state(state);
+					}
+					return i;
+				}
+
+				/* Complete value. */
+				state->stack[state->depth] &= ~BNJ_VAL_INCOMPLETE;
+				state->stack[state->depth] |= BNJ_EXPECT_COMMA;
+				SETSTATE(state->flags, BNJ_INTERSTITIAL);
+				GOTO_STATE(BNJ_INTERSTITIAL);
+
+			DEFAULT_CASE:
 				return i;
 
 			/* end switch */
 		}
 		/* end while */
 	}
+#ifdef BNJ_THREADED_DISPATCH
+parse_end:
+#endif
 
 	/* The only way to reach the end of the while loop is to run out of
 	 * chars in the buffer! */
 
-	/* Ensure user sees fragment. */
-	if(bnj_incomplete(state, curval)){
+	/* Ensure user sees fragment, unless the projection left it out. */
+	const uint32_t dropped = state->depth
+		&& ((state->stack[state->depth] & BNJ_PROJ_DROP)
+			|| (state->drop_depth && state->depth >= state->drop_depth));
+	if(bnj_incomplete(state, curval) && !dropped){
+		if(BNJ_NUMERIC == bnj_val_type(curval)
+			&& (curval->type & BNJ_VFLAG_VAL_FRAGMENT))
+		{
+			curval->num_length = s_numtext_len(curval, buffer, i);
+		}
 		++state->vi;
 	}
 
@@ -1162,7 +2238,16 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 		state->_paf_significand_val = curval->significand_val;
 	}
 	else{
-		state->_paf_type = 0;
+		if(dropped){
+			/* Left out value still parses on. */
+			state->_paf_key_enum = curval->key_enum;
+			state->_paf_type = curval->type;
+			state->_paf_exp_val = curval->exp_val;
+			state->_paf_significand_val = curval->significand_val;
+		}
+		else{
+			state->_paf_type = 0;
+		}
 
 		if(state->depth_change){
 			if(uctx->user_cb){
@@ -1176,26 +2261,422 @@ const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
 	return i;
 }
 
+const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* uctx,
+	const uint8_t* buffer, uint32_t len)
+{
+	const uint8_t* ret = s_parse(state, uctx, buffer, len, 0);
+	state->parsed += ret - buffer;
+	return ret;
+}
+
+const uint8_t* bnj_parse_padded(bnj_state* state, bnj_ctx* uctx,
+	const uint8_t* buffer, uint32_t len)
+{
+	assert(0 == buffer[len]);
+	const uint8_t* ret = s_parse(state, uctx, buffer, len, BNJ_PADDING);
+	state->parsed += ret - buffer;
+	return ret;
+}
+
+void bnj_skip(bnj_state* state, uint32_t depth){
+	uint32_t st, d;
+
+	/* Nothing to skip, or already skipping at least as much. */
+	if(!depth || depth > state->depth + 1
+		|| (state->flags & (BNJ_ERROR_MASK | BNJ_SUCCESS))
+		|| (state->skip_depth && state->skip_depth <= depth))
+	{
+		return;
+	}
+
+	/* Resume skipping from wherever the parser stopped. */
+	switch(state->flags){
+		case BNJ_STR_ESC:
+		case BNJ_STR_SURROGATE_1:
+			st = BNJ_SKIP_ESC;
+			break;
+
+		case BNJ_STRING_ST:
+		case BNJ_STR_U0:
+		case BNJ_STR_U1:
+		case BNJ_STR_U2:
+		case BNJ_STR_U3:
+		case BNJ_STR_SURROGATE:
+		case BNJ_STR_SURROGATE_2:
+		case BNJ_STR_SURROGATE_3:
+		case BNJ_STR_UTF3:
+		case BNJ_STR_UTF2:
+		case BNJ_STR_UTF1:
+			st = BNJ_SKIP_STR;
+			break;
+
+		case BNJ_SKIP:
+		case BNJ_SKIP_STR:
+		case BNJ_SKIP_ESC:
+			st = state->flags;
+			break;
+
+		default:
+			st = BNJ_SKIP;
+	}
+
+	/* One past the current depth, only a string value being parsed. */
+	if(depth == state->depth + 1
+		&& (BNJ_SKIP == st || (state->_paf_type & BNJ_VFLAG_KEY_FRAGMENT)))
+	{
+		return;
+	}
+
+	/* Maps and lists the projection left out were entered without a depth
+	 * change, so are left without one. */
+	for(d = depth; d <= state->depth; ++d){
+		if((state->drop_depth && d >= state->drop_depth)
+			|| (state->stack[d - 1] & BNJ_PROJ_SKIP))
+		{
+			++state->depth_change;
+			state->stack[d - 1] &= ~BNJ_PROJ_SKIP;
+		}
+	}
+	if(state->drop_depth >= depth)
+		state->drop_depth = 0;
+
+	SETSTATE(state->flags, st);
+	state->skip_depth = depth;
+	state->_paf_type = 0;
+	state->_paf_key_enum = 0;
+	state->_cp_fragment = BNJ_EMPTY_CP;
+}
+
+/* Character class bitmaps of a 64 byte block. Bit n describes byte n. */
+static inline void s_classify64(const uint8_t* b, uint64_t* quote,
+	uint64_t* bslash, uint64_t* ws, uint64_t* op, uint64_t* special)
+{
+#if defined(BNJ_AVX2) || defined(BNJ_SSE2)
+	uint64_t q = 0, bs = 0, w = 0, o = 0, sp = 0;
+	unsigned k;
+	for(k = 0; k < 4; ++k){
+		const __m128i v = _mm_loadu_si128((const __m128i*)(b + 16 * k));
+		/* '[' and ']' differ from '{' and '}' only by bit 0x20. */
+		const __m128i v20 = _mm_or_si128(v, _mm_set1_epi8(0x20));
+		const unsigned shift = 16 * k;
+		q |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << shift;
+		bs |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << shift;
+		w |= (uint64_t)_mm_movemask_epi8(_mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+				_mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+				_mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))))) << shift;
+		o |= (uint64_t)_mm_movemask_epi8(_mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(v20, _mm_set1_epi8('{')),
+				_mm_cmpeq_epi8(v20, _mm_set1_epi8('}'))),
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')),
+				_mm_cmpeq_epi8(v, _mm_set1_epi8(','))))) << shift;
+		/* Signed compare catches control chars and bytes >= 0x80. */
+		sp |= (uint64_t)_mm_movemask_epi8(
+			_mm_cmplt_epi8(v, _mm_set1_epi8(' '))) << shift;
+	}
+	*quote = q;
+	*bslash = bs;
+	*ws = w;
+	*op = o;
+	*special = sp;
+#else
+	unsigned k;
+	*quote = *bslash = *ws = *op = *special = 0;
+	for(k = 0; k < 64; ++k){
+		const uint64_t bit = (uint64_t)1 << k;
+		switch(b[k]){
+			case '"':
+				*quote |= bit;
+				break;
+			case '\\':
+				*bslash |= bit;
+				break;
+			case '{':
+			case '}':
+			case '[':
+			case ']':
+			case ':':
+			case ',':
+				*op |= bit;
+				break;
+			default:
+				if(s_lookup[b[k]] & CWHI)
+					*ws |= bit;
+				if(b[k] < 0x20 || b[k] >= 0x80)
+					*special |= bit;
+		}
+	}
+#endif
+}
+
+bnj_index* bnj_index_init(bnj_index* idx, uint32_t* storage,
+	uint32_t capacity)
+{
+	idx->pos = storage;
+	idx->capacity = capacity;
+	idx->count = 0;
+	idx->covered = 0;
+	idx->buffer = NULL;
+	idx->len = 0;
+	return idx;
+}
+
+uint32_t bnj_index_build(bnj_index* idx, const uint8_t* buffer, uint32_t len){
+	/* State carried between blocks. */
+	uint64_t esc_carry = 0;
+	uint64_t in_carry = 0;
+	uint64_t other_carry = 0;
+	uint32_t open = 0;
+	unsigned dirty = 0;
+
+	uint32_t count = 0;
+	uint32_t base;
+
+	idx->buffer = buffer;
+	idx->len = len;
+
+	/* Offsets must leave room for BNJ_INDEX_DIRTY. */
+	if(len > BNJ_INDEX_OFFSET_MASK)
+		len = BNJ_INDEX_OFFSET_MASK;
+
+	for(base = 0; base < len; base += 64){
+		uint64_t quote, bslash, ws, op, special;
+		const uint8_t* b = buffer + base;
+
+		/* Pad the last block with whitespace. */
+		uint8_t tail[64];
+		if(len - base < 64){
+			memset(tail, ' ', 64);
+			memcpy(tail, b, len - base);
+			b = tail;
+		}
+		s_classify64(b, &quote, &bslash, &ws, &op, &special);
+
+		/* Real quotes, and the string interiors they delimit. Opening quotes
+		 * are inside their string, closing quotes are not. */
+		const uint64_t q = quote & ~s_escaped(bslash, &esc_carry);
+		const uint64_t inside = s_prefix_xor(q) ^ in_carry;
+		in_carry = (uint64_t)((int64_t)inside >> 63);
+
+		/* First byte of every other token outside strings. */
+		const uint64_t other = ~(op | ws | quote | inside);
+		const uint64_t starts = other & ~((other << 1) | other_carry);
+		other_carry = other >> 63;
+
+		const uint64_t emit = (op & ~inside) | q | starts;
+		const uint64_t dirt = (special | bslash) & inside;
+
+		/* Common case: just write out the entries. */
+		if(!(dirt | dirty) && idx->capacity - count >= 64){
+			const uint64_t opens = q & inside;
+			uint64_t bits = emit;
+			uint32_t* const out = idx->pos + count;
+			unsigned k = 0;
+			while(bits){
+				out[k++] = base + s_ctz64(bits);
+				bits &= bits - 1;
+			}
+
+			/* Entry of the last opening quote. */
+			if(opens){
+				const uint64_t last = (uint64_t)1 << (63 - s_clz64(opens));
+				open = count + s_popcount64(emit & (last - 1));
+			}
+			count += k;
+			continue;
+		}
+
+		uint64_t bits = emit | dirt;
+		while(bits){
+			const unsigned p = s_ctz64(bits);
+			const uint64_t bit = (uint64_t)1 << p;
+
+			if(dirt & bit){
+				/* Rest of this string does not matter; drop its dirt bits. */
+				const uint64_t above = bits & ~(bit | (bit - 1));
+				const uint64_t next = above & emit;
+				dirty = 1;
+				bits = next ? (above & (emit | ~((next & -next) - 1))) : 0;
+				continue;
+			}
+
+			if(count == idx->capacity){
+				idx->count = count;
+				idx->covered = base + p;
+				return idx->covered;
+			}
+
+			if(q & bit){
+				if(inside & bit){
+					open = count;
+					dirty = 0;
+				}
+				else if(dirty){
+					idx->pos[open] |= BNJ_INDEX_DIRTY;
+				}
+			}
+			idx->pos[count++] = base + p;
+			bits &= bits - 1;
+		}
+	}
+
+	idx->count = count;
+	idx->covered = len;
+	return len;
+}
+
+uint32_t bnj_index_find(const bnj_index* idx, uint32_t offset){
+	uint32_t lo = 0;
+	uint32_t hi = idx->count;
+	while(lo != hi){
+		const uint32_t mid = lo + ((hi - lo) >> 1);
+		if((idx->pos[mid] & BNJ_INDEX_OFFSET_MASK) < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+uint32_t bnj_index_match(const bnj_index* idx, uint32_t entry){
+	unsigned depth = 0;
+	for(; entry < idx->count; ++entry){
+		switch(idx->buffer[idx->pos[entry] & BNJ_INDEX_OFFSET_MASK]){
+			case '{':
+			case '[':
+				++depth;
+				break;
+
+			case '}':
+			case ']':
+				if(0 == --depth)
+					return entry;
+				break;
+		}
+	}
+	return idx->count;
+}
+
+/* Number byte classes of key set; return class count. */
+static unsigned s_keymatcher_classes(uint8_t* byte_class,
+	char const * const * key_set, unsigned key_set_length)
+{
+	unsigned classes = 0;
+	unsigned k;
+	memset(byte_class, 0, 256);
+	for(k = 0; k < key_set_length; ++k){
+		const uint8_t* c;
+		for(c = (const uint8_t*)key_set[k]; *c; ++c){
+			if(!byte_class[*c])
+				byte_class[*c] = ++classes;
+		}
+	}
+	return classes;
+}
+
+uint32_t bnj_keymatcher_size(char const * const * key_set,
+	unsigned key_set_length)
+{
+	uint8_t byte_class[256];
+	const unsigned stride =
+		s_keymatcher_classes(byte_class, key_set, key_set_length) + 3;
+
+	/* Row 0, row 1 and at most one row per key byte. */
+	uint32_t rows = 2;
+	unsigned k;
+	for(k = 0; k < key_set_length; ++k)
+		rows += strlen(key_set[k]);
+	return rows * stride;
+}
+
+/* Append a row that matches nothing.
+ * @return Row number; 0 if out of storage or row numbers. */
+static uint32_t s_keymatcher_row(bnj_keymatcher* km, uint32_t storage_len){
+	const uint32_t stride = km->stride;
+	if(km->rows == 0x10000 || storage_len / stride <= km->rows)
+		return 0;
+
+	uint16_t* row = km->table + km->rows * stride;
+	memset(row, 0, (stride - 1) * sizeof(uint16_t));
+	row[stride - 1] = km->key_set_length;
+	return km->rows++;
+}
+
+bnj_keymatcher* bnj_keymatcher_init(bnj_keymatcher* km,
+	char const * const * key_set, unsigned key_set_length, uint16_t* storage,
+	uint32_t storage_len)
+{
+	km->key_set = key_set;
+	km->key_set_length = key_set_length;
+	km->table = storage;
+	km->stride =
+		s_keymatcher_classes(km->byte_class, key_set, key_set_length) + 3;
+	km->rows = 0;
+
+	/* Row 0 rejects, row 1 is the root. */
+	const uint32_t stride = km->stride;
+	if(storage_len / stride < 2)
+		return NULL;
+	s_keymatcher_row(km, storage_len);
+	s_keymatcher_row(km, storage_len);
+
+	/* Insert each key into the trie. */
+	unsigned k;
+	for(k = 0; k < key_set_length; ++k){
+		uint32_t row = 1;
+		const uint32_t first_added = km->rows;
+		const uint8_t* c;
+		for(c = (const uint8_t*)key_set[k]; *c; ++c){
+			uint16_t* next = storage + row * stride + km->byte_class[*c];
+			if(!*next){
+				const uint32_t added = s_keymatcher_row(km, storage_len);
+				if(!added)
+					return NULL;
+				*next = added;
+			}
+			else{
+				/* Shared rows lead to more than one key. */
+				storage[*next * stride + stride - 2] = 0;
+			}
+			row = *next;
+		}
+
+		/* New rows lead only to this key, which ends at the last of them. */
+		uint32_t added;
+		for(added = first_added; added < km->rows; ++added)
+			storage[added * stride + stride - 2] = row;
+
+		uint16_t* key_enum = storage + row * stride + stride - 1;
+		if(*key_enum == key_set_length)
+			*key_enum = k;
+	}
+	return km;
+}
+
 uint8_t* bnj_fragcompact(bnj_val* frag, uint8_t* buffer, uint32_t* len){
 	unsigned begin = 0;
 	/* Check incomplete key. Implies no value read. */
 	//if(frag->type & BNJ_VFLAG_KEY_FRAGMENT){
 	if(frag->key_length){
 		/* Move key to the beginning of the buffer.
-		 * ASSUMING no overlap between src and dst!! */
-		memcpy(buffer, buffer + frag->key_offset, frag->key_length);
+		 * Key may be longer than its offset, so ranges can overlap. */
+		memmove(buffer, buffer + frag->key_offset, frag->key_length);
 
 		/* Shift offset to beginning of buffer. */
 		frag->key_offset = 0;
 		begin = frag->key_length;
 	}
 
-	/* Check incomplete value. If a string copy to beginning of buffer. */
+	/* Check incomplete value. If a string or number copy to beginning of
+	 * buffer. */
 	if(frag->type & BNJ_VFLAG_VAL_FRAGMENT){
-		if((frag->type & BNJ_TYPE_MASK) == BNJ_STRING){
-			/* String ends at end of buffer, so length = (end - offset). */
+		const unsigned t = frag->type & BNJ_TYPE_MASK;
+		if(BNJ_STRING == t || BNJ_NUMERIC == t){
+			/* Value ends at end of buffer, so length = (end - offset). */
 			unsigned slen = *len - frag->strval_offset;
-			memcpy(buffer + begin, buffer + frag->strval_offset, slen);
+			memmove(buffer + begin, buffer + frag->strval_offset, slen);
+			frag->strval_offset = begin;
 
 			/* Advance new buffer begin by string length. */
 			begin += slen;
@@ -1336,6 +2817,153 @@ uint8_t* bnj_json2utf8(uint8_t* dst, size_t destlen, const uint8_t** buff){
 	return dst;
 }
 
+/* Decode one code point of string content at *buff, and advance *buff past
+ * it. Content must have passed the parser. */
+static inline uint32_t s_json_cp(const uint8_t** buff){
+	const uint8_t* x = *buff;
+	uint32_t v;
+	if(*x != '\\'){
+		if(*x < 0x80){
+			v = x[0];
+			x += 1;
+		}
+		else if((*x & 0xE0) == 0xC0){
+			v = ((x[0] & 0x1F) << 6) | (x[1] & 0x3F);
+			x += 2;
+		}
+		else if((*x & 0xF0) == 0xE0){
+			v = ((x[0] & 0x0F) << 12) | ((x[1] & 0x3F) << 6) | (x[2] & 0x3F);
+			x += 3;
+		}
+		else{
+			v = ((x[0] & 0x07) << 18) | ((x[1] & 0x3F) << 12)
+				| ((x[2] & 0x3F) << 6) | (x[3] & 0x3F);
+			x += 4;
+		}
+		*buff = x;
+		return v;
+	}
+
+	++x;
+	switch(*x){
+		case 'b':
+			v = '\b';
+			break;
+		case 'f':
+			v = '\f';
+			break;
+		case 'n':
+			v = '\n';
+			break;
+		case 'r':
+			v = '\r';
+			break;
+		case 't':
+			v = '\t';
+			break;
+		case 'u':
+			v = (s_hex(x[1]) << 12) | (s_hex(x[2]) << 8) | (s_hex(x[3]) << 4)
+				| s_hex(x[4]);
+			x += 5;
+
+			/* Combine surrogate pair; the parser verified the second half. */
+			if(v >= 0xD800 && v < 0xDC00){
+				v = 0x10000 + ((v & 0x3FF) << 10)
+					+ (((s_hex(x[3]) & 0x3) << 8) | (s_hex(x[4]) << 4) | s_hex(x[5]));
+				x += 6;
+			}
+			*buff = x;
+			return v;
+
+		/* '"', '\\' and '/' stand for themselves. */
+		default:
+			v = *x;
+	}
+	*buff = x + 1;
+	return v;
+}
+
+uint16_t* bnj_json2utf16(uint16_t* dst, size_t destlen, const uint8_t** buff){
+	const uint16_t* end = dst + destlen;
+	const uint8_t* x = *buff;
+	while(dst != end){
+#if defined(BNJ_AVX2) || defined(BNJ_SSE2)
+		/* Widen ASCII 16 bytes at a time. Each unit takes at least one byte
+		 * of content, so with 16 units left, 16 bytes of content remain. */
+		if(end - dst >= 16){
+			const __m128i v = _mm_loadu_si128((const __m128i*)x);
+			const unsigned m = _mm_movemask_epi8(
+				_mm_or_si128(v, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))));
+#if defined(BNJ_AVX2)
+			_mm256_storeu_si256((__m256i*)dst, _mm256_cvtepu8_epi16(v));
+#else
+			const __m128i z = _mm_setzero_si128();
+			_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(v, z));
+			_mm_storeu_si128((__m128i*)(dst + 8), _mm_unpackhi_epi8(v, z));
+#endif
+			/* Keep only units before the first escape or multibyte char. */
+			const unsigned n = m ? (unsigned)__builtin_ctz(m) : 16;
+			dst += n;
+			x += n;
+			if(16 == n)
+				continue;
+		}
+#endif
+
+		const uint8_t* rollback = x;
+		uint32_t v = s_json_cp(&x);
+		uint16_t* res = bnj_utf16_char(dst, end - dst, v);
+		if(dst == res){
+			/* Not enough space for surrogate pair. */
+			x = rollback;
+			break;
+		}
+		dst = res;
+	}
+
+	*buff = x;
+	return dst;
+}
+
+uint32_t* bnj_json2utf32(uint32_t* dst, size_t destlen, const uint8_t** buff){
+	const uint32_t* end = dst + destlen;
+	const uint8_t* x = *buff;
+	while(dst != end){
+#if defined(BNJ_AVX2) || defined(BNJ_SSE2)
+		/* Widen ASCII 16 bytes at a time, as in bnj_json2utf16. */
+		if(end - dst >= 16){
+			const __m128i v = _mm_loadu_si128((const __m128i*)x);
+			const unsigned m = _mm_movemask_epi8(
+				_mm_or_si128(v, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))));
+#if defined(BNJ_AVX2)
+			_mm256_storeu_si256((__m256i*)dst, _mm256_cvtepu8_epi32(v));
+			_mm256_storeu_si256((__m256i*)(dst + 8),
+				_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+#else
+			const __m128i z = _mm_setzero_si128();
+			const __m128i lo = _mm_unpacklo_epi8(v, z);
+			const __m128i hi = _mm_unpackhi_epi8(v, z);
+			_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(lo, z));
+			_mm_storeu_si128((__m128i*)(dst + 4), _mm_unpackhi_epi16(lo, z));
+			_mm_storeu_si128((__m128i*)(dst + 8), _mm_unpacklo_epi16(hi, z));
+			_mm_storeu_si128((__m128i*)(dst + 12), _mm_unpackhi_epi16(hi, z));
+#endif
+			const unsigned n = m ? (unsigned)__builtin_ctz(m) : 16;
+			dst += n;
+			x += n;
+			if(16 == n)
+				continue;
+		}
+#endif
+
+		*dst = s_json_cp(&x);
+		++dst;
+	}
+
+	*buff = x;
+	return dst;
+}
+
 inline uint8_t* bnj_stpncpy8(uint8_t* dst, const bnj_val* src, size_t len,
 	const uint8_t* buff)
 {
@@ -1360,18 +2988,1118 @@ inline uint8_t* bnj_stpncpy8(uint8_t* dst, const bnj_val* src, size_t len,
 				}
 			}
 
-			/* Only copy up to minimum of len and content length. */
+			/* Only copy up to minimum of len and content length.
+			 * Text without escapes is already UTF-8. */
 			const uint8_t* b = buff + src->strval_offset;
-			dst = bnj_json2utf8(dst, (clen < len) ? clen : len, &b);
+			if(!(src->type & BNJ_VFLAG_ESCAPED) && clen <= len){
+				memcpy(dst, b, clen);
+				dst += clen;
+			}
+			else{
+				dst = bnj_json2utf8(dst, (clen < len) ? clen : len, &b);
+			}
 		}
 		*dst = '\0';
 	}
 	return dst;
 }
 
+uint16_t* bnj_stpncpy16(uint16_t* dst, const bnj_val* src, size_t len,
+	const uint8_t* buff)
+{
+	if(len){
+		size_t clen = bnj_strlen16(src) / 2;
+		if(clen){
+			/* Save space for null terminator. */
+			--len;
+
+			/* Copy fragmented char if applicable. */
+			if(src->significand_val != BNJ_EMPTY_CP){
+				uint16_t* res =
+					bnj_utf16_char(dst, len, (uint32_t)src->significand_val);
+				if(dst != res){
+					len -= res - dst;
+					clen -= res - dst;
+					dst = res;
+				}
+				else{
+					*dst = 0;
+					return dst;
+				}
+			}
+
+			/* Only copy up to minimum of len and content length. */
+			const uint8_t* b = buff + src->strval_offset;
+			dst = bnj_json2utf16(dst, (clen < len) ? clen : len, &b);
+		}
+		*dst = 0;
+	}
+	return dst;
+}
+
+uint32_t* bnj_stpncpy32(uint32_t* dst, const bnj_val* src, size_t len,
+	const uint8_t* buff)
+{
+	if(len){
+		size_t clen = bnj_cpcount(src);
+		if(clen){
+			/* Save space for null terminator. */
+			--len;
+
+			/* Copy fragmented char if applicable. */
+			if(src->significand_val != BNJ_EMPTY_CP){
+				if(!len){
+					*dst = 0;
+					return dst;
+				}
+				*dst = (uint32_t)src->significand_val;
+				++dst;
+				--len;
+				--clen;
+			}
+
+			/* Only copy up to minimum of len and content length. */
+			const uint8_t* b = buff + src->strval_offset;
+			dst = bnj_json2utf32(dst, (clen < len) ? clen : len, &b);
+		}
+		*dst = 0;
+	}
+	return dst;
+}
+
 #ifdef BNJ_WCHAR_SUPPORT
-/* TODO Implement wide character functions. */
 wchar_t* bnj_wcpncpy(wchar_t* dst, const bnj_val* src, size_t len, const uint8_t* buff){
-	return NULL;
+	/* wchar_t is UTF-16 on Windows, UTF-32 elsewhere. */
+	if(sizeof(wchar_t) == sizeof(uint16_t))
+		return (wchar_t*)bnj_stpncpy16((uint16_t*)dst, src, len, buff);
+	return (wchar_t*)bnj_stpncpy32((uint32_t*)dst, src, len, buff);
+}
+
+int bnj_wcscmp(const wchar_t* s1, const bnj_val* s2, const uint8_t* buff){
+	const uint8_t* x = buff + s2->strval_offset;
+	unsigned count = bnj_cpcount(s2);
+	unsigned k;
+	int pos = 1;
+
+	/* Fragmented char from the previous buffer comes first. */
+	uint32_t pending = (uint32_t)s2->significand_val;
+	while(count){
+		uint32_t v;
+		if(pending != BNJ_EMPTY_CP){
+			v = pending;
+			pending = BNJ_EMPTY_CP;
+		}
+		else{
+			v = s_json_cp(&x);
+		}
+		--count;
+
+		/* Compare code units in the width of wchar_t. */
+		uint32_t units[2] = {v, 0};
+		unsigned n = 1;
+		if(sizeof(wchar_t) == sizeof(uint16_t) && v >= 0x10000){
+			uint16_t pair[2];
+			bnj_utf16_char(pair, 2, v);
+			units[0] = pair[0];
+			units[1] = pair[1];
+			n = 2;
+		}
+		for(k = 0; k < n; ++k, ++s1, ++pos){
+			const uint32_t c = (uint32_t)*s1;
+			if(c != units[k])
+				return (c < units[k]) ? -pos : pos;
+		}
+	}
+	return *s1 ? pos : 0;
+}
+#endif
+
+/* digits * 10^exp as an integer. */
+static unsigned s_scale_integer(SIGNIFICAND digits, int64_t exp,
+	SIGNIFICAND* dest)
+{
+	if(!digits){
+		*dest = 0;
+		return BNJ_INT_EXACT;
+	}
+	while(!(digits % 10)){
+		digits /= 10;
+		++exp;
+	}
+	if(exp < 0)
+		return BNJ_INT_FRACTION;
+
+	for(; exp; --exp){
+		if(digits > SIGNIFICAND_MAX / 10)
+			return BNJ_INT_RANGE;
+		digits *= 10;
+	}
+	*dest = digits;
+	return BNJ_INT_EXACT;
+}
+
+unsigned bnj_integer(const bnj_val* src, const uint8_t* buff,
+	SIGNIFICAND* dest)
+{
+	if(!bnj_truncated(src))
+		return s_scale_integer(src->significand_val, src->exp_val, dest);
+
+	/* Dropped digits may be anything, so read all of them from the text. */
+	unsigned len = 0;
+	const uint8_t* t = buff ? bnj_numtext(src, buff, &len) : NULL;
+	if(!len)
+		return BNJ_INT_RANGE;
+	const uint8_t* end = t + len;
+
+	/* Find first and last nonzero digits, zeros after the last and count
+	 * of digits after the point. */
+	const uint8_t* first = NULL;
+	const uint8_t* last = NULL;
+	int64_t zeros = 0;
+	int64_t frac = 0;
+	int point = 0;
+	for(; t != end && 'e' != (*t | 0x20); ++t){
+		if('.' == *t){
+			point = 1;
+			continue;
+		}
+		frac += point;
+		if('0' != *t){
+			if(!first)
+				first = t;
+			last = t;
+			zeros = 0;
+		}
+		else
+			++zeros;
+	}
+	if(!first){
+		*dest = 0;
+		return BNJ_INT_EXACT;
+	}
+
+	/* Exponent, saturated far beyond any SIGNIFICAND. */
+	int64_t exp = 0;
+	if(t != end){
+		int neg = 0;
+		++t;
+		if('-' == *t || '+' == *t)
+			neg = ('-' == *(t++));
+		for(; t != end; ++t)
+			if(exp < 100000)
+				exp = exp * 10 + (*t - '0');
+		if(neg)
+			exp = -exp;
+	}
+
+	/* Last nonzero digit is not in the ones place or above. */
+	exp += zeros - frac;
+	if(exp < 0)
+		return BNJ_INT_FRACTION;
+
+	SIGNIFICAND digits = 0;
+	for(t = first; t <= last; ++t){
+		if('.' == *t)
+			continue;
+		if(digits > (SIGNIFICAND_MAX - (*t - '0')) / 10)
+			return BNJ_INT_RANGE;
+		digits = digits * 10 + (*t - '0');
+	}
+	return s_scale_integer(digits, exp, dest);
+}
+
+#ifdef BNJ_FLOAT_SUPPORT
+
+/* Decimal to binary floating point conversion. Eisel-Lemire algorithm;
+ * see Lemire, "Number Parsing at a Gigabyte per Second" (2021). */
+
+#define POW5_MIN -342
+#define POW5_MAX 308
+
+/* 5^q for q in [POW5_MIN, POW5_MAX], shifted so the top bit of [0] is set
+ * and truncated to 128 bits. Negative powers are rounded up. */
+static const uint64_t s_pow5[POW5_MAX - POW5_MIN + 1][2] = {
+	{0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL},
+	{0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL},
+	{0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL},
+	{0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL},
+	{0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL},
+	{0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL},
+	{0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL},
+	{0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL},
+	{0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL},
+	{0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL},
+	{0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL},
+	{0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL},
+	{0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL},
+	{0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL},
+	{0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL},
+	{0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL},
+	{0x84a57695fe98746dULL, 0x014bb630f7604b57ULL},
+	{0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL},
+	{0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL},
+	{0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL},
+	{0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL},
+	{0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL},
+	{0xfd00b897478238d0ULL, 0x8920b098955522b4ULL},
+	{0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL},
+	{0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL},
+	{0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL},
+	{0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL},
+	{0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL},
+	{0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL},
+	{0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL},
+	{0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL},
+	{0xeba09271e88d976bULL, 0xf7864a44c633682eULL},
+	{0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL},
+	{0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL},
+	{0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL},
+	{0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL},
+	{0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL},
+	{0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL},
+	{0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL},
+	{0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL},
+	{0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL},
+	{0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL},
+	{0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL},
+	{0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL},
+	{0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL},
+	{0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL},
+	{0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL},
+	{0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL},
+	{0xa37fce126597973cULL, 0xe50ff107bab528a0ULL},
+	{0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL},
+	{0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL},
+	{0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL},
+	{0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL},
+	{0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL},
+	{0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL},
+	{0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL},
+	{0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL},
+	{0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL},
+	{0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL},
+	{0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL},
+	{0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL},
+	{0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL},
+	{0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL},
+	{0x91376c36d99995beULL, 0x23100809b9c21fa1ULL},
+	{0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL},
+	{0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL},
+	{0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL},
+	{0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL},
+	{0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL},
+	{0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL},
+	{0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL},
+	{0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL},
+	{0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL},
+	{0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL},
+	{0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL},
+	{0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL},
+	{0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL},
+	{0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL},
+	{0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL},
+	{0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL},
+	{0xc987434744ac874eULL, 0xa327ffb266b56220ULL},
+	{0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL},
+	{0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL},
+	{0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL},
+	{0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL},
+	{0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL},
+	{0xc0314325637a1939ULL, 0xfa911155fefb5308ULL},
+	{0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL},
+	{0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL},
+	{0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL},
+	{0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL},
+	{0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL},
+	{0xb749faed14125d36ULL, 0xcef980ec671f667bULL},
+	{0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL},
+	{0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL},
+	{0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL},
+	{0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL},
+	{0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL},
+	{0xaecc49914078536dULL, 0x58fae9f773886e18ULL},
+	{0xda7f5bf590966848ULL, 0xaf39a475506a899eULL},
+	{0x888f99797a5e012dULL, 0x6d8406c952429603ULL},
+	{0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL},
+	{0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL},
+	{0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL},
+	{0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL},
+	{0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL},
+	{0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL},
+	{0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL},
+	{0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL},
+	{0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL},
+	{0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL},
+	{0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL},
+	{0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL},
+	{0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL},
+	{0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL},
+	{0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL},
+	{0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL},
+	{0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL},
+	{0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL},
+	{0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL},
+	{0xb913179899f68584ULL, 0x28e2557b59846e3fULL},
+	{0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL},
+	{0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL},
+	{0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL},
+	{0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL},
+	{0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL},
+	{0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL},
+	{0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL},
+	{0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL},
+	{0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL},
+	{0xd77485cb25823ac7ULL, 0x7d633293366b828bULL},
+	{0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL},
+	{0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL},
+	{0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL},
+	{0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL},
+	{0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL},
+	{0xcd795be870516656ULL, 0x67902e276c921f8bULL},
+	{0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL},
+	{0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL},
+	{0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL},
+	{0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL},
+	{0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL},
+	{0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL},
+	{0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL},
+	{0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL},
+	{0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL},
+	{0xef340a98172aace4ULL, 0x86fb897116c87c34ULL},
+	{0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL},
+	{0xbae0a846d2195712ULL, 0x8974836059cca109ULL},
+	{0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL},
+	{0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL},
+	{0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL},
+	{0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL},
+	{0x8e938662882af53eULL, 0x547eb47b7282ee9cULL},
+	{0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL},
+	{0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL},
+	{0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL},
+	{0xae0b158b4738705eULL, 0x9624ab50b148d445ULL},
+	{0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL},
+	{0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL},
+	{0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL},
+	{0xd47487cc8470652bULL, 0x7647c3200069671fULL},
+	{0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL},
+	{0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL},
+	{0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL},
+	{0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL},
+	{0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL},
+	{0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL},
+	{0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL},
+	{0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL},
+	{0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL},
+	{0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL},
+	{0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL},
+	{0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL},
+	{0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL},
+	{0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL},
+	{0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL},
+	{0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL},
+	{0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL},
+	{0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL},
+	{0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL},
+	{0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL},
+	{0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL},
+	{0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL},
+	{0x8c974f7383725573ULL, 0x1e414218c73a13fbULL},
+	{0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL},
+	{0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL},
+	{0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL},
+	{0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL},
+	{0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL},
+	{0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL},
+	{0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL},
+	{0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL},
+	{0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL},
+	{0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL},
+	{0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL},
+	{0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL},
+	{0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL},
+	{0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL},
+	{0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL},
+	{0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL},
+	{0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL},
+	{0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL},
+	{0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL},
+	{0xbe89523386091465ULL, 0xf6bbb397f1135823ULL},
+	{0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL},
+	{0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL},
+	{0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL},
+	{0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL},
+	{0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL},
+	{0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL},
+	{0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL},
+	{0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL},
+	{0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL},
+	{0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL},
+	{0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL},
+	{0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL},
+	{0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL},
+	{0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL},
+	{0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL},
+	{0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL},
+	{0x843610cb4bf160cbULL, 0xcedf722a585139baULL},
+	{0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL},
+	{0xce947a3da6a9273eULL, 0x733d226229feea32ULL},
+	{0x811ccc668829b887ULL, 0x0806357d5a3f525fULL},
+	{0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL},
+	{0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL},
+	{0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL},
+	{0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL},
+	{0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL},
+	{0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL},
+	{0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL},
+	{0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL},
+	{0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL},
+	{0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL},
+	{0xbbe226efb628afeaULL, 0x890489f70a55368bULL},
+	{0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL},
+	{0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL},
+	{0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL},
+	{0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL},
+	{0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL},
+	{0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL},
+	{0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL},
+	{0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL},
+	{0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL},
+	{0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL},
+	{0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL},
+	{0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL},
+	{0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL},
+	{0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL},
+	{0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL},
+	{0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL},
+	{0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL},
+	{0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL},
+	{0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL},
+	{0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL},
+	{0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL},
+	{0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL},
+	{0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL},
+	{0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL},
+	{0xc24452da229b021bULL, 0xfbe85badce996168ULL},
+	{0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL},
+	{0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL},
+	{0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL},
+	{0xed246723473e3813ULL, 0x290123e9aab23b68ULL},
+	{0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL},
+	{0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL},
+	{0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL},
+	{0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL},
+	{0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL},
+	{0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL},
+	{0x8d590723948a535fULL, 0x579c487e5a38ad0eULL},
+	{0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL},
+	{0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL},
+	{0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL},
+	{0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL},
+	{0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL},
+	{0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL},
+	{0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL},
+	{0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL},
+	{0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL},
+	{0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL},
+	{0xcdb02555653131b6ULL, 0x3792f412cb06794dULL},
+	{0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL},
+	{0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL},
+	{0xc8de047564d20a8bULL, 0xf245825a5a445275ULL},
+	{0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL},
+	{0x9ced737bb6c4183dULL, 0x55464dd69685606bULL},
+	{0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL},
+	{0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL},
+	{0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL},
+	{0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL},
+	{0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL},
+	{0x95a8637627989aadULL, 0xdde7001379a44aa8ULL},
+	{0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL},
+	{0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL},
+	{0x9226712162ab070dULL, 0xcab3961304ca70e8ULL},
+	{0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL},
+	{0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL},
+	{0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL},
+	{0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL},
+	{0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL},
+	{0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL},
+	{0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL},
+	{0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL},
+	{0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL},
+	{0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL},
+	{0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL},
+	{0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL},
+	{0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL},
+	{0xcfb11ead453994baULL, 0x67de18eda5814af2ULL},
+	{0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL},
+	{0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL},
+	{0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL},
+	{0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL},
+	{0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL},
+	{0xc612062576589ddaULL, 0x95364afe032a819eULL},
+	{0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL},
+	{0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL},
+	{0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL},
+	{0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL},
+	{0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL},
+	{0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL},
+	{0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL},
+	{0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL},
+	{0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL},
+	{0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL},
+	{0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL},
+	{0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL},
+	{0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL},
+	{0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL},
+	{0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL},
+	{0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL},
+	{0x89705f4136b4a597ULL, 0x31680a88f8953031ULL},
+	{0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL},
+	{0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL},
+	{0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL},
+	{0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL},
+	{0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL},
+	{0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL},
+	{0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL},
+	{0xccccccccccccccccULL, 0xcccccccccccccccdULL},
+	{0x8000000000000000ULL, 0x0000000000000000ULL},
+	{0xa000000000000000ULL, 0x0000000000000000ULL},
+	{0xc800000000000000ULL, 0x0000000000000000ULL},
+	{0xfa00000000000000ULL, 0x0000000000000000ULL},
+	{0x9c40000000000000ULL, 0x0000000000000000ULL},
+	{0xc350000000000000ULL, 0x0000000000000000ULL},
+	{0xf424000000000000ULL, 0x0000000000000000ULL},
+	{0x9896800000000000ULL, 0x0000000000000000ULL},
+	{0xbebc200000000000ULL, 0x0000000000000000ULL},
+	{0xee6b280000000000ULL, 0x0000000000000000ULL},
+	{0x9502f90000000000ULL, 0x0000000000000000ULL},
+	{0xba43b74000000000ULL, 0x0000000000000000ULL},
+	{0xe8d4a51000000000ULL, 0x0000000000000000ULL},
+	{0x9184e72a00000000ULL, 0x0000000000000000ULL},
+	{0xb5e620f480000000ULL, 0x0000000000000000ULL},
+	{0xe35fa931a0000000ULL, 0x0000000000000000ULL},
+	{0x8e1bc9bf04000000ULL, 0x0000000000000000ULL},
+	{0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL},
+	{0xde0b6b3a76400000ULL, 0x0000000000000000ULL},
+	{0x8ac7230489e80000ULL, 0x0000000000000000ULL},
+	{0xad78ebc5ac620000ULL, 0x0000000000000000ULL},
+	{0xd8d726b7177a8000ULL, 0x0000000000000000ULL},
+	{0x878678326eac9000ULL, 0x0000000000000000ULL},
+	{0xa968163f0a57b400ULL, 0x0000000000000000ULL},
+	{0xd3c21bcecceda100ULL, 0x0000000000000000ULL},
+	{0x84595161401484a0ULL, 0x0000000000000000ULL},
+	{0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL},
+	{0xcecb8f27f4200f3aULL, 0x0000000000000000ULL},
+	{0x813f3978f8940984ULL, 0x4000000000000000ULL},
+	{0xa18f07d736b90be5ULL, 0x5000000000000000ULL},
+	{0xc9f2c9cd04674edeULL, 0xa400000000000000ULL},
+	{0xfc6f7c4045812296ULL, 0x4d00000000000000ULL},
+	{0x9dc5ada82b70b59dULL, 0xf020000000000000ULL},
+	{0xc5371912364ce305ULL, 0x6c28000000000000ULL},
+	{0xf684df56c3e01bc6ULL, 0xc732000000000000ULL},
+	{0x9a130b963a6c115cULL, 0x3c7f400000000000ULL},
+	{0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL},
+	{0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL},
+	{0x96769950b50d88f4ULL, 0x1314448000000000ULL},
+	{0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL},
+	{0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL},
+	{0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL},
+	{0xb7abc627050305adULL, 0xf14a3d9e40000000ULL},
+	{0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL},
+	{0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL},
+	{0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL},
+	{0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL},
+	{0x8c213d9da502de45ULL, 0x4526f422cc340000ULL},
+	{0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL},
+	{0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL},
+	{0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL},
+	{0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL},
+	{0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL},
+	{0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL},
+	{0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL},
+	{0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL},
+	{0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL},
+	{0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL},
+	{0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL},
+	{0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL},
+	{0x9f4f2726179a2245ULL, 0x01d762422c946590ULL},
+	{0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL},
+	{0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL},
+	{0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL},
+	{0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL},
+	{0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL},
+	{0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL},
+	{0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL},
+	{0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL},
+	{0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL},
+	{0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL},
+	{0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL},
+	{0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL},
+	{0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL},
+	{0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL},
+	{0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL},
+	{0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL},
+	{0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL},
+	{0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL},
+	{0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL},
+	{0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL},
+	{0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL},
+	{0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL},
+	{0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL},
+	{0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL},
+	{0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL},
+	{0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL},
+	{0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL},
+	{0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL},
+	{0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL},
+	{0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL},
+	{0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL},
+	{0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL},
+	{0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL},
+	{0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL},
+	{0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL},
+	{0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL},
+	{0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL},
+	{0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL},
+	{0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL},
+	{0x924d692ca61be758ULL, 0x593c2626705f9c56ULL},
+	{0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL},
+	{0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL},
+	{0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL},
+	{0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL},
+	{0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL},
+	{0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL},
+	{0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL},
+	{0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL},
+	{0x884134fe908658b2ULL, 0x3109058d147fdcddULL},
+	{0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL},
+	{0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL},
+	{0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL},
+	{0xa6539930bf6bff45ULL, 0x84db8346b786151cULL},
+	{0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL},
+	{0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL},
+	{0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL},
+	{0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL},
+	{0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL},
+	{0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL},
+	{0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL},
+	{0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL},
+	{0x9ae757596946075fULL, 0x3375788de9b06958ULL},
+	{0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL},
+	{0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL},
+	{0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL},
+	{0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL},
+	{0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL},
+	{0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL},
+	{0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL},
+	{0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL},
+	{0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL},
+	{0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL},
+	{0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL},
+	{0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL},
+	{0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL},
+	{0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL},
+	{0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL},
+	{0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL},
+	{0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL},
+	{0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL},
+	{0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL},
+	{0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL},
+	{0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL},
+	{0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL},
+	{0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL},
+	{0x802221226be55a64ULL, 0xc2494954da2c9789ULL},
+	{0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL},
+	{0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL},
+	{0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL},
+	{0x9c69a97284b578d7ULL, 0xff2a760414536efbULL},
+	{0xc38413cf25e2d70dULL, 0xfef5138519684abaULL},
+	{0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL},
+	{0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL},
+	{0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL},
+	{0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL},
+	{0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL},
+	{0xba756174393d88dfULL, 0x94f971119aeef9e4ULL},
+	{0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL},
+	{0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL},
+	{0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL},
+	{0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL},
+	{0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL},
+	{0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL},
+	{0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL},
+	{0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL},
+	{0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL},
+	{0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL},
+	{0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL},
+	{0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL},
+	{0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL},
+	{0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL},
+	{0xa59bc234db398c25ULL, 0x43fab9837e699095ULL},
+	{0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL},
+	{0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL},
+	{0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL},
+	{0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL},
+	{0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL},
+	{0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL},
+	{0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL},
+	{0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL},
+	{0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL},
+	{0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL},
+	{0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL},
+	{0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL},
+	{0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL},
+	{0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL},
+	{0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL},
+	{0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL},
+	{0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL},
+	{0x8fa475791a569d10ULL, 0xf96e017d694487bcULL},
+	{0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL},
+	{0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL},
+	{0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL},
+	{0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL},
+	{0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL},
+	{0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL},
+	{0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL},
+	{0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL},
+	{0x85c7056562757456ULL, 0xf6872d5667844e49ULL},
+	{0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL},
+	{0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL},
+	{0x82a45b450226b39cULL, 0xecc0024661173473ULL},
+	{0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL},
+	{0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL},
+	{0xff290242c83396ceULL, 0x7e67047175a15271ULL},
+	{0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL},
+	{0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL},
+	{0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL},
+	{0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL},
+	{0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL},
+	{0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL},
+	{0x98165af37b2153deULL, 0xc3727a337a8b704aULL},
+	{0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL},
+	{0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL},
+	{0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL},
+	{0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL},
+	{0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL},
+	{0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL},
+	{0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL},
+	{0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL},
+	{0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL},
+	{0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL},
+	{0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL},
+	{0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL},
+	{0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL},
+	{0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL},
+	{0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL},
+	{0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL},
+	{0xd31045a8341ca07cULL, 0x1ede48111209a050ULL},
+	{0x83ea2b892091e44dULL, 0x934aed0aab460432ULL},
+	{0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL},
+	{0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL},
+	{0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL},
+	{0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL},
+	{0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL},
+	{0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL},
+	{0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL},
+	{0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL},
+	{0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL},
+	{0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL},
+	{0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL},
+	{0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL},
+	{0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL},
+	{0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL},
+	{0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL},
+	{0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL},
+	{0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL},
+	{0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL},
+	{0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL},
+	{0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL},
+	{0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL},
+	{0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL},
+	{0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL},
+	{0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL},
+	{0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL},
+	{0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL},
+	{0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL},
+	{0x8533285c936b35deULL, 0xd53a88958f87275fULL},
+	{0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL},
+	{0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL},
+	{0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL},
+	{0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL},
+	{0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL},
+	{0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL},
+	{0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL},
+	{0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL},
+	{0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL},
+	{0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL},
+	{0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL},
+	{0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL},
+	{0x976e41088617ca01ULL, 0xd5be0503e085d813ULL},
+	{0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL},
+	{0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL},
+	{0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL},
+	{0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL},
+	{0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL},
+	{0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL},
+	{0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL},
+	{0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL},
+	{0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL},
+	{0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL},
+	{0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL},
+	{0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL},
+	{0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL},
+	{0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL},
+	{0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL},
+	{0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL},
+	{0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL},
+	{0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL},
+	{0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL},
+	{0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL},
+	{0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL},
+	{0xa0555e361951c366ULL, 0xd7e105bcc332621fULL},
+	{0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL},
+	{0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL},
+	{0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL},
+	{0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL},
+	{0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL},
+	{0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL},
+	{0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL},
+	{0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL},
+	{0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL},
+	{0xbaa718e68396cffdULL, 0xd30560258f54e6baULL},
+	{0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL},
+	{0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL},
+	{0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL},
+	{0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL},
+	{0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL},
+};
+
+/* Powers of ten exactly representable as doubles. */
+static const double s_exact10[23] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* IEEE binary format parameters. */
+typedef struct s_binfmt_s{
+	/* Explicit mantissa bits. */
+	int mantissa_bits;
+
+	/* Exponent bias, negated. */
+	int min_exponent;
+
+	/* Biased exponent of infinity. */
+	int inf_power;
+
+	/* Below this power of ten even the largest significand rounds to 0. */
+	int min_pow10;
+
+	/* Above this power of ten any nonzero significand is infinite. */
+	int max_pow10;
+
+	/* Range of powers of ten where exact halfway cases are possible. */
+	int min_even;
+	int max_even;
+} s_binfmt;
+
+static const s_binfmt s_binary64 = {52, -1023, 0x7FF, -342, 308, -4, 23};
+static const s_binfmt s_binary32 = {23, -127, 0xFF, -65, 38, -17, 10};
+
+/* Full product of a and b.
+ * @param lo Set to the low 64 bits.
+ * @return High 64 bits. */
+static inline uint64_t s_mul128(uint64_t a, uint64_t b, uint64_t* lo){
+#ifdef __SIZEOF_INT128__
+	const unsigned __int128 prod = (unsigned __int128)a * b;
+	*lo = (uint64_t)prod;
+	return prod >> 64;
+#else
+	/* Schoolbook on 32 bit halves. */
+	const uint64_t a0 = (uint32_t)a, a1 = a >> 32;
+	const uint64_t b0 = (uint32_t)b, b1 = b >> 32;
+	const uint64_t p00 = a0 * b0;
+	const uint64_t p01 = a0 * b1;
+	const uint64_t p10 = a1 * b0;
+	const uint64_t p11 = a1 * b1;
+	const uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+	*lo = (mid << 32) | (uint32_t)p00;
+	return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+/* Correctly rounded w * 10^q in format f.
+ * @param bits Set to the IEEE bit pattern, less the sign bit.
+ * @return 0 if rounding could not be decided; bits is untouched. */
+static int s_eisel_lemire(uint64_t w, int q, const s_binfmt* f, uint64_t* bits){
+	if(!w || q < f->min_pow10){
+		*bits = 0;
+		return 1;
+	}
+	if(q > f->max_pow10){
+		*bits = (uint64_t)f->inf_power << f->mantissa_bits;
+		return 1;
+	}
+
+	/* Normalize w and take the high 64 bits of w * 5^q. */
+	const int lz = s_clz64(w);
+	w <<= lz;
+	const uint64_t* const p5 = s_pow5[q - POW5_MIN];
+	uint64_t lo;
+	uint64_t hi = s_mul128(w, p5[0], &lo);
+
+	/* If the bits below the mantissa are all ones, the truncated table may
+	 * matter; refine with the low half of 5^q. */
+	const uint64_t mask = ~(uint64_t)0 >> (f->mantissa_bits + 3);
+	if((hi & mask) == mask && lo + w < lo){
+		uint64_t lo2;
+		const uint64_t mid = lo + s_mul128(w, p5[1], &lo2);
+		if(mid < lo)
+			++hi;
+		if(mid + 1 == 0 && (hi & mask) == mask && lo2 + w < lo2)
+			return 0;
+		lo = mid;
+	}
+
+	/* Keep mantissa_bits + 3 bits: one implicit, one to round, one spare. */
+	const int upperbit = hi >> 63;
+	const int shift = upperbit + 64 - f->mantissa_bits - 3;
+	uint64_t mantissa = hi >> shift;
+
+	/* floor(log2(10^q)) + 63, as in the paper. */
+	int power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz - f->min_exponent;
+
+	if(power2 <= 0){
+		/* Subnormal or zero. */
+		if(-power2 + 1 >= 64){
+			*bits = 0;
+			return 1;
+		}
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		power2 = (mantissa < ((uint64_t)1 << f->mantissa_bits)) ? 0 : 1;
+		*bits = (mantissa & ~((uint64_t)1 << f->mantissa_bits))
+			| ((uint64_t)power2 << f->mantissa_bits);
+		return 1;
+	}
+
+	/* Exactly halfway between two values: round to even. */
+	if(lo <= 1 && q >= f->min_even && q <= f->max_even && (mantissa & 3) == 1){
+		if((mantissa << shift) == hi)
+			mantissa &= ~(uint64_t)1;
+	}
+
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if(mantissa >= ((uint64_t)2 << f->mantissa_bits)){
+		mantissa = (uint64_t)1 << f->mantissa_bits;
+		++power2;
+	}
+	mantissa &= ~((uint64_t)1 << f->mantissa_bits);
+
+	if(power2 >= f->inf_power){
+		power2 = f->inf_power;
+		mantissa = 0;
+	}
+	*bits = mantissa | ((uint64_t)power2 << f->mantissa_bits);
+	return 1;
+}
+
+/* Decimal text of w * 10^q for the strtod fallback. */
+static void s_dectext(char* dst, uint64_t w, int q){
+	char tmp[24];
+	char* t = tmp + sizeof(tmp);
+	do{
+		*--t = '0' + w % 10;
+		w /= 10;
+	} while(w);
+	while(t != tmp + sizeof(tmp))
+		*dst++ = *t++;
+
+	*dst++ = 'e';
+	if(q < 0){
+		*dst++ = '-';
+		q = -q;
+	}
+	t = tmp + sizeof(tmp);
+	do{
+		*--t = '0' + q % 10;
+		q /= 10;
+	} while(q);
+	while(t != tmp + sizeof(tmp))
+		*dst++ = *t++;
+	*dst = '\0';
 }
+
+double bnj_double(const bnj_val* src){
+	if(BNJ_NUMERIC == bnj_val_type(src)){
+		const uint64_t w = src->significand_val;
+		const int q = src->exp_val;
+		double dest;
+
+		if(w <= ((uint64_t)1 << 53) && q >= -22 && q <= 22){
+			/* Both operands exact, so one rounding. */
+			dest = w;
+			dest = (q < 0) ? dest / s_exact10[-q] : dest * s_exact10[q];
+		}
+		else{
+			uint64_t bits, bits_up;
+			if(s_eisel_lemire(w, q, &s_binary64, &bits)
+				&& (!bnj_truncated(src)
+					|| (s_eisel_lemire(w + 1, q, &s_binary64, &bits_up) && bits == bits_up)))
+			{
+				/* If digits were truncated, the true value lies between w and
+				 * w + 1; when both round the same, so does it. */
+				memcpy(&dest, &bits, sizeof(dest));
+			}
+			else{
+				char txt[48];
+				s_dectext(txt, w, q);
+				dest = strtod(txt, NULL);
+			}
+		}
+		return (src->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -dest : dest;
+	}
+	else{
+		if(BNJ_SPC_NAN == src->significand_val)
+			return NAN;
+		else
+			return (src->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -INFINITY: INFINITY;
+	}
+}
+
+float bnj_float(const bnj_val* src){
+	if(BNJ_NUMERIC == bnj_val_type(src)){
+		const uint64_t w = src->significand_val;
+		const int q = src->exp_val;
+		float dest;
+
+		if(w <= ((uint64_t)1 << 24) && q >= -10 && q <= 10){
+			/* Both operands exact, so one rounding. */
+			dest = w;
+			dest = (q < 0) ? dest / (float)s_exact10[-q] : dest * (float)s_exact10[q];
+		}
+		else{
+			uint64_t bits, bits_up;
+			if(s_eisel_lemire(w, q, &s_binary32, &bits)
+				&& (!bnj_truncated(src)
+					|| (s_eisel_lemire(w + 1, q, &s_binary32, &bits_up) && bits == bits_up)))
+			{
+				const uint32_t b32 = bits;
+				memcpy(&dest, &b32, sizeof(dest));
+			}
+			else{
+				char txt[48];
+				s_dectext(txt, w, q);
+				dest = strtof(txt, NULL);
+			}
+		}
+		return (src->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -dest : dest;
+	}
+	else{
+		if(BNJ_SPC_NAN == src->significand_val)
+			return NAN;
+		else
+			return (src->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -INFINITY: INFINITY;
+	}
+}
+
 #endif
@@ -40,6 +40,39 @@ typedef uintmax_t SIGNIFICAND;
 #define BNJ_FLOAT_SUPPORT
 //#undef BNJ_FLOAT_SUPPORT
 
+/** @brief Use SSE2/AVX2 instructions when the compiler targets them.
+ * Otherwise falls back to word-at-a-time scanning. */
+#define BNJ_SIMD_SUPPORT
+//#undef BNJ_SIMD_SUPPORT
+
+/** @brief Jump between parser states with computed goto (a GCC extension)
+ * instead of returning to the switch for every transition.
+ * Ignored if the compiler is not GCC compatible. */
+#define BNJ_THREADED_DISPATCH
+//#undef BNJ_THREADED_DISPATCH
+
+/** @brief 32 bit in-buffer offsets and counts in bnj_val, and 64 bit stream
+ * offsets. Without it, buffers handed to bnj_parse must be shorter than
+ * 64 KiB and stream offsets wrap at 4 GiB. Grows bnj_val from 32 to 48
+ * bytes on 64 bit targets. */
+//#define BNJ_WIDE_OFFSETS
+
+#ifdef BNJ_WIDE_OFFSETS
+/** @brief Offset into a buffer handed to bnj_parse; also code point counts. */
+typedef uint32_t BUFF_OFFSET;
+/** @brief Signed BUFF_OFFSET. */
+typedef int32_t BUFF_SOFFSET;
+/** @brief Maximum BUFF_OFFSET value. */
+#define BUFF_OFFSET_MAX UINT32_MAX
+/** @brief Offset into a whole JSON stream. */
+typedef uint64_t STREAM_OFFSET;
+#else
+typedef uint16_t BUFF_OFFSET;
+typedef int16_t BUFF_SOFFSET;
+#define BUFF_OFFSET_MAX UINT16_MAX
+typedef uint32_t STREAM_OFFSET;
+#endif
+
 
 /************************************************************************/
 /* Conditional Includes. */
@@ -113,7 +146,11 @@ enum {
 	BNJ_VFLAG_KEY_FRAGMENT = 0x80,
 
 	/** @brief Key completed, but value fragment not yet started. */
-	BNJ_VFLAG_MIDDLE = 0x8
+	BNJ_VFLAG_MIDDLE = 0x8,
+
+	/** @brief String value contains escape sequences, so its text in buffer
+	 * is not plain UTF-8. */
+	BNJ_VFLAG_ESCAPED = 0x100
 };
 
 
@@ -217,6 +254,42 @@ enum {
 /* Forward declarations. */
 struct bnj_state_s;
 struct bnj_ctx_s;
+struct bnj_keymatcher_s;
+
+/** @brief What to report of the maps and lists at one depth.
+ * See bnj_projection. */
+typedef struct bnj_projlevel_s{
+	/** @brief Sorted keys of map members to report, as in bnj_ctx.key_set.
+	 * Keys at this depth are matched against these instead of bnj_ctx's, so
+	 * key_enum indexes them. If NULL, all members are reported. */
+	char const * const * key_set;
+
+	/** @brief Length of key_set. */
+	unsigned key_set_length;
+
+	/** @brief Report list elements with index in [first, last). The rest of a
+	 * list is skipped once last is reached. Indices saturate at 2^24 - 1.
+	 * 0 and UINT32_MAX report all elements. */
+	uint32_t first;
+	uint32_t last;
+} bnj_projlevel;
+
+/** @brief Projection of the values to report.
+ * Values left out are never emitted: no bnj_val, code point or digit counts,
+ * and no depth change for maps or lists. They are still parsed and
+ * validated in full, so malformed input is reported wherever it is. */
+typedef struct bnj_projection_s{
+	/** @brief levels[n] applies to the maps and lists at depth n + 1. */
+	const bnj_projlevel* levels;
+
+	/** @brief Length of levels. Deeper maps and lists are reported whole. */
+	uint32_t length;
+
+	/** @brief If nonzero, maps, lists and strings left out are passed over
+	 * as bnj_skip does instead: faster, but only quotes, escapes and bracket
+	 * nesting are checked. Numbers and literals are validated either way. */
+	uint32_t structural;
+} bnj_projection;
 
 /** @brief Callback function type. */
 typedef int(*bnj_cb)(const struct bnj_state_s* state, struct bnj_ctx_s* ctx,
@@ -232,47 +305,68 @@ typedef struct bnj_ctx_s{
 	void* user_data;
 
 	/** @brief Sorted list of apriori known null terminated key strings.
-	 * THIS SHOULD NEVER CHANGE WHILE IN KEY FRAGMENT STATE. */
+	 * Sorted and compared as unsigned bytes of UTF-8 text. Keys in the data
+	 * match once unescaped, so "a\u0062" matches "ab".
+	 * THIS SHOULD NEVER CHANGE WHILE IN KEY FRAGMENT STATE; if it does, the
+	 * key being parsed matches nothing. */
 	char const * const * key_set;
 
 	/** @brief Length of key set.
 	 * THIS SHOULD NEVER CHANGE WHILE IN KEY FRAGMENT STATE. */
 	unsigned key_set_length;
+
+	/** @brief If not NULL, matches keys instead of key_set; key_enum indexes
+	 * key_matcher->key_set. See bnj_keymatcher_init.
+	 * THIS SHOULD NEVER CHANGE WHILE IN KEY FRAGMENT STATE. */
+	const struct bnj_keymatcher_s* key_matcher;
+
+	/** @brief If not NULL, only values it selects are reported.
+	 * THIS SHOULD NEVER CHANGE WHILE IN KEY FRAGMENT STATE. */
+	const bnj_projection* projection;
 } bnj_ctx;
 
 
 /** @brief Holds parsed JSON value.
  * Across fragments, the parser must preserve fields marked with [PAF].*/
 typedef struct bnj_val_s {
-	/** @brief Value type. [PAF] */
-	uint8_t type;
-
-	/** @brief Key's length of ASCII character data. 
-	 * No key should be more than 255 chars long! */
-	uint8_t key_length;
+	/** @brief Value type and BNJ_VFLAG_* flags. [PAF] */
+	uint16_t type;
 
 	/** @brief Numeric key id if key_set defined. [PAF] */
 	uint16_t key_enum;
 
+	/** @brief Key's length in the buffer, escapes included.
+	 * No key should be more than 255 chars long! */
+	uint8_t key_length;
+
 	/** @brief Key begins at offset from buffer. */
-	uint16_t key_offset;
+	BUFF_OFFSET key_offset;
 
-	/** @brief String value begins at offset from buffer. */
-	uint16_t strval_offset;
+	/** @brief String value begins at offset from buffer.
+	 * When type is BNJ_NUMERIC, number text (after any '-') begins here. */
+	BUFF_OFFSET strval_offset;
 
 	/** @brief When type is BNJ_UTF_*, count of code points between [0, 128). */
-	uint16_t cp1_count;
+	BUFF_OFFSET cp1_count;
 
 	/** @brief When type is BNJ_UTF_*, count of code points between [128, 2K). */
-	uint16_t cp2_count;
+	BUFF_OFFSET cp2_count;
 
 	/** @brief When type is BNJ_UTF_*, count of code points between [2K, 65K). */
-	uint16_t cp3_count;
+	BUFF_OFFSET cp3_count;
+
+	/** @brief When type is BNJ_NUMERIC, length of number text in buffer.
+	 * 0 if the text of a fragmented number was not kept. */
+	BUFF_OFFSET num_length;
 
 	/** @brief Valid when parsing numeric, holds the present exponent value [PAF].
 	 * Internal use only:
 	 *  When type is BNJ_UTF_*, count of code points between [65K, 1.1M). */
-	int16_t exp_val;
+	BUFF_SOFFSET exp_val;
+
+	/** @brief When type is BNJ_NUMERIC, count of significand digits that did
+	 * not fit in SIGNIFICAND; nonzero means precision was lost. */
+	uint32_t trunc_count;
 
 	/** @brief Numeric significand fragment. [PAF]
 	 * NOTE ACTUAL SIZE is ARCHITECTURE DEPENDENT! MUST BE AT LEAST 32bit
@@ -312,9 +406,28 @@ typedef struct bnj_state_s{
 	/** @brief Total count of DIGITS in significand. */
 	uint32_t digit_count;
 
+	/** @brief Count of trailing significand DIGITS dropped on overflow. */
+	uint32_t trunc_count;
+
 	/** @brief SPSJSON_SFLAGS_* flags. */
 	uint32_t flags;
 
+	/** @brief Depth of the value bnj_skip is skipping; 0 once skipped. */
+	uint32_t skip_depth;
+
+	/** @brief Depth of the map or list the projection left out, parsed but
+	 * not reported; 0 if none. */
+	uint32_t drop_depth;
+
+	/** @brief Nonzero if the key fragment the last call left at v[0] belonged
+	 * to a value the projection left out; v[0] is not its continuation. */
+	uint32_t key_dropped;
+
+	/** @brief Bytes consumed by earlier bnj_parse calls. If each call resumes
+	 * where the last stopped, a value's stream offset is this plus its offset
+	 * from buffer. */
+	STREAM_OFFSET parsed;
+
 
 	/* These following two are for internal use. Do not use in user code. */
 
@@ -330,6 +443,9 @@ typedef struct bnj_state_s{
 	/** @brief Internal key length counter. */
 	uint32_t _key_len;
 
+	/** @brief Key set or key matcher the key being matched began with. */
+	const void* _key_source;
+
 	/** @brief PAF key enum */
 	uint32_t _paf_key_enum;
 
@@ -352,6 +468,78 @@ typedef struct bnj_state_s{
 
 } bnj_state;
 
+enum {
+	/** @brief Bytes that must follow input to bnj_parse_padded. */
+	BNJ_PADDING = 32
+};
+
+/** @brief Structural index flags. */
+enum {
+	/** @brief Tags an opening quote whose string has escapes, control chars
+	 *  or bytes >= 0x80. */
+	BNJ_INDEX_DIRTY = 0x80000000,
+
+	/** @brief Masks the buffer offset out of an index entry. */
+	BNJ_INDEX_OFFSET_MASK = 0x7FFFFFFF
+};
+
+/** @brief Structural index of a complete buffer, built by bnj_index_build.
+ *  Entries are buffer offsets of, in order: '{' '}' '[' ']' ':' ','
+ *  outside of strings, both quotes of each string, and the first byte of
+ *  every other token (numbers, true, false, null).
+ *  A navigation aid, such as finding where a container closes without
+ *  parsing it; see bnj_index_find and bnj_index_match. The parser does
+ *  not use it, as building it costs more than it saves parsing. */
+typedef struct bnj_index_s{
+	/** @brief Entries; caller provided storage. */
+	uint32_t* pos;
+
+	/** @brief Length of pos. */
+	uint32_t capacity;
+
+	/** @brief Number of valid entries in pos. */
+	uint32_t count;
+
+	/** @brief Entries are complete for buffer offsets below this. When pos
+	 *  fills, covered < len and lookups find nothing past covered. */
+	uint32_t covered;
+
+	/** @brief Indexed buffer. */
+	const uint8_t* buffer;
+
+	/** @brief Length of buffer. */
+	uint32_t len;
+
+} bnj_index;
+
+/** @brief Key set compiled into a byte-at-a-time automaton (a trie over
+ *  byte classes), built by bnj_keymatcher_init. Matching costs one table
+ *  lookup per key byte regardless of key set size. */
+typedef struct bnj_keymatcher_s{
+	/** @brief Compiled key set. Need not be sorted. */
+	char const * const * key_set;
+
+	/** @brief Length of key_set. key_enum of keys not in key_set. */
+	unsigned key_set_length;
+
+	/** @brief Transition table; caller provided storage. Each row holds one
+	 *  next row number per byte class, then the row where the only key it
+	 *  leads to ends (rows in between are consecutive) or 0 if several keys
+	 *  remain, then the key_enum ending at the row or key_set_length.
+	 *  Row 0 matches nothing; row 1 is the empty key. */
+	uint16_t* table;
+
+	/** @brief Entries per row of table. */
+	uint32_t stride;
+
+	/** @brief Rows used in table. */
+	uint32_t rows;
+
+	/** @brief Byte class of each byte; 0 for bytes in no key. */
+	uint8_t byte_class[256];
+
+} bnj_keymatcher;
+
 
 /************************************************************************/
 /* API */
@@ -368,10 +556,79 @@ bnj_state* bnj_state_init(bnj_state* st, uint32_t* state_buffer, uint32_t stack_
 /** @brief Parse JSON txt.
  *  @param state JSON parsing state.
  *  @param buffer character data to parse.
- *  @param len    Length of buffer.
+ *  @param len    Length of buffer; at most BUFF_OFFSET_MAX.
  *  @return Where parsing ended. */
 const uint8_t* bnj_parse(bnj_state* state, bnj_ctx* ctx, const uint8_t* buffer, uint32_t len);
 
+/** @brief Parse JSON txt followed by BNJ_PADDING readable bytes.
+ *  Identical results to bnj_parse, including error offsets. Scans of
+ *  whitespace, strings and digits read whole blocks past len instead of
+ *  checking for the end of buffer. May be called repeatedly, same as
+ *  bnj_parse, as long as each buffer is padded.
+ *  @param state JSON parsing state.
+ *  @param buffer character data to parse. buffer[len] MUST be 0; the rest of
+ *  the padding may hold anything.
+ *  @param len    Length of buffer, excluding padding.
+ *  @return Where parsing ended. */
+const uint8_t* bnj_parse_padded(bnj_state* state, bnj_ctx* ctx,
+	const uint8_t* buffer, uint32_t len);
+
+/** @brief Initialize structural index.
+ *  @param idx Index to initialize.
+ *  @param storage Preallocated memory for index entries.
+ *  @param capacity Length of storage. One entry per structural character
+ *  and token; entries are distinct offsets, so len always suffices.
+ *  @return idx */
+bnj_index* bnj_index_init(bnj_index* idx, uint32_t* storage, uint32_t capacity);
+
+/** @brief Build structural index of a complete buffer.
+ *  The buffer is classified 64 bytes at a time; string interiors are
+ *  masked out with carryless quote parity.
+ *  @param idx Initialized index.
+ *  @param buffer Buffer to index. Must remain valid while idx is used.
+ *  @param len Length of buffer.
+ *  @return Bytes covered by the index; less than len if idx filled. */
+uint32_t bnj_index_build(bnj_index* idx, const uint8_t* buffer, uint32_t len);
+
+/** @brief Skip the rest of a map, list or string without reporting any of
+ *  its contents. Until past its end, following bnj_parse and
+ *  bnj_parse_padded calls only match quotes and brackets, then carry on
+ *  parsing as usual. Inside the skipped
+ *  value only bracket nesting is validated.
+ *  @param state JSON parsing state, between bnj_parse* calls.
+ *  @param depth Depth of the map or list to skip (1 for the outermost), or
+ *  state->depth + 1 to skip the rest of the string value being parsed.
+ *  Anything else skips nothing. */
+void bnj_skip(bnj_state* state, uint32_t depth);
+
+/** @brief Table entries bnj_keymatcher_init needs for a key set.
+ *  @param key_set Keys, in the same form as bnj_ctx.key_set.
+ *  @param key_set_length Length of key_set.
+ *  @return Sufficient storage length in entries. */
+uint32_t bnj_keymatcher_size(char const * const * key_set,
+	unsigned key_set_length);
+
+/** @brief Compile key set into a matcher for bnj_ctx.key_matcher.
+ *  Duplicate keys match the first duplicate.
+ *  @param km Matcher to initialize.
+ *  @param key_set Keys to match. Must remain valid while km is used.
+ *  @param key_set_length Length of key_set; at most 0xFFFF.
+ *  @param storage Preallocated memory for the transition table.
+ *  @param storage_len Length of storage. bnj_keymatcher_size() suffices.
+ *  @return km, or NULL if storage is too small or the keys need more than
+ *  0x10000 rows. */
+bnj_keymatcher* bnj_keymatcher_init(bnj_keymatcher* km,
+	char const * const * key_set, unsigned key_set_length, uint16_t* storage,
+	uint32_t storage_len);
+
+/** @brief Find first index entry at or after buffer offset.
+ *  @return Entry number; idx->count if none. */
+uint32_t bnj_index_find(const bnj_index* idx, uint32_t offset);
+
+/** @brief Find the entry of the '}' or ']' closing the '{' or '[' at entry.
+ *  @return Entry number; idx->count if unmatched within the index. */
+uint32_t bnj_index_match(const bnj_index* idx, uint32_t entry);
+
 /** @brief Helper function for fragment management.
  *  Moves key:value fragments to beginning of buffer.
  *  @param frag Fragmented key:value.
@@ -443,6 +700,24 @@ uint8_t* bnj_stpcpy8(uint8_t* dst, const bnj_val* src, const uint8_t* buff);
 uint8_t* bnj_stpncpy8(uint8_t* dst, const bnj_val* src, size_t len,
 	const uint8_t* buff);
 
+/** @brief Copy encoded string to UTF-16 destination, with length limit.
+ *  @param dst Where to copy data.
+ *  @param src BNJ value containing BNJ_STRING string data.
+ *  @param len Code unit length including null terminator.
+ *  @param buff buffer containing string data.
+ *  @return pointer to dst's null terminator. */
+uint16_t* bnj_stpncpy16(uint16_t* dst, const bnj_val* src, size_t len,
+	const uint8_t* buff);
+
+/** @brief Copy encoded string to UTF-32 destination, with length limit.
+ *  @param dst Where to copy data.
+ *  @param src BNJ value containing BNJ_STRING string data.
+ *  @param len Code point length including null terminator.
+ *  @param buff buffer containing string data.
+ *  @return pointer to dst's null terminator. */
+uint32_t* bnj_stpncpy32(uint32_t* dst, const bnj_val* src, size_t len,
+	const uint8_t* buff);
+
 /** @brief Utility copy function; really for INTERNAL or ADVANCED use.
  *  @param dst Where to store UTF-8 output.
  *  @param destlen How many UTF-8 bytes to store.
@@ -451,6 +726,16 @@ uint8_t* bnj_stpncpy8(uint8_t* dst, const bnj_val* src, size_t len,
  *  @return Pointer to next unwritten byte after dst. */
 uint8_t* bnj_json2utf8(uint8_t* dst, size_t destlen, const uint8_t** buff);
 
+/** @brief bnj_json2utf8 for UTF-16 output.
+ *  @param destlen How many UTF-16 code units to store.
+ *  MUST NOT EXCEED PREDICTED UTF-16 LENGTH IN BUFF! */
+uint16_t* bnj_json2utf16(uint16_t* dst, size_t destlen, const uint8_t** buff);
+
+/** @brief bnj_json2utf8 for UTF-32 output.
+ *  @param destlen How many code points to store.
+ *  MUST NOT EXCEED CODE POINT COUNT IN BUFF! */
+uint32_t* bnj_json2utf32(uint32_t* dst, size_t destlen, const uint8_t** buff);
+
 /** @brief Utility function to convert code point to utf encoding
  * Does NOT null terminate.
  *  @param dst Where to store UTF-8 output.
@@ -459,6 +744,14 @@ uint8_t* bnj_json2utf8(uint8_t* dst, size_t destlen, const uint8_t** buff);
  *  @return Pointer to next unwritten byte after dst. */
 uint8_t* bnj_utf8_char(uint8_t* dst, unsigned len, uint32_t cp);
 
+/** @brief Utility function to convert code point to UTF-16, as a surrogate
+ * pair if necessary. Does NOT null terminate.
+ *  @param dst Where to store UTF-16 output.
+ *  @param len Number of code units in dst.
+ *  @param cp code point value.
+ *  @return Pointer to next unwritten unit after dst. */
+uint16_t* bnj_utf16_char(uint16_t* dst, unsigned len, uint32_t cp);
+
 #ifdef BNJ_WCHAR_SUPPORT
 
 /** @brief Copy JSON encoded string to wide character string.
@@ -469,6 +762,7 @@ uint8_t* bnj_utf8_char(uint8_t* dst, unsigned len, uint32_t cp);
 wchar_t* bnj_wcpcpy(wchar_t* dst, const bnj_val* src, const uint8_t* buff);
 
 /** @brief Copy encoded string to wide character string, with length limit.
+ *  Output is UTF-16 if wchar_t is 16 bits, otherwise UTF-32.
  *  @param dst Where to copy data. Must hold at least src->string_val + 1 chars.
  *  @param src BNJ value containing BNJ_STRING string data.
  *  @param len Character length including null terminator.
@@ -478,11 +772,13 @@ wchar_t* bnj_wcpncpy(wchar_t* dst, const bnj_val* src, size_t len,
 	const uint8_t* buff);
 
 /** @brief Compare JSON encoded string to wide character string.
+ *  For a value fragment, only the part within buff.
  *  @param s1 Normal string.
  *  @param s2 BNJ value containing BNJ_STRING string data.
  *  @param buff buffer containing string data.
  *  @return negative if s1 < s2, 0 is s1 == s2, positive if s1 > s2.
- *  magnitude of return value is first char in str that does not match. */
+ *  magnitude of return value is 1 + index of first char in s1 that does
+ *  not match. */
 int bnj_wcscmp(const wchar_t* s1, const bnj_val* s2, const uint8_t* buff);
 
 #endif
@@ -494,13 +790,69 @@ int bnj_wcscmp(const wchar_t* s1, const bnj_val* s2, const uint8_t* buff);
 	* @return 0 on false, 1 on true. */
 unsigned char bnj_bool(const bnj_val* src);
 
+/** @brief Count of significand digits dropped because SIGNIFICAND overflowed.
+ *  exp_val already accounts for them, so significand_val * 10^exp_val is the
+ *  number with its trailing digits truncated.
+ *  @param src BNJ value containing BNJ_NUMERIC data.
+ *  @return 0 if significand_val and exp_val are exact. */
+unsigned bnj_truncated(const bnj_val* src);
+
+/** @brief bnj_integer results. */
+enum {
+	/** @brief Value is integral and fits. */
+	BNJ_INT_EXACT,
+
+	/** @brief Value has a fractional part. */
+	BNJ_INT_FRACTION,
+
+	/** @brief Magnitude exceeds SIGNIFICAND_MAX, or digits were dropped and
+	 *  the number text is not available. */
+	BNJ_INT_RANGE
+};
+
+/** @brief Extract exact integral magnitude of a number, without floating
+ *  point. Exponents and fractions are fine when the value is integral
+ *  (1e3, 10.0). The sign is BNJ_VFLAG_NEGATIVE_SIGNIFICAND.
+ *  @param src BNJ value containing complete BNJ_NUMERIC data.
+ *  @param buff buffer containing number data, to read digits dropped on
+ *  significand overflow from; see bnj_numtext. May be NULL.
+ *  @param dest Set to magnitude on BNJ_INT_EXACT.
+ *  @return BNJ_INT_EXACT, BNJ_INT_FRACTION or BNJ_INT_RANGE. */
+unsigned bnj_integer(const bnj_val* src, const uint8_t* buff,
+	SIGNIFICAND* dest);
+
+/** @brief Locate exact text of a number, for arbitrary precision handling.
+ *  @param src BNJ value containing BNJ_NUMERIC data.
+ *  @param buff buffer containing number data.
+ *  @param len Set to text length, excluding any '-'. For a value fragment,
+ *  only the part within buff. 0 if the text was not kept across buffers.
+ *  @return Beginning of number text. */
+const uint8_t* bnj_numtext(const bnj_val* src, const uint8_t* buff,
+	unsigned* len);
+
+/** @brief Locate string text that needs no decoding, to use it in place.
+ *  @param src BNJ value containing BNJ_STRING data.
+ *  @param buff buffer containing string data.
+ *  @param len Set to UTF-8 length of the string. For the last fragment of
+ *  a string, only the part within buff.
+ *  @return Beginning of string text. NULL if src is not the last fragment,
+ *  has escapes or starts with a split character; copy with bnj_stpncpy8
+ *  instead. */
+const uint8_t* bnj_strview(const bnj_val* src, const uint8_t* buff,
+	unsigned* len);
+
 #ifdef BNJ_FLOAT_SUPPORT
 
 /** @brief Extract double precision floating point from src.
+ *  Correctly rounded (round to nearest even) without calling libm.
+ *  If bnj_truncated(src), the result is that of the truncated number when
+ *  the dropped digits could change rounding; use bnj_numtext to be exact.
  *  @return src converted to double float value.. */
 double bnj_double(const bnj_val* src);
 
-/** @brief Extract double precision floating point from src.
+/** @brief Extract single precision floating point from src.
+ *  Correctly rounded (round to nearest even) without calling libm.
+ *  Same caveat as bnj_double for truncated numbers.
  *  @return src converted to single float value. */
 float bnj_float(const bnj_val* src);
 
@@ -601,10 +953,27 @@ inline uint8_t* bnj_utf8_char(uint8_t* dst, unsigned len, uint32_t v){
 	return dst;
 }
 
+inline uint16_t* bnj_utf16_char(uint16_t* dst, unsigned len, uint32_t v){
+	/* If not enough space remaining do nothing. */
+	if(v < 0x10000 && len >= 1){
+		dst[0] = v;
+		++dst;
+	}
+	else if(v >= 0x10000 && len >= 2){
+		v -= 0x10000;
+		dst[0] = 0xD800 | (v >> 10);
+		dst[1] = 0xDC00 | (v & 0x3FF);
+		dst += 2;
+	}
+	return dst;
+}
+
 #ifdef BNJ_WCHAR_SUPPORT
 
 inline wchar_t* bnj_wcpcpy(wchar_t* dst, const bnj_val* src, const uint8_t* buff){
-	return bnj_wcpncpy(dst, src, bnj_strlen16(src) + 1, buff);
+	const unsigned len = (sizeof(wchar_t) == sizeof(uint16_t))
+		? bnj_strlen16(src) / 2 : bnj_cpcount(src);
+	return bnj_wcpncpy(dst, src, len + 1, buff);
 }
 
 #endif
@@ -613,42 +982,28 @@ inline unsigned char bnj_bool(const bnj_val* src){
 	return (BNJ_SPC_FALSE == src->significand_val) ? 0 : 1;
 }
 
-#ifdef BNJ_FLOAT_SUPPORT
-inline double bnj_double(const bnj_val* src){
-	if(BNJ_NUMERIC == bnj_val_type(src)){
-		/* First copy integral value. */
-		double dest = src->significand_val;
-
-		/* Scale by exponent. */
-		dest *= pow(10, src->exp_val);
-		dest *= (src->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -1.0 : 1.0;
-		return dest;
-	}
-	else{
-		if(BNJ_SPC_NAN == src->significand_val)
-			return NAN;
-		else
-			return (src->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -INFINITY: INFINITY;
-	}
+inline unsigned bnj_truncated(const bnj_val* src){
+	return src->trunc_count;
 }
 
-inline float bnj_float(const bnj_val* src){
-	if(BNJ_NUMERIC == bnj_val_type(src)){
-		/* First copy integral value. */
-		float dest = src->significand_val;
+inline const uint8_t* bnj_numtext(const bnj_val* src, const uint8_t* buff,
+	unsigned* len)
+{
+	*len = src->num_length;
+	return buff + src->strval_offset;
+}
 
-		/* Scale by exponent. */
-		dest *= powf(10, src->exp_val);
-		dest *= (src->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -1.0 : 1.0;
-		return dest;
-	}
-	else{
-		if(BNJ_SPC_NAN == src->significand_val)
-			return NAN;
-		else
-			return (src->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -INFINITY: INFINITY;
+inline const uint8_t* bnj_strview(const bnj_val* src, const uint8_t* buff,
+	unsigned* len)
+{
+	if((src->type & (BNJ_VFLAG_ESCAPED | BNJ_VFLAG_VAL_FRAGMENT))
+		|| src->significand_val != BNJ_EMPTY_CP)
+	{
+		return NULL;
 	}
+	*len = bnj_strlen8(src);
+	return buff + src->strval_offset;
 }
-#endif
+
 
 #endif
@@ -0,0 +1,234 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#include <cstring>
+#include "filter.hh"
+
+BNJ::RecordFilter::Handler::~Handler() throw(){
+}
+
+void BNJ::RecordFilter::Handler::Begin(void){
+}
+
+BNJ::RecordFilter::RecordFilter(Slot* slots, const char** keys, unsigned len)
+	throw()
+	: _slots(slots), _keys(keys), _len(len), _count(0), _required(0),
+	_predicates(0), _fields(0), _accepted(0), _rejected(0)
+{
+	_level.key_set = _keys;
+	_level.key_set_length = 0;
+	_level.first = 0;
+	_level.last = UINT32_MAX;
+	_projection.levels = &_level;
+	_projection.length = 1;
+	_projection.structural = 0;
+}
+
+const char* BNJ::RecordFilter::Compile(const Predicate* predicates,
+	unsigned predicate_count, char const * const * fields,
+	unsigned field_count) throw()
+{
+	_count = 0;
+	_required = 0;
+	_predicates = 0;
+	_fields = 0;
+	_level.key_set_length = 0;
+
+	const unsigned total = predicate_count + field_count;
+	if(total > _len)
+		return "RecordFilter: out of storage!";
+
+	/* Insert each key in order; the key set must be sorted. */
+	for(unsigned i = 0; i < total; ++i){
+		const Predicate* p = (i < predicate_count) ? predicates + i : NULL;
+		const char* key = p ? p->key : fields[i - predicate_count];
+		if(p && (EQUALS == p->test || PREFIX == p->test) && !p->text){
+			_count = 0;
+			return "EQUALS and PREFIX predicates need text!";
+		}
+
+		unsigned j = 0;
+		while(j < _count && strcmp(_keys[j], key) < 0)
+			++j;
+		if(j < _count && !strcmp(_keys[j], key)){
+			_count = 0;
+			return "Duplicate RecordFilter key!";
+		}
+
+		for(unsigned m = _count; m > j; --m){
+			_keys[m] = _keys[m - 1];
+			_slots[m] = _slots[m - 1];
+		}
+		_keys[j] = key;
+		_slots[j].predicate = p;
+		_slots[j].field = p ? 0 : i - predicate_count;
+		_slots[j].seen = false;
+		++_count;
+
+		if(p && ABSENT != p->test)
+			++_required;
+	}
+
+	_predicates = predicate_count;
+	_fields = field_count;
+	_level.key_set_length = _count;
+	return NULL;
+}
+
+#ifndef BNJ_NO_EXCEPTIONS
+bool BNJ::RecordFilter::Next(PullParser& parser, Handler& handler){
+	const int ret = TryNext(parser, handler);
+	if(ret < 0)
+		parser.ThrowError();
+	return ret;
+}
+#endif
+
+int BNJ::RecordFilter::TryNext(PullParser& parser, Handler& handler){
+	while(true){
+		/* Skip the rest of an earlier record, whether it passed or not. */
+		while(parser.Depth()){
+			if(PullParser::ST_ERROR == parser.TryUp())
+				return -1;
+		}
+
+		PullParser::State s = parser.TryPull();
+		if(PullParser::ST_DOC_END == s)
+			s = parser.TryPull();
+		if(PullParser::ST_ERROR == s)
+			return -1;
+		if(PullParser::ST_NO_DATA == s)
+			return 0;
+
+		int ret;
+		if(PullParser::ST_MAP == s){
+			ret = Check(parser, handler);
+			if(ret < 0)
+				return -1;
+		}
+		else{
+			if(PullParser::ST_ERROR == parser.TrySkip())
+				return -1;
+			ret = !_predicates;
+		}
+
+		if(ret){
+			++_accepted;
+			return 1;
+		}
+		++_rejected;
+	}
+}
+
+int BNJ::RecordFilter::Check(PullParser& parser, Handler& handler){
+	handler.Begin();
+	for(unsigned i = 0; i < _count; ++i)
+		_slots[i].seen = false;
+
+	/* Nothing left to learn once every member required is seen, unless
+	 * fields remain or a member could still be ABSENT's. */
+	const bool settle = !_fields && _required == _predicates;
+	unsigned required = _required;
+	if(settle && !required)
+		return 1;
+
+	while(true){
+		const PullParser::State s = parser.TryPull(_keys, _count);
+		if(PullParser::ST_ERROR == s)
+			return -1;
+
+		/* Left the record. */
+		if(!parser.Depth())
+			return !required;
+
+		const unsigned k = parser.GetValue().key_enum;
+		if(k >= _count){
+			if(PullParser::ST_ERROR == parser.TrySkip())
+				return -1;
+			continue;
+		}
+
+		Slot& slot = _slots[k];
+		if(!slot.predicate){
+			handler.Field(slot.field, parser);
+
+			/* Leave whatever of a map or list handler left unread. */
+			if(PullParser::ST_MAP == s || PullParser::ST_LIST == s){
+				while(parser.Depth() > 1){
+					if(PullParser::ST_ERROR == parser.TryUp())
+						return -1;
+				}
+			}
+			continue;
+		}
+
+		const int holds = Holds(*slot.predicate, parser, s);
+		if(holds <= 0)
+			return holds;
+
+		if(!slot.seen){
+			slot.seen = true;
+			--required;
+			if(settle && !required)
+				return 1;
+		}
+	}
+}
+
+int BNJ::RecordFilter::Holds(const Predicate& p, PullParser& parser,
+	PullParser::State s)
+{
+	switch(p.test){
+		case PRESENT:
+			return (PullParser::ST_ERROR == parser.TrySkip()) ? -1 : 1;
+
+		case ABSENT:
+			return 0;
+
+		case RANGE:
+			{
+				if(PullParser::ST_DATUM != s
+					|| BNJ_NUMERIC != bnj_val_type(&parser.GetValue()))
+				{
+					return 0;
+				}
+				const double d = bnj_double(&parser.GetValue());
+				return d >= p.min && d <= p.max;
+			}
+
+		default:
+			break;
+	}
+
+	/* EQUALS and PREFIX compare chunk by chunk, so a mismatch early in a
+	 * long string stops reading it. */
+	if(PullParser::ST_DATUM != s
+		|| BNJ_STRING != bnj_val_type(&parser.GetValue()))
+	{
+		return 0;
+	}
+
+	const char* t = p.text;
+	char chunk[64];
+	while(true){
+		const int len = parser.TryChunkRead8(chunk, sizeof(chunk));
+		if(len < 0)
+			return -1;
+		if(!len)
+			return !*t;
+
+		int ret = -1;
+		for(int i = 0; i < len; ++i, ++t){
+			if(!*t || chunk[i] != *t){
+				ret = !*t && PREFIX == p.test;
+				break;
+			}
+		}
+		if(ret < 0 && !*t && PREFIX == p.test)
+			ret = 1;
+
+		/* Decided before the end of the string; skip the rest. */
+		if(ret >= 0)
+			return (PullParser::ST_ERROR == parser.TrySkip()) ? -1 : ret;
+	}
+}
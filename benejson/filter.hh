@@ -0,0 +1,200 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#ifndef __BENEGON_JSON_FILTER_HH__
+#define __BENEGON_JSON_FILTER_HH__
+
+#include "pull.hh"
+
+namespace BNJ {
+	/** @brief Selects records of a stream by their top level members.
+	 * Predicates on members are checked as the members are parsed; a record
+	 * is rejected at the first one to fail, and the rest of it is parsed
+	 * without being reported. A record passes when every predicate
+	 * holds, so any predicate but ABSENT also requires its member.
+	 * Records that are not maps pass only if there are no predicates.
+	 *
+	 * Members named as fields go to a Handler; other members are skipped.
+	 * Predicate and field keys together form the key set each member is
+	 * matched against once. Passing Projection() to
+	 * PullParser::SetProjection() keeps the parser from reporting any other
+	 * member at all; but as it then also does not stop at them, it may pass
+	 * over the rest of a record before a predicate rejects it. That pays
+	 * when most records pass.
+	 *
+	 * Keys compare once unescaped, as PullParser key sets do. EQUALS and
+	 * PREFIX compare the unescaped string value.
+	 *
+	 * Storage is caller provided: one Slot and key per predicate and field. */
+	class RecordFilter {
+		public:
+			/** @brief How a predicate tests its member. */
+			enum Test {
+				/** @brief String equal to text. */
+				EQUALS,
+
+				/** @brief String beginning with text. */
+				PREFIX,
+
+				/** @brief Number in [min, max]. */
+				RANGE,
+
+				/** @brief Member present, with any value. */
+				PRESENT,
+
+				/** @brief Member not present. */
+				ABSENT
+			};
+
+			/** @brief Predicate on a top level member. */
+			typedef struct {
+				/** @brief Member key. */
+				const char* key;
+
+				/** @brief Test to apply. */
+				Test test;
+
+				/** @brief For EQUALS and PREFIX. */
+				const char* text;
+
+				/** @brief For RANGE, inclusive bounds. */
+				double min;
+				double max;
+			} Predicate;
+
+			/** @brief Meaning of a key set entry. Filled in by Compile(). */
+			typedef struct {
+				/** @brief Predicate on the key, or NULL if a field. */
+				const Predicate* predicate;
+
+				/** @brief Field index, if a field. */
+				unsigned field;
+
+				/** @brief Whether seen in the current record. */
+				bool seen;
+			} Slot;
+
+			/** @brief Receives the fields of records. */
+			class Handler {
+				public:
+					virtual ~Handler() throw();
+
+					/** @brief Called at the start of each map record.
+					 *  Fields of any earlier record that did not pass may be
+					 *  discarded. */
+					virtual void Begin(void);
+
+					/** @brief Called at a field of the current record, in document
+					 *  order. The record may still fail a predicate on a later member.
+					 *  Parser state is ST_DATUM, ST_MAP or ST_LIST; the value may be
+					 *  read as with PathSet::Handler::Match(). Whatever is left unread
+					 *  is skipped.
+					 *  @param field Index of the field given to Compile().
+					 *  @param parser Parser at the value. */
+					virtual void Field(unsigned field, PullParser& parser) = 0;
+			};
+
+			/** @brief Initialize with storage for compiled predicates and fields.
+			 *  @param slots Key meanings.
+			 *  @param keys Key set; same length as slots.
+			 *  @param len Length of slots and keys. */
+			RecordFilter(Slot* slots, const char** keys, unsigned len) throw();
+
+			/** @brief Compile predicates and fields, replacing any previous ones.
+			 *  @param predicates Predicates; must outlive use of this filter.
+			 *  @param predicate_count Length of predicates.
+			 *  @param fields Keys of fields to report; must outlive use of this
+			 *  filter.
+			 *  @param field_count Length of fields.
+			 *  @return NULL on success; otherwise a static error message. */
+			const char* Compile(const Predicate* predicates,
+				unsigned predicate_count, char const * const * fields,
+				unsigned field_count) throw();
+
+			/** @brief Projection decoding only predicate and field members.
+			 *  Valid until the next Compile(). */
+			const bnj_projection* Projection(void) const throw();
+
+			/** @brief Find the next record that passes.
+			 *  An earlier call's record is finished first, so with
+			 *  SetFraming() each call continues with the next document of the
+			 *  stream.
+			 *  @param parser Parser after Begin*(), or after a previous call.
+			 *  @param handler Receives the fields.
+			 *  @return true if a record passed; false with parser.GetState() ==
+			 *  ST_NO_DATA when no record is left.
+			 *  @throw on parsing errors, as Pull() */
+#ifndef BNJ_NO_EXCEPTIONS
+			bool Next(PullParser& parser, Handler& handler);
+#endif
+
+			/** @brief Next() without exceptions from parsing; exceptions from
+			 *  handler pass through.
+			 *  @return 1 if a record passed, 0 if none left; < 0 on errors, see
+			 *  parser.LastError(). */
+			int TryNext(PullParser& parser, Handler& handler);
+
+			/** @brief Records that passed. */
+			unsigned long long Accepted(void) const throw();
+
+			/** @brief Records that failed. */
+			unsigned long long Rejected(void) const throw();
+
+		private:
+			RecordFilter(const RecordFilter& f);
+			RecordFilter& operator=(const RecordFilter& f);
+
+			/** @brief Check the members of a map record.
+			 *  @return 1 if it passed, 0 if not; < 0 on parsing errors. */
+			int Check(PullParser& parser, Handler& handler);
+
+			/** @brief Apply a predicate to the member the parser is at.
+			 *  Consumes as much of a string as needed to decide.
+			 *  @return 1 if it holds, 0 if not; < 0 on parsing errors. */
+			int Holds(const Predicate& p, PullParser& parser,
+				PullParser::State s);
+
+			/** @brief Key meanings, in key set order. */
+			Slot* _slots;
+
+			/** @brief Sorted key set. */
+			const char** _keys;
+
+			/** @brief Length of _slots and _keys. */
+			unsigned _len;
+
+			/** @brief Keys in use. */
+			unsigned _count;
+
+			/** @brief Predicates a record must satisfy by having the member. */
+			unsigned _required;
+
+			/** @brief Predicates of any kind. */
+			unsigned _predicates;
+
+			/** @brief Fields in the key set. */
+			unsigned _fields;
+
+			/** @brief Projection of the key set onto record members. */
+			bnj_projlevel _level;
+			bnj_projection _projection;
+
+			/** @brief Record counts. */
+			unsigned long long _accepted;
+			unsigned long long _rejected;
+	};
+}
+
+inline const bnj_projection* BNJ::RecordFilter::Projection(void) const throw(){
+	return &_projection;
+}
+
+inline unsigned long long BNJ::RecordFilter::Accepted(void) const throw(){
+	return _accepted;
+}
+
+inline unsigned long long BNJ::RecordFilter::Rejected(void) const throw(){
+	return _rejected;
+}
+
+#endif
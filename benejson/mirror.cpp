@@ -0,0 +1,77 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#include <climits>
+#include <cstdio>
+#include "mirror.hh"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* @return Descriptor of an unnamed shared memory file; -1 on error. */
+static int s_anon_file(void){
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+	return memfd_create("benejson", MFD_CLOEXEC);
+#else
+	/* Name only lives until unlinked. */
+	char name[64];
+	snprintf(name, sizeof(name), "/benejson.%ld.%p", (long)getpid(),
+		(void*)name);
+	const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if(-1 != fd)
+		shm_unlink(name);
+	return fd;
+#endif
+}
+
+BNJ::MirrorBuffer::MirrorBuffer(unsigned len) throw()
+	: _data(NULL), _len(0)
+{
+	const size_t page = sysconf(_SC_PAGESIZE);
+	const size_t size = (len + page - 1) / page * page;
+	if(!size || size > UINT_MAX / 2)
+		return;
+
+	const int fd = s_anon_file();
+	if(-1 == fd)
+		return;
+	if(ftruncate(fd, size)){
+		close(fd);
+		return;
+	}
+
+	/* Reserve room for both halves, then map the file over each half.
+	 * Mappings hold their own references to the file. */
+	uint8_t* base = (uint8_t*)mmap(NULL, 2 * size, PROT_NONE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(MAP_FAILED != base){
+		if(MAP_FAILED == mmap(base, size, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_FIXED, fd, 0)
+			|| MAP_FAILED == mmap(base + size, size, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_FIXED, fd, 0))
+		{
+			munmap(base, 2 * size);
+		}
+		else{
+			_data = base;
+			_len = size;
+		}
+	}
+	close(fd);
+}
+
+BNJ::MirrorBuffer::~MirrorBuffer() throw(){
+	if(_data)
+		munmap(_data, 2 * (size_t)_len);
+}
+#else
+BNJ::MirrorBuffer::MirrorBuffer(unsigned len) throw()
+	: _data(NULL), _len(0)
+{
+}
+
+BNJ::MirrorBuffer::~MirrorBuffer() throw(){
+}
+#endif
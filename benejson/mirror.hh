@@ -0,0 +1,53 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#ifndef __BENEGON_JSON_MIRROR_HH__
+#define __BENEGON_JSON_MIRROR_HH__
+
+#include <stdint.h>
+
+namespace BNJ {
+	/** @brief Ring buffer mapped twice, back to back.
+	 * Byte i + Length() aliases byte i, so data wrapping around the end of the
+	 * ring reads as contiguous. Give to PullParser::BeginMirrored() so key and
+	 * number fragments never move to the buffer start.
+	 *
+	 * Backed by an anonymous shared memory file. Not available on Windows. */
+	class MirrorBuffer {
+		public:
+			/** @brief Map a ring of at least len bytes.
+			 *  @param len Minimum ring size; rounded up to whole pages, so check
+			 *  Length() against BUFF_OFFSET_MAX.
+			 *  On failure, Data() is NULL. */
+			explicit MirrorBuffer(unsigned len) throw();
+
+			/** @brief Unmap both halves. */
+			~MirrorBuffer() throw();
+
+			/** @brief Start of the first mapping; NULL if mapping failed. */
+			uint8_t* Data(void) const throw();
+
+			/** @brief Size of one mapping; 0 if mapping failed. */
+			unsigned Length(void) const throw();
+
+		private:
+			MirrorBuffer(const MirrorBuffer& m);
+			MirrorBuffer& operator=(const MirrorBuffer& m);
+
+			/** @brief Start of the first mapping. */
+			uint8_t* _data;
+
+			/** @brief Size of one mapping. */
+			unsigned _len;
+	};
+}
+
+inline uint8_t* BNJ::MirrorBuffer::Data(void) const throw(){
+	return _data;
+}
+
+inline unsigned BNJ::MirrorBuffer::Length(void) const throw(){
+	return _len;
+}
+
+#endif
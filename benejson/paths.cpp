@@ -0,0 +1,302 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#include <cstring>
+#include "paths.hh"
+
+BNJ::PathSet::Handler::~Handler() throw(){
+}
+
+void BNJ::PathSet::StorageSize(char const * const * pointers, unsigned count,
+	unsigned& nodes, unsigned& text) throw()
+{
+	/* Root plus one node per segment. Unescaped segments with their
+	 * terminators take no more than the pointer text. */
+	nodes = 1;
+	text = 0;
+	for(unsigned i = 0; i < count; ++i){
+		for(const char* c = pointers[i]; *c; ++c){
+			if('/' == *c)
+				++nodes;
+			++text;
+		}
+	}
+}
+
+BNJ::PathSet::PathSet(Node* nodes, const char** keys, unsigned node_len,
+	char* text, unsigned text_len) throw()
+	: _nodes(nodes), _keys(keys), _node_len(node_len), _node_count(0),
+	_text(text), _text_len(text_len)
+{
+}
+
+/* @return Array index segment key denotes, or NO_INDEX. */
+static unsigned s_index(const char* key){
+	/* Only canonical decimal; no sign or leading zeros. */
+	if(!key[0])
+		return BNJ::PathSet::NO_INDEX;
+	if('0' == key[0])
+		return key[1] ? BNJ::PathSet::NO_INDEX : 0;
+
+	unsigned ret = 0;
+	for(const char* c = key; *c; ++c){
+		if(*c < '0' || *c > '9')
+			return BNJ::PathSet::NO_INDEX;
+		const unsigned d = *c - '0';
+		if(ret > (BNJ::PathSet::NO_INDEX - 1 - d) / 10)
+			return BNJ::PathSet::NO_INDEX;
+		ret = ret * 10 + d;
+	}
+	return ret;
+}
+
+/* Make n a node with no children or pointers. */
+static void s_leaf(BNJ::PathSet::Node& n, const char* key, unsigned parent){
+	n.key = key;
+	n.index = key ? s_index(key) : BNJ::PathSet::NO_INDEX;
+	n.path = BNJ::PathSet::NO_PATH;
+	n.parent = parent;
+	n.first = 0;
+	n.count = 0;
+	n.pending = 0;
+	n.left = 0;
+	n.visited = false;
+	n.child = 0;
+	n.sibling = 0;
+}
+
+const char* BNJ::PathSet::Compile(char const * const * pointers,
+	unsigned count) throw()
+{
+	_node_count = 0;
+	if(!_node_len)
+		return "PathSet: out of node storage!";
+	s_leaf(_nodes[0], NULL, 0);
+	_node_count = 1;
+
+	/* Build the trie with sorted sibling lists. Node 0 is the root, so 0 also
+	 * ends child and sibling links. */
+	const char* err = NULL;
+	unsigned t = 0;
+	for(unsigned i = 0; i < count && !err; ++i){
+		const char* c = pointers[i];
+		if(*c && '/' != *c){
+			err = "JSON Pointer must start with '/'!";
+			break;
+		}
+
+		unsigned n = 0;
+		while(*c && !err){
+			/* Unescape segment after '/'. */
+			++c;
+			char* key = _text + t;
+			while(*c && '/' != *c){
+				char ch = *c++;
+				if('~' == ch){
+					if('0' == *c)
+						ch = '~';
+					else if('1' == *c)
+						ch = '/';
+					else{
+						err = "JSON Pointer has bad '~' escape!";
+						break;
+					}
+					++c;
+				}
+				if(t == _text_len){
+					err = "PathSet: out of text storage!";
+					break;
+				}
+				_text[t++] = ch;
+			}
+			if(err)
+				break;
+			if(t == _text_len){
+				err = "PathSet: out of text storage!";
+				break;
+			}
+			_text[t++] = '\0';
+
+			/* Find the segment among children, or insert it in order. */
+			unsigned* link = &_nodes[n].child;
+			int cmp = 1;
+			while(*link){
+				cmp = strcmp(_nodes[*link].key, key);
+				if(cmp >= 0)
+					break;
+				link = &_nodes[*link].sibling;
+			}
+			if(*link && !cmp){
+				/* Already have it; reuse the text. */
+				t = key - _text;
+				n = *link;
+				continue;
+			}
+
+			if(_node_count == _node_len){
+				err = "PathSet: out of node storage!";
+				break;
+			}
+			s_leaf(_nodes[_node_count], key, n);
+			_nodes[_node_count].sibling = *link;
+			*link = _node_count;
+			n = _node_count++;
+		}
+		if(err)
+			break;
+
+		if(NO_PATH != _nodes[n].path){
+			err = "Duplicate JSON Pointer!";
+			break;
+		}
+		_nodes[n].path = i;
+		for(unsigned m = n; ; m = _nodes[m].parent){
+			++_nodes[m].pending;
+			if(!m)
+				break;
+		}
+	}
+
+	if(err){
+		/* Leave an empty set. */
+		s_leaf(_nodes[0], NULL, 0);
+		_node_count = 1;
+		return err;
+	}
+
+	/* Lay nodes out breadth first, so the keys of each node's children are
+	 * contiguous and sorted; they are its key set. */
+	_nodes[0].order = 0;
+	unsigned tail = 1;
+	for(unsigned head = 0; head < tail; ++head){
+		Node& p = _nodes[_nodes[head].order];
+		p.first = tail;
+		for(unsigned c = p.child; c; c = _nodes[c].sibling){
+			_nodes[tail].order = c;
+			_keys[tail] = _nodes[c].key;
+			++tail;
+			++p.count;
+		}
+	}
+	return NULL;
+}
+
+#ifndef BNJ_NO_EXCEPTIONS
+unsigned BNJ::PathSet::Extract(PullParser& parser, Handler& handler){
+	const int ret = TryExtract(parser, handler);
+	if(ret < 0)
+		parser.ThrowError();
+	return ret;
+}
+#endif
+
+int BNJ::PathSet::TryExtract(PullParser& parser, Handler& handler){
+	/* Finish the document an earlier call left early. */
+	while(parser.Depth()){
+		if(PullParser::ST_ERROR == parser.TryUp())
+			return -1;
+	}
+
+	PullParser::State s = parser.TryPull();
+	if(PullParser::ST_DOC_END == s)
+		s = parser.TryPull();
+	if(PullParser::ST_ERROR == s)
+		return -1;
+	if(PullParser::ST_NO_DATA == s)
+		return 0;
+
+	if(!_node_count)
+		return PullParser::ST_ERROR == parser.TrySkip() ? -1 : 0;
+
+	for(unsigned i = 0; i < _node_count; ++i){
+		_nodes[i].left = _nodes[i].pending;
+		_nodes[i].visited = false;
+	}
+	if(!Visit(parser, handler, 0, s))
+		return -1;
+	return _nodes[0].pending - _nodes[0].left;
+}
+
+bool BNJ::PathSet::Visit(PullParser& parser, Handler& handler, unsigned n,
+	PullParser::State s)
+{
+	const Node& node = _nodes[n];
+	const bool container =
+		PullParser::ST_MAP == s || PullParser::ST_LIST == s;
+	const unsigned depth = parser.Depth();
+	_nodes[n].visited = true;
+
+	if(NO_PATH != node.path){
+		handler.Match(node.path, parser);
+		for(unsigned m = n; ; m = _nodes[m].parent){
+			--_nodes[m].left;
+			if(!m)
+				break;
+		}
+
+		/* Skip whatever of a matched container handler left unread, unless
+		 * that would pass other paths still to find. */
+		if(!node.count || !node.left){
+			if(!container || !_nodes[0].left)
+				return true;
+			while(parser.Depth() >= depth){
+				if(PullParser::ST_ERROR == parser.TryUp())
+					return false;
+			}
+			return true;
+		}
+	}
+
+	/* No paths continue through scalars. */
+	if(!container)
+		return true;
+	if(!node.left)
+		return PullParser::ST_ERROR != parser.TryUp();
+
+	/* Key set for maps; array indices count elements. */
+	char const * const * key_set =
+		PullParser::ST_MAP == s ? _keys + node.first : NULL;
+	const unsigned key_set_length = key_set ? node.count : 0;
+	unsigned index = 0;
+	while(true){
+		const PullParser::State c = parser.TryPull(key_set, key_set_length);
+		if(PullParser::ST_ERROR == c)
+			return false;
+
+		/* Left the container. */
+		if(parser.Depth() < depth)
+			return true;
+
+		unsigned child = 0;
+		if(key_set){
+			const unsigned k = parser.GetValue().key_enum;
+			if(k < node.count)
+				child = _nodes[node.first + k].order;
+		}
+		else{
+			for(unsigned k = node.first; k < node.first + node.count; ++k){
+				if(_nodes[_nodes[k].order].index == index){
+					child = _nodes[k].order;
+					break;
+				}
+			}
+			++index;
+		}
+
+		/* Only the first of duplicate keys is searched. */
+		if(child && !_nodes[child].visited && _nodes[child].left){
+			if(!Visit(parser, handler, child, c))
+				return false;
+		}
+		else if(PullParser::ST_ERROR == parser.TrySkip()){
+			return false;
+		}
+
+		/* Nothing left to find below; stay put if nothing left at all. */
+		if(!node.left){
+			if(!_nodes[0].left)
+				return true;
+			return PullParser::ST_ERROR != parser.TryUp();
+		}
+	}
+}
@@ -0,0 +1,158 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#ifndef __BENEGON_JSON_PATHS_HH__
+#define __BENEGON_JSON_PATHS_HH__
+
+#include "pull.hh"
+
+namespace BNJ {
+	/** @brief Set of JSON Pointers (RFC 6901) extracted in one pass.
+	 * Pointers compile into a trie. The keys below each map node become the
+	 * PullParser key set while that map is pulled, so each key costs one
+	 * match. Containers on no path are skipped without parsing their
+	 * contents, and a container is left as soon as every path below it was
+	 * found.
+	 *
+	 * Map keys compare once unescaped, as PullParser key sets do. Of
+	 * duplicate keys in a map only the first is searched. Array indices are
+	 * canonical decimal and match only existing elements; "-" and indices
+	 * such as "01" never match an array, only map keys.
+	 *
+	 * Storage is caller provided; see StorageSize(). */
+	class PathSet {
+		public:
+			/** @brief Trie node. Filled in by Compile(). */
+			typedef struct {
+				/** @brief Unescaped segment leading here; NULL for the root. */
+				const char* key;
+
+				/** @brief Array index segment leading here, or NO_INDEX. */
+				unsigned index;
+
+				/** @brief Pointer ending here, or NO_PATH. */
+				unsigned path;
+
+				/** @brief Parent node. */
+				unsigned parent;
+
+				/** @brief Children occupy order[first, first + count). */
+				unsigned first;
+				unsigned count;
+
+				/** @brief Pointers ending here or below. */
+				unsigned pending;
+
+				/** @brief Of those, not yet found in this document. */
+				unsigned left;
+
+				/** @brief Whether reached in this document. */
+				bool visited;
+
+				/** @brief Node in this slot of breadth first order. */
+				unsigned order;
+
+				/** @brief Build time first child and next sibling. */
+				unsigned child;
+				unsigned sibling;
+			} Node;
+
+			enum {
+				/** @brief Segment is not an array index. */
+				NO_INDEX = 0xFFFFFFFF,
+
+				/** @brief No pointer ends at node. */
+				NO_PATH = 0xFFFFFFFF
+			};
+
+			/** @brief Receives values found at paths. */
+			class Handler {
+				public:
+					virtual ~Handler() throw();
+
+					/** @brief Called at the value of a path, in document order.
+					 *  Parser state is ST_DATUM, ST_MAP or ST_LIST. The value may be
+					 *  read with GetValue(), Get() or ChunkRead*(). A map or list may
+					 *  be read with Pull() unless other paths lie below it; whatever
+					 *  is left unread is skipped.
+					 *  @param path Index of the pointer given to Compile().
+					 *  @param parser Parser at the value. */
+					virtual void Match(unsigned path, PullParser& parser) = 0;
+			};
+
+			/** @brief Storage Compile() needs.
+			 *  @param pointers JSON Pointers.
+			 *  @param count Length of pointers.
+			 *  @param nodes Set to entries needed in nodes and keys.
+			 *  @param text Set to bytes needed in text. */
+			static void StorageSize(char const * const * pointers, unsigned count,
+				unsigned& nodes, unsigned& text) throw();
+
+			/** @brief Initialize with storage for compiled pointers.
+			 *  @param nodes Trie nodes.
+			 *  @param keys Key sets; same length as nodes.
+			 *  @param node_len Length of nodes and keys.
+			 *  @param text Unescaped segments.
+			 *  @param text_len Length of text. */
+			PathSet(Node* nodes, const char** keys, unsigned node_len, char* text,
+				unsigned text_len) throw();
+
+			/** @brief Compile JSON Pointers, replacing any previous set.
+			 *  "" is the whole document; otherwise each segment follows a '/',
+			 *  with "~0" for '~' and "~1" for '/'.
+			 *  @param pointers JSON Pointers; need not outlive this call.
+			 *  @param count Length of pointers.
+			 *  @return NULL on success; otherwise a static error message. */
+			const char* Compile(char const * const * pointers, unsigned count)
+				throw();
+
+			/** @brief Find the paths in the next document.
+			 *  Pulls the document's value, then returns once every path was
+			 *  found or the document ended. An earlier call's document is
+			 *  finished first, so with SetFraming() each call handles the next
+			 *  document of the stream.
+			 *  @param parser Parser after Begin*(), or after a previous call.
+			 *  @param handler Receives the values.
+			 *  @return Paths found. 0 with parser.GetState() == ST_NO_DATA
+			 *  when no document is left.
+			 *  @throw on parsing errors, as Pull() */
+#ifndef BNJ_NO_EXCEPTIONS
+			unsigned Extract(PullParser& parser, Handler& handler);
+#endif
+
+			/** @brief Extract() without exceptions from parsing; exceptions
+			 *  from handler pass through.
+			 *  @return Paths found; < 0 on errors, see parser.LastError(). */
+			int TryExtract(PullParser& parser, Handler& handler);
+
+		private:
+			PathSet(const PathSet& p);
+			PathSet& operator=(const PathSet& p);
+
+			/** @brief Find paths at and below node n.
+			 *  @param s Parser state at the value of node n.
+			 *  @return false on parsing errors. */
+			bool Visit(PullParser& parser, Handler& handler, unsigned n,
+				PullParser::State s);
+
+			/** @brief Trie nodes; node 0 is the root. */
+			Node* _nodes;
+
+			/** @brief Child keys in breadth first order; key sets of nodes. */
+			const char** _keys;
+
+			/** @brief Length of _nodes and _keys. */
+			unsigned _node_len;
+
+			/** @brief Nodes in use. */
+			unsigned _node_count;
+
+			/** @brief Unescaped segment storage. */
+			char* _text;
+
+			/** @brief Length of _text. */
+			unsigned _text_len;
+	};
+}
+
+#endif
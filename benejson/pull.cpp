@@ -2,32 +2,46 @@
  * See the file LICENSE for full license information. */
 
 #include <climits>
+#include <limits>
 #include <assert.h>
 #include "pull.hh"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Released pages are dropped in steps of at least this many bytes. */
+#define BNJ_MAP_RELEASE_STEP (1 << 22)
+#endif
+
+/* Most of an in place buffer parsed at once; BUFF_OFFSET must reach
+ * across it. */
+#define BNJ_WINDOW \
+	((BUFF_OFFSET_MAX < (1u << 30)) ? BUFF_OFFSET_MAX : (1u << 30))
+
 /* For those of you without stpcpy... */
 static char* bnj_local_stpcpy(char* dest, const char* src){
-	do{
-		*dest = *src;
+	while((*dest = *src)){
 		++dest;
 		++src;
-	}while(*src);
+	}
 
-	return dest - 1;
+	return dest;
 }
 
 #ifndef stpcpy
 	#define stpcpy(x,y) bnj_local_stpcpy(x,y)
 #endif
  
+/* Unlike stpncpy, does not pad dest; callers terminate it. */
 static char* bnj_local_stpncpy(char* dest, const char* src, size_t count){
 	const char* dend = dest + count;
-	while(dend != dest){
+	while(dend != dest && *src){
 		*dest = *src;
 		++dest;
 		++src;
-		if(!*src)
-			return dest - 1;
 	}
 
 	return dest;
@@ -78,37 +92,42 @@ static const char* s_type_strings[] = {
 	"string"
 };
 
-static void s_throw_key_error(const BNJ::PullParser& p, unsigned key_enum){
-	const bnj_val& val = p.GetValue();
-	char buffer[1024];
-	char* x;
-	x = stpcpy(buffer, "Key mismatch: expected ");
-	x = stpcpy(x, p.c_ctx().key_set[key_enum]);
-	x = stpcpy(x, ", found ");
-	bnj_stpkeycpy(x, &val, p.Buff());
-	throw BNJ::PullParser::input_error(buffer, p.FileOffset(val));
+static const char* s_no_value = "No valid parser value!";
+
+/* Verify there is a current value with the expected key; record otherwise. */
+static BNJ::PullParser::Error s_check_key(const BNJ::PullParser& p,
+	unsigned key_enum)
+{
+	if(!p.ValidValue())
+		return p.SetError(BNJ::PullParser::ERR_NO_VALUE, s_no_value);
+	if(key_enum != 0xFFFFFFFF && p.GetValue().key_enum != key_enum)
+		return p.SetError(BNJ::PullParser::ERR_KEY, NULL, key_enum);
+	return BNJ::PullParser::ERR_NONE;
 }
 
-static void s_throw_type_error(const BNJ::PullParser& p, unsigned type){
-	const bnj_val& val = p.GetValue();
-	char buffer[1024];
-	char* x;
-	x = stpcpy(buffer, "Type mismatch: expected ");
-	x = stpcpy(x, s_type_strings[type]);
-	x = stpcpy(x, ", got ");
-	x = stpcpy(x, s_type_strings[val.type & BNJ_TYPE_MASK]);
-	throw BNJ::PullParser::input_error(buffer, p.FileOffset(val));
+/* Copy message into dest, truncating to destlen. */
+static unsigned s_copy_msg(char* dest, unsigned destlen, const char* msg){
+	unsigned len = strlen(msg);
+	if(len >= destlen)
+		len = destlen - 1;
+	memcpy(dest, msg, len);
+	dest[len] = '\0';
+	return len;
 }
 
-static char* s_compose_9(char* out, unsigned number){
-	/* Write 0-padded 9-digit number. */
-	*out = '@';
-	for(char* y = out + 9; y != out; --y){
-		*y = '0' + (number % 10);
+static char* s_compose_offset(char* out, STREAM_OFFSET number){
+	/* Write number 0-padded to at least 9 digits. */
+	char digits[20];
+	unsigned n = 0;
+	do{
+		digits[n++] = '0' + (number % 10);
 		number /= 10;
-	}
+	} while(number || n < 9);
 
-	out += 10;
+	*out = '@';
+	++out;
+	while(n)
+		*(out++) = digits[--n];
 	*out = ':';
 	++out;
 
@@ -119,9 +138,9 @@ BNJ::PullParser::Reader::~Reader() throw(){
 }
 
 BNJ::PullParser::input_error::input_error(const char* blurb,
-	unsigned file_offset)
+	STREAM_OFFSET file_offset)
 {
-	char* x = s_compose_9(_msg, file_offset);
+	char* x = s_compose_offset(_msg, file_offset);
 
 	/* Copy as many bytes of blurb as possible. */
 	x = stpncpy(x, blurb, 127 - (x - _msg));
@@ -132,10 +151,10 @@ BNJ::PullParser::invalid_value::invalid_value(const char* blurb,
 	const PullParser& p)
 {
 	if(p.ValidValue()){
-		const bnj_val& val = p.GetValue();
+		const bnj_val& val = p._valbuff[p._val_idx];
 
 		/* Reserve 1 char in buff for '\0', and 1 for ' ' */
-		char* x = s_compose_9(_msg, p.FileOffset(val));
+		char* x = s_compose_offset(_msg, p.FileOffset(val));
 
 		/* Copy key value if necessary. */
 		if(val.key_length){
@@ -151,7 +170,7 @@ BNJ::PullParser::invalid_value::invalid_value(const char* blurb,
 	}
 	else {
 		/* FIXME taking a guess here as to the offset. */
-		char* x = s_compose_9(_msg, p.TotalParsed());
+		char* x = s_compose_offset(_msg, p.TotalParsed());
 		x = stpncpy(x, blurb, 254 - (x - _msg));
 		*x = '\0';
 	}
@@ -159,157 +178,621 @@ BNJ::PullParser::invalid_value::invalid_value(const char* blurb,
 
 /* Only initialize the read state here to NULL values. */
 BNJ::PullParser::PullParser(unsigned maxdepth, uint32_t* stack_space)
-	: _parser_state(ST_NO_DATA), _buffer(NULL), _data(NULL), _len(0), _reader(NULL)
+	: PullParser(maxdepth, stack_space, 4, _default_batch)
+{
+}
+
+BNJ::PullParser::PullParser(unsigned maxdepth, uint32_t* stack_space,
+	unsigned batch, bnj_val* batch_space)
+	: _valbuff(batch_space), _batch(batch), _val_idx(0), _val_len(0),
+	_parser_state(ST_NO_DATA), _buffer(NULL), _data(NULL), _len(0),
+	_end(NULL), _reader(NULL), _padded(false), _mirrored(false),
+	_framing(FRAME_NONE), _doc_start(false), _map(NULL), _map_len(0),
+	_released(0), _total_parsed(0), _total_pulled(0), _fragments(0),
+	_compacted(0), _documents(0), _err(ERR_NONE),
+	_err_blurb(NULL), _err_expected(0), _err_offset(0)
 {
 	/* Will not operate with a callback. */
 	_ctx.user_cb = NULL;
 	_ctx.key_set = NULL;
 	_ctx.key_set_length = 0;
+	_ctx.key_matcher = NULL;
+	_ctx.projection = NULL;
 
 	/* Allocate the state stack. */
 	bnj_state_init(&_pstate, stack_space, maxdepth);
 }
 
 BNJ::PullParser::~PullParser(){
+	Unmap();
 }
 
-unsigned BNJ::PullParser::ChunkRead8(char* dest, unsigned destlen,
-	unsigned key_enum)
+/* Per code unit type string functions for ChunkRead(). */
+
+static inline unsigned s_units(const bnj_val* v, const uint8_t*){
+	return bnj_strlen8(v);
+}
+
+static inline unsigned s_units(const bnj_val* v, const uint16_t*){
+	return bnj_strlen16(v) / 2;
+}
+
+static inline unsigned s_units(const bnj_val* v, const uint32_t*){
+	return bnj_cpcount(v);
+}
+
+static inline uint8_t* s_stpncpy(uint8_t* dst, const bnj_val* src, size_t len,
+	const uint8_t* buff)
+{
+	return bnj_stpncpy8(dst, src, len, buff);
+}
+
+static inline uint16_t* s_stpncpy(uint16_t* dst, const bnj_val* src,
+	size_t len, const uint8_t* buff)
+{
+	return bnj_stpncpy16(dst, src, len, buff);
+}
+
+static inline uint32_t* s_stpncpy(uint32_t* dst, const bnj_val* src,
+	size_t len, const uint8_t* buff)
+{
+	return bnj_stpncpy32(dst, src, len, buff);
+}
+
+static inline uint8_t* s_char(uint8_t* dst, unsigned len, uint32_t cp){
+	return bnj_utf8_char(dst, len, cp);
+}
+
+static inline uint16_t* s_char(uint16_t* dst, unsigned len, uint32_t cp){
+	return bnj_utf16_char(dst, len, cp);
+}
+
+static inline uint32_t* s_char(uint32_t* dst, unsigned len, uint32_t cp){
+	if(len)
+		*(dst++) = cp;
+	return dst;
+}
+
+static inline uint8_t* s_json2utf(uint8_t* dst, size_t destlen,
+	const uint8_t** buff)
+{
+	return bnj_json2utf8(dst, destlen, buff);
+}
+
+static inline uint16_t* s_json2utf(uint16_t* dst, size_t destlen,
+	const uint8_t** buff)
+{
+	return bnj_json2utf16(dst, destlen, buff);
+}
+
+static inline uint32_t* s_json2utf(uint32_t* dst, size_t destlen,
+	const uint8_t** buff)
 {
-	if(_val_idx >= _val_len)
-		throw input_error("No chunk string data!", _total_pulled);
+	return bnj_json2utf32(dst, destlen, buff);
+}
 
-	/* out will always point to first empty char. */
-	uint8_t* out = (uint8_t*)dest;
+template<typename T>
+int BNJ::PullParser::ChunkRead(T* dest, unsigned destlen, unsigned key_enum){
+	if(_val_idx >= _val_len){
+		SetError(ERR_NO_VALUE, "No chunk string data!");
+		return -1;
+	}
+
+	/* out will always point to first empty unit. */
+	T* out = dest;
 	unsigned out_remaining = destlen;
 	bnj_val& val = _valbuff[_val_idx];
 
 	/* Verify enum and type. */
-	if(key_enum != 0xFFFFFFFF && val.key_enum != key_enum)
-		s_throw_key_error(*this, key_enum);
-	if(bnj_val_type(&val) != BNJ_STRING)
-		s_throw_type_error(*this, BNJ_STRING);
+	if(key_enum != 0xFFFFFFFF && val.key_enum != key_enum){
+		SetError(ERR_KEY, NULL, key_enum);
+		return -1;
+	}
+	if(bnj_val_type(&val) != BNJ_STRING){
+		SetError(ERR_TYPE, NULL, BNJ_STRING);
+		return -1;
+	}
 
-	while(out_remaining > _utf8_remaining || !dest){
+	/* Count the fragment in T units on first read. */
+	if(_chunk_width != sizeof(T)){
+		_chunk_remaining = s_units(&val, dest);
+		_chunk_width = sizeof(T);
+	}
+
+	while(out_remaining > _chunk_remaining || !dest){
 		bnj_val& val = _valbuff[_val_idx];
 		bool completed = !bnj_incomplete(&_pstate, &val);
 
 		/* Can fit entire string fragment in destination. */
 		if(dest)
-			out = bnj_stpncpy8(out, &val, _utf8_remaining + 1, Buff());
-		_utf8_remaining = 0;
+			out = s_stpncpy(out, &val, _chunk_remaining + 1, Buff());
+		_chunk_remaining = 0;
 
 		/* If value is not a fragment, then have read the whole value. */
 		if(completed)
-			return out - (uint8_t*)dest;
+			return out - dest;
 
-		/* Decrement out_remaining bytes, but add back in null terminator. */
-		out_remaining = destlen - (out - (uint8_t*)dest) + 1;
+		/* Units left, out's null terminator included. */
+		out_remaining = destlen - (out - dest);
 
 		/* Just finished reading data from fragment, so must be at end
 		 * of unparsed data. Refill the entire buffer. */
-		FillBuffer(_len);
+		if(!FillBuffer())
+			return -1;
 
 		/* Pull will do the work of updating the buffer here.
 		 * Jump directly to PARSE_ST so Pull() will not jump back here! */
 		_state = PARSE_ST;
-		State s = Pull(_ctx.key_set, _ctx.key_set_length);
+		State s = PullNext();
+		if(ST_ERROR == s)
+			return -1;
 		assert(ST_DATUM == s);
+		_chunk_remaining = s_units(&_valbuff[_val_idx], dest);
+		_chunk_width = sizeof(T);
 	}
 
 	/* Save room for null terminator. */
 	--out_remaining;
 
+	/* Refilling may have moved the string to another value slot. */
+	bnj_val& rest = _valbuff[_val_idx];
+
 	/* Copy fragmented char if applicable. */
-	if(val.significand_val != BNJ_EMPTY_CP){
-		out = bnj_utf8_char((uint8_t*)dest, out_remaining,
-			(uint32_t)val.significand_val);
-		if((uint8_t*)dest != out){
-			unsigned written = out - (uint8_t*)dest;
+	if(rest.significand_val != BNJ_EMPTY_CP){
+		T* cp_end = s_char(out, out_remaining, (uint32_t)rest.significand_val);
+		if(cp_end != out){
+			unsigned written = cp_end - out;
+			out = cp_end;
 			out_remaining -= written;
-			_utf8_remaining -= written;
+			_chunk_remaining -= written;
+			rest.significand_val = BNJ_EMPTY_CP;
 		}
 		else{
-			*out = '\0';
-			return out - (uint8_t*)dest;
+			*out = 0;
+			return out - dest;
 		}
 	}
 
 	/* Only copy up to minimum of len and content length. */
-	const uint8_t* x = Buff() + val.strval_offset;
+	const uint8_t* x = Buff() + rest.strval_offset;
 	const uint8_t* b = x;
-	uint8_t* res = bnj_json2utf8(out, out_remaining, &b);
+	T* res = s_json2utf(out, out_remaining, &b);
+
+	/* Next chunk continues where this one ended. Other values in the batch
+	 * still locate their data from Buff(). */
+	rest.strval_offset += b - x;
+	_chunk_remaining -= res - out;
+
+	/* Return number of units written to output. */
+	return res - dest;
+}
+
+int BNJ::PullParser::TryChunkRead8(char* dest, unsigned destlen,
+	unsigned key_enum) throw()
+{
+	return ChunkRead((uint8_t*)dest, destlen, key_enum);
+}
+
+int BNJ::PullParser::TryChunkRead16(uint16_t* dest, unsigned destlen,
+	unsigned key_enum) throw()
+{
+	return ChunkRead(dest, destlen, key_enum);
+}
+
+int BNJ::PullParser::TryChunkRead32(uint32_t* dest, unsigned destlen,
+	unsigned key_enum) throw()
+{
+	return ChunkRead(dest, destlen, key_enum);
+}
+
+const char* BNJ::PullParser::TryGetStringView(unsigned& len, char* dest,
+	unsigned destlen, unsigned key_enum) throw()
+{
+	if(_val_idx >= _val_len){
+		SetError(ERR_NO_VALUE, "No string data!");
+		return NULL;
+	}
+
+	const bnj_val& val = _valbuff[_val_idx];
+
+	/* Verify enum and type. */
+	if(key_enum != 0xFFFFFFFF && val.key_enum != key_enum){
+		SetError(ERR_KEY, NULL, key_enum);
+		return NULL;
+	}
+	if(bnj_val_type(&val) != BNJ_STRING){
+		SetError(ERR_TYPE, NULL, BNJ_STRING);
+		return NULL;
+	}
+
+	/* Use the string in place, unless ChunkRead*() already consumed some. */
+	const uint8_t* view = bnj_strview(&val, Buff(), &len);
+	if(view && !_chunk_width)
+		return (const char*)view;
+
+	if(!dest || !destlen){
+		SetError(ERR_LENGTH, "String needs a copy!");
+		return NULL;
+	}
+
+	/* Copy the rest of the string; ChunkRead8() stops early if dest fills. */
+	len = 0;
+	int n;
+	while((n = ChunkRead((uint8_t*)dest + len, destlen - len, 0xFFFFFFFF)) > 0)
+		len += n;
+	if(n < 0)
+		return NULL;
+	const bnj_val& last = _valbuff[_val_idx];
+	if(_chunk_remaining || bnj_incomplete(&_pstate, &last)){
+		SetError(ERR_LENGTH, "String overlong!");
+		return NULL;
+	}
+	return dest;
+}
 
-	/* Update bytes remaining in the input buffer. */
-	_offset += b - x;
-	_utf8_remaining -= res - out;
-	
-	/* Return number of bytes written to output. */
-	return res - (uint8_t*)dest;
+#ifndef BNJ_NO_EXCEPTIONS
+unsigned BNJ::PullParser::ChunkRead8(char* dest, unsigned destlen,
+	unsigned key_enum)
+{
+	const int ret = TryChunkRead8(dest, destlen, key_enum);
+	if(ret < 0)
+		ThrowError();
+	return ret;
+}
+
+unsigned BNJ::PullParser::ChunkRead16(uint16_t* dest, unsigned destlen,
+	unsigned key_enum)
+{
+	const int ret = TryChunkRead16(dest, destlen, key_enum);
+	if(ret < 0)
+		ThrowError();
+	return ret;
+}
+
+unsigned BNJ::PullParser::ChunkRead32(uint32_t* dest, unsigned destlen,
+	unsigned key_enum)
+{
+	const int ret = TryChunkRead32(dest, destlen, key_enum);
+	if(ret < 0)
+		ThrowError();
+	return ret;
 }
 
-void BNJ::PullParser::Begin(uint8_t* buffer, unsigned len, Reader* reader) throw(){
+const char* BNJ::PullParser::GetStringView(unsigned& len, char* dest,
+	unsigned destlen, unsigned key_enum)
+{
+	const char* ret = TryGetStringView(len, dest, destlen, key_enum);
+	if(!ret)
+		ThrowError();
+	return ret;
+}
+#endif
+
+#ifndef BNJ_NO_EXCEPTIONS
+void BNJ::PullParser::Begin(uint8_t* buffer, unsigned len, Reader* reader){
+	if(TryBegin(buffer, len, reader))
+		ThrowError();
+}
+
+void BNJ::PullParser::BeginMirrored(uint8_t* buffer, unsigned len,
+	Reader* reader)
+{
+	if(TryBeginMirrored(buffer, len, reader))
+		ThrowError();
+}
+#endif
+
+BNJ::PullParser::Error BNJ::PullParser::TryBegin(uint8_t* buffer,
+	unsigned len, Reader* reader) throw()
+{
+	Reset();
 	_buffer = buffer;
 	_data = _buffer;
 	_len = len;
 	_reader = reader;
 
-	/* Reset state. */
-	_depth = 0;
-	_val_idx = 0;
-	_val_len = 0;
-	_utf8_remaining = 0;
-	_total_parsed = 0;
-	_total_pulled = 0;
+	/* Offsets into the buffer must fit BUFF_OFFSET. */
+	if(len > BUFF_OFFSET_MAX){
+		Abort(ERR_LENGTH, "PullParser::Begin buffer exceeds BUFF_OFFSET_MAX.");
+		return ERR_LENGTH;
+	}
+	return ERR_NONE;
+}
 
-	/* Initialize here since _offset uses _first_unparsed as a default. */
-	_first_unparsed = 0;
-	_first_empty = 0;
+BNJ::PullParser::Error BNJ::PullParser::TryBeginMirrored(uint8_t* buffer,
+	unsigned len, Reader* reader) throw()
+{
+	if(TryBegin(buffer, len, reader))
+		return ERR_LENGTH;
+	_mirrored = true;
+	return ERR_NONE;
+}
 
-	_state = PARSE_ST;
-	_parser_state = ST_BEGIN;
+void BNJ::PullParser::SetFraming(Framing framing) throw(){
+	_framing = framing;
+	_doc_start = (FRAME_NONE != framing);
+	_documents = 0;
+}
+
+void BNJ::PullParser::SetProjection(const bnj_projection* projection) throw(){
+	_ctx.projection = projection;
 }
 
 void BNJ::PullParser::Begin(const uint8_t* buffer, unsigned len) throw(){
+	BeginInPlace(buffer, len);
+}
+
+void BNJ::PullParser::BeginPadded(const uint8_t* buffer, unsigned len) throw(){
+	BeginInPlace(buffer, len);
+	_padded = true;
+}
+
+void BNJ::PullParser::Reset(void) throw(){
+	Unmap();
 	_buffer = NULL;
-	_data = buffer;
-	_len = len;
+	_data = NULL;
+	_end = NULL;
+	_len = 0;
 	_reader = NULL;
+	_padded = false;
+	_mirrored = false;
+	_framing = FRAME_NONE;
+	_doc_start = false;
 
 	/* Reset state. */
+	bnj_state_init(&_pstate, _pstate.stack, _pstate.stack_length);
 	_depth = 0;
 	_val_idx = 0;
 	_val_len = 0;
-	_utf8_remaining = 0;
+	_chunk_remaining = 0;
+	_chunk_width = 0;
 	_total_parsed = 0;
 	_total_pulled = 0;
+	_fragments = 0;
+	_compacted = 0;
+	_documents = 0;
+	_err = ERR_NONE;
 
 	/* Initialize here since _offset uses _first_unparsed as a default. */
 	_first_unparsed = 0;
-
-	/* Buffer already contains entire JSON data. */
-	_first_empty = len;
+	_first_empty = 0;
 
 	_state = PARSE_ST;
 	_parser_state = ST_BEGIN;
 }
 
-unsigned BNJ::PullParser::FileOffset(const bnj_val& v) const throw(){
+void BNJ::PullParser::BeginInPlace(const uint8_t* data, size_t len) throw(){
+	Reset();
+	_data = data;
+	_end = data + len;
+
+	/* Parse through a window sliding along the data, so offsets within a
+	 * parse pass fit BUFF_OFFSET whatever the length. */
+	_len = BNJ_WINDOW;
+	_first_empty = (len < _len) ? len : _len;
+}
+
+#ifndef _WIN32
+#ifndef BNJ_NO_EXCEPTIONS
+void BNJ::PullParser::BeginMapped(const char* path){
+	if(TryBeginMapped(path))
+		ThrowError();
+}
+#endif
+
+BNJ::PullParser::Error BNJ::PullParser::TryBeginMapped(const char* path) throw(){
+	/* Failing leaves nothing of an earlier document to pull. */
+	Reset();
+
+	int fd = open(path, O_RDONLY);
+	if(-1 == fd){
+		Abort(ERR_READ, "PullParser::BeginMapped open error.");
+		return ERR_READ;
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) || (unsigned long long)st.st_size > SIZE_MAX){
+		close(fd);
+		Abort(ERR_READ, "PullParser::BeginMapped file size error.");
+		return ERR_READ;
+	}
+
+	/* Nothing to map; parsing will report the missing data. */
+	static const uint8_t empty[BNJ_PADDING] = {0};
+	if(!st.st_size){
+		close(fd);
+		BeginPadded(empty, 0);
+		return ERR_NONE;
+	}
+
+	/* Mapping holds its own reference to the file. */
+	void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(MAP_FAILED == map){
+		Abort(ERR_READ, "PullParser::BeginMapped mmap error.");
+		return ERR_READ;
+	}
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	BeginInPlace((const uint8_t*)map, st.st_size);
+
+	/* Rest of the last page reads as zeros. If it covers the padding, the
+	 * last window uses the faster padded parse. */
+	const size_t page = sysconf(_SC_PAGESIZE);
+	const size_t tail = st.st_size % page;
+	_padded = tail && tail + BNJ_PADDING <= page;
+
+	_map = map;
+	_map_len = st.st_size;
+	return ERR_NONE;
+}
+
+void BNJ::PullParser::Unmap(void) throw(){
+	if(_map){
+		munmap(_map, _map_len);
+		_map = NULL;
+		_map_len = 0;
+		_released = 0;
+	}
+}
+
+void BNJ::PullParser::ReleaseMapped(void) throw(){
+	/* Values from earlier parse passes are gone, so everything before
+	 * _offset may go. Mapping is page aligned. */
+	const size_t page = sysconf(_SC_PAGESIZE);
+	const size_t done = Buff() - (const uint8_t*)_map;
+	const size_t behind = done - done % page;
+	if(behind - _released >= BNJ_MAP_RELEASE_STEP){
+		madvise((uint8_t*)_map + _released, behind - _released, MADV_DONTNEED);
+		_released = behind;
+	}
+}
+#else
+void BNJ::PullParser::Unmap(void) throw(){
+}
+
+void BNJ::PullParser::ReleaseMapped(void) throw(){
+}
+#endif
+
+STREAM_OFFSET BNJ::PullParser::FileOffset(const bnj_val& v) const throw(){
 	/* FIXME! */
 	return _total_pulled + v.strval_offset;
 }
 
+BNJ::PullParser::Error BNJ::PullParser::SetError(Error code, const char* blurb,
+	unsigned expected) const throw()
+{
+	_err = code;
+	_err_blurb = blurb;
+	_err_expected = expected;
+	_err_offset = ValidValue() ? FileOffset(_valbuff[_val_idx]) : _total_pulled;
+	return code;
+}
+
+BNJ::PullParser::State BNJ::PullParser::Abort(Error code, const char* blurb)
+	throw()
+{
+	_err = code;
+	_err_blurb = blurb;
+	_err_expected = 0;
+	_err_offset = _total_parsed;
+	_parser_state = ST_ERROR;
+	return ST_ERROR;
+}
+
+/* Key and type mismatches are only described when asked. */
+const char* BNJ::PullParser::ErrorBody(char* buffer) const throw(){
+	if(_err_blurb)
+		return _err_blurb;
+	if(ERR_KEY != _err && ERR_TYPE != _err)
+		return "";
+	if(!ValidValue())
+		return (ERR_KEY == _err) ? "Key mismatch" : "Type mismatch";
+
+	const bnj_val& val = _valbuff[_val_idx];
+	char* x;
+	if(ERR_KEY == _err){
+		x = stpcpy(buffer, "Key mismatch: expected ");
+		x = stpcpy(x, _ctx.key_set[_err_expected]);
+		x = stpcpy(x, ", found ");
+		bnj_stpkeycpy(x, &val, Buff());
+	}
+	else{
+		x = stpcpy(buffer, "Type mismatch: expected ");
+		x = stpcpy(x, s_type_strings[_err_expected]);
+		x = stpcpy(x, ", got ");
+		x = stpcpy(x, s_type_strings[val.type & BNJ_TYPE_MASK]);
+	}
+	return buffer;
+}
+
+unsigned BNJ::PullParser::ErrorMessage(char* dest, unsigned destlen) const
+	throw()
+{
+	if(!destlen)
+		return 0;
+	if(ERR_NONE == _err)
+		return s_copy_msg(dest, destlen, "");
+
+	/* Same text as the exception ThrowError() would throw. */
+	if(ERR_VALUE == _err){
+		invalid_value e(_err_blurb, *this);
+		return s_copy_msg(dest, destlen, e.what());
+	}
+	char buffer[1024];
+	input_error e(ErrorBody(buffer), _err_offset);
+	return s_copy_msg(dest, destlen, e.what());
+}
+
+#ifndef BNJ_NO_EXCEPTIONS
+void BNJ::PullParser::ThrowError(void) const{
+	char buffer[1024];
+	switch(_err){
+		case ERR_NONE:
+			return;
+
+		case ERR_READ:
+		case ERR_EOF:
+			throw std::runtime_error(_err_blurb);
+
+		case ERR_VALUE:
+			throw invalid_value(_err_blurb, *this);
+
+		default:
+			throw input_error(ErrorBody(buffer), _err_offset);
+	}
+}
+#endif
+
 /* NOTE the approach here (reading phase, parsing phase) is the not most
  * latency reducing approach. Its probably not even the approach that would
- * maximize bandwidth. However it is an easy approach. */
+ * maximize bandwidth. However it is an easy approach.
+ * Wrapping the Reader in a ReadAheadReader overlaps the reading phase with
+ * parsing without changing anything here. */
+#ifndef BNJ_NO_EXCEPTIONS
 BNJ::PullParser::State BNJ::PullParser::Pull(char const * const * key_set,
 	unsigned key_set_length)
 {
+	const State s = TryPull(key_set, key_set_length);
+	if(ST_ERROR == s)
+		ThrowError();
+	return s;
+}
+
+BNJ::PullParser::State BNJ::PullParser::Pull(const bnj_keymatcher& matcher){
+	const State s = TryPull(matcher);
+	if(ST_ERROR == s)
+		ThrowError();
+	return s;
+}
+#endif
+
+BNJ::PullParser::State BNJ::PullParser::TryPull(char const * const * key_set,
+	unsigned key_set_length) throw()
+{
 
 	/* For now, always set new user keys.
 	 * FIXME: Is there a better spot for this assignment? */
 	_ctx.key_set = key_set;
 	_ctx.key_set_length = key_set_length;
+	_ctx.key_matcher = NULL;
+	return PullNext();
+}
+
+BNJ::PullParser::State BNJ::PullParser::TryPull(const bnj_keymatcher& matcher)
+	throw()
+{
+	_ctx.key_set = matcher.key_set;
+	_ctx.key_set_length = matcher.key_set_length;
+	_ctx.key_matcher = &matcher;
+	return PullNext();
+}
+
+BNJ::PullParser::State BNJ::PullParser::PullNext(void) throw(){
+	/* Nothing more after an error. */
+	if(ST_ERROR == _parser_state)
+		return ST_ERROR;
 
 	/* If incoming on value, then user must have gotten value on last Pull().
 	 * Advance to next value. If at end, parse more data. */
@@ -318,10 +801,13 @@ BNJ::PullParser::State BNJ::PullParser::Pull(char const * const * key_set,
 		bnj_val* tmp = _valbuff + _val_idx;
 		/* If user ignored fragmented string just parse through it.
 		 * ONLY STRINGS should make it here.
-		 * Call ChunkRead8() until nothing left.. */
+		 * Call ChunkRead() until nothing left.. */
 		if(bnj_incomplete(&_pstate, tmp)){
 			assert(bnj_val_type(tmp) == BNJ_STRING);
-			while(ChunkRead8(NULL, 0));
+			int n;
+			while((n = ChunkRead((uint8_t*)NULL, 0, 0xFFFFFFFF)) > 0);
+			if(n < 0)
+				return ST_ERROR;
 		}
 
 		/* Transition to depth lag state in case depth changed. */
@@ -329,62 +815,118 @@ BNJ::PullParser::State BNJ::PullParser::Pull(char const * const * key_set,
 		if(_val_len == _val_idx)
 			_state = DEPTH_LAG_ST;
 	}
+	else if(DEPTH_LAG_ST == _state && _val_idx < _val_len){
+		/* Map or list value went with the last ST_MAP or ST_LIST.
+		 * It is the last of its batch; further depth changes have no value. */
+		++_val_idx;
+	}
 
-	/* No fragments entering the switch loop. */
+	/* No fragments entering the switch loop. Offsets are from _offset. */
 	unsigned frag_key_len = 0;
+	unsigned frag_val_len = 0;
+	unsigned frag_key_off = 0;
+	unsigned frag_val_off = 0;
+
+	/* Set while an overlong number is parsed without keeping its text. */
+	bool numtext_lost = false;
 
 	while(true){
 		switch(_state){
 			case PARSE_ST:
 				{
-					/* Parser is at end state when depth is 0 AND not at begin state. */
-					if(!_depth && _parser_state != ST_BEGIN){
-						_parser_state = ST_NO_DATA;
+					/* Parser is at end state when depth is 0 AND the c parser
+					 * finished; a top level string may still be fragmented.
+					 * In a stream, that only ends the document. */
+					if(!_depth && BNJ_SUCCESS == _pstate.flags && !_doc_start){
+						if(FRAME_NONE == _framing){
+							_parser_state = ST_NO_DATA;
+							return _parser_state;
+						}
+						++_documents;
+						_doc_start = true;
+						_parser_state = ST_DOC_END;
 						return _parser_state;
 					}
 
+					/* Find the next document of a stream. */
+					if(_doc_start){
+						const State s = NextDocument();
+						if(ST_BEGIN != s)
+							return s;
+					}
+
 					/* If no more bytes to parse, then go to read state. */
 					if(_first_empty == _first_unparsed){
 						/* Completely read all the bytes in the buffer. */
-						FillBuffer(_len);
+						if(!FillBuffer())
+							return ST_ERROR;
 					}
 
 					/* Assign output values. */
 					_pstate.v = _valbuff;
-					_pstate.vlen = 4;
+					_pstate.vlen = _batch;
 					_val_idx = 0;
 					_val_len = 0;
 
 					/* Set offset to where parsing begins. Parse data.
 					 * Update parsed counter. */
 					_total_pulled = _total_parsed;
-					const uint8_t* res = bnj_parse(&_pstate, &_ctx,
-						_data + _first_unparsed, _first_empty - _first_unparsed);
+					/* In place data is padded only after its end. */
+					const bool padded = _padded && _data + _first_empty == _end;
+					const uint8_t* res;
+					if(padded)
+						res = bnj_parse_padded(&_pstate, &_ctx,
+							_data + _first_unparsed, _first_empty - _first_unparsed);
+					else
+						res = bnj_parse(&_pstate, &_ctx,
+							_data + _first_unparsed, _first_empty - _first_unparsed);
 					_total_parsed += res - (_data + _first_unparsed);
 
 					/* Abort on error. */
 					if(_pstate.flags & BNJ_ERROR_MASK)
-						throw input_error(s_error_msgs[_pstate.flags - BNJ_ERROR_MASK],
-							_total_parsed);
+						return Abort(ERR_SYNTAX,
+							s_error_msgs[_pstate.flags - BNJ_ERROR_MASK]);
 
-					if(!frag_key_len){
+					if(!frag_key_len && !frag_val_len){
 						_offset = _first_unparsed;
+						if(_map)
+							ReleaseMapped();
 					}
 					else{
-						/* Restore key length to first value.
+						/* Restore key length to first value, unless the projection
+						 * left out the fragment's value; then v[0] is another value.
 						 * Increment since more chars may have been added. */
-						_pstate.v->key_length += frag_key_len;
+						const bool continued = !_pstate.key_dropped;
+						if(continued)
+							_pstate.v->key_length += frag_key_len;
 
 						/* Bias any other values read in.
-						 * Start point moves away from offset. */
-						for(unsigned i = 0; i <= _pstate.vi; ++i){
-							_pstate.v[i].key_offset += frag_key_len;
-							_pstate.v[i].strval_offset += frag_key_len;
+						 * Start point moves away from offset.
+						 * Includes the value still in progress, if it has a slot. */
+						const unsigned bias = _first_unparsed - _offset;
+						const unsigned biased = (_pstate.vi < _pstate.vlen)
+							? _pstate.vi + 1 : _pstate.vi;
+						for(unsigned i = 0; i < biased; ++i){
+							_pstate.v[i].key_offset += bias;
+							_pstate.v[i].strval_offset += bias;
+						}
+						if(continued)
+							_pstate.v->key_offset = frag_key_off;
+
+						/* Numeric text fragment precedes the rest of the number. */
+						if(frag_val_len){
+							_pstate.v->strval_offset = frag_val_off;
+							_pstate.v->num_length += frag_val_len;
 						}
-						_pstate.v->key_offset = 0;
 
 						frag_key_len = 0;
-						_offset = 0;
+						frag_val_len = 0;
+					}
+
+					/* Number text was not kept, so mark it unavailable. */
+					if(numtext_lost && _pstate.vi){
+						_pstate.v->num_length = 0;
+						numtext_lost = _pstate.v->type & BNJ_VFLAG_VAL_FRAGMENT;
 					}
 
 					/* Advance first unparsed to where parsing ended. */
@@ -397,23 +939,33 @@ BNJ::PullParser::State BNJ::PullParser::Pull(char const * const * key_set,
 						break;
 					}
 
-					/* Otherwise must be lagging c parser depth.*/
+					/* Otherwise must be lagging c parser depth, or still skipping;
+					 * catching up parses on either way. */
 					/* FALLTHROUGH */
 					_state = DEPTH_LAG_ST;
 				}
 
 			/* Catch up to c parser's depth. */
 			case DEPTH_LAG_ST:
-				if(_depth < _pstate.depth){
-					++_depth;
-					_parser_state = (_pstate.stack[_depth] & BNJ_OBJECT) ? ST_MAP : ST_LIST;
-					return _parser_state;
-				}
-				else if(_depth > _pstate.depth){
-					_parser_state = (_pstate.stack[_depth] & BNJ_OBJECT) ? ST_ASCEND_MAP
-						: ST_ASCEND_LIST;
-					--_depth;
-					return _parser_state;
+				{
+					/* Maps and lists being skipped or left out are not entered. */
+					unsigned depth = _pstate.depth;
+					if(_pstate.skip_depth && _pstate.skip_depth <= depth)
+						depth = _pstate.skip_depth - 1;
+					if(_pstate.drop_depth && _pstate.drop_depth <= depth)
+						depth = _pstate.drop_depth - 1;
+
+					if(_depth < depth){
+						++_depth;
+						_parser_state = (_pstate.stack[_depth] & BNJ_OBJECT) ? ST_MAP : ST_LIST;
+						return _parser_state;
+					}
+					else if(_depth > depth){
+						_parser_state = (_pstate.stack[_depth] & BNJ_OBJECT) ? ST_ASCEND_MAP
+							: ST_ASCEND_LIST;
+						--_depth;
+						return _parser_state;
+					}
 				}
 
 				/* Otherwise, parser depth caught up to c parser depth.
@@ -426,16 +978,14 @@ BNJ::PullParser::State BNJ::PullParser::Pull(char const * const * key_set,
 					bnj_val* tmp = _valbuff + _val_idx;
 					unsigned type = bnj_val_type(tmp);
 
-					/* Remember number of UTF-8 characters.
-					 * ChunkRead*() will need this initialized. */
-					if(type == BNJ_STRING)
-						_utf8_remaining = bnj_strlen8(tmp);
+					/* ChunkRead*() counts code units on its first call. */
+					_chunk_width = 0;
 
 					/* If key is incomplete or non-string value incomplete,
 					 * then attempt to read full value. */
 					if(bnj_incomplete(&_pstate, tmp)){
-						if(NULL == _buffer)
-							throw std::runtime_error("Incomplete buffer.");
+						if(_data + _first_empty == _end)
+							return Abort(ERR_EOF, "Incomplete buffer.");
 
 						/* If string value then ChunkRead*() will handle fragmentation. */
 						if(type == BNJ_STRING){
@@ -445,23 +995,88 @@ BNJ::PullParser::State BNJ::PullParser::Pull(char const * const * key_set,
 						}
 
 						/* Move fragment from near buffer end to buffer start
-						 * so FillBuffer() appends to fragment.
+						 * so AppendBuffer() appends to fragment. A mirrored buffer
+						 * appends in place instead.
 						 * Note only string value fragments are 'large' fragments.
 						 * Since string fragments are filtered out at this point, the
 						 * fragment shift should not be very expensive. */
+						++_fragments;
+
+						/* Numbers keep their text so GetNumText() sees all of it,
+						 * unless BUFF_OFFSET cannot reach it or it fills the buffer
+						 * with its key; then just parser state carries on. A key only
+						 * fragment has no count fields set yet. */
+						if(BNJ_NUMERIC == type && (tmp->type & BNJ_VFLAG_VAL_FRAGMENT)){
+							if(numtext_lost || tmp->key_length + tmp->num_length >= _len)
+							{
+								tmp->type &= ~BNJ_VFLAG_VAL_FRAGMENT;
+								numtext_lost = true;
+							}
+						}
+						const bool has_text = BNJ_NUMERIC == type
+							&& (tmp->type & BNJ_VFLAG_VAL_FRAGMENT);
+						frag_key_len = tmp->key_length;
 
-						/* Bias key offsets before shifting fragment.
-						 * Note strval_offset only applies to BNJ_STRING. */
-						tmp->key_offset += _offset;
-						unsigned length = _len;
-						uint8_t* start = bnj_fragcompact(tmp, _buffer, &length);
-						_first_empty = start - _buffer;
+						unsigned end_bound;
+						if(_end){
+							/* Fragment stays in place; the window slides to its start,
+							 * from its key, if any, to _first_empty. */
+							unsigned begin = _first_empty;
+							if(has_text)
+								begin = _offset + tmp->strval_offset;
+							if(frag_key_len)
+								begin = _offset + tmp->key_offset;
+							frag_key_off = _offset + tmp->key_offset - begin;
+							frag_val_off = _offset + tmp->strval_offset - begin;
+							frag_val_len = has_text ? _first_empty - begin - frag_val_off : 0;
+							_data += begin;
+							_first_empty -= begin;
+							_offset = 0;
+							end_bound = _len;
+						}
+						else if(_mirrored){
+							/* Fragment runs from its key, if any, to _first_empty.
+							 * Keep its start within the first mapping. */
+							unsigned begin = _first_empty;
+							if(has_text)
+								begin = _offset + tmp->strval_offset;
+							if(frag_key_len)
+								begin = _offset + tmp->key_offset;
+							frag_key_off = _offset + tmp->key_offset - begin;
+							frag_val_off = _offset + tmp->strval_offset - begin;
+							frag_val_len = has_text ? _first_empty - begin - frag_val_off : 0;
+							if(begin >= _len){
+								begin -= _len;
+								_first_empty -= _len;
+							}
+							_offset = begin;
+							end_bound = begin + _len;
+						}
+						else{
+							/* Bias offsets before shifting fragment. */
+							tmp->key_offset += _offset;
+							if(has_text)
+								tmp->strval_offset += _offset;
+							unsigned length = _len;
+							uint8_t* start = bnj_fragcompact(tmp, _buffer, &length);
+							_first_empty = start - _buffer;
+							_compacted += _first_empty;
+
+							/* Remember key and numeric text. */
+							frag_key_off = 0;
+							frag_val_off = frag_key_len;
+							frag_val_len = _first_empty - frag_key_len;
+							_offset = 0;
+							end_bound = length + _first_empty;
+						}
 
-						/* Remember key offset and length. */
-						frag_key_len = tmp->key_length;
+						/* Fragment needs room to continue in. */
+						if(_first_empty == end_bound)
+							return Abort(ERR_LENGTH, "Fragment fills buffer!");
 
 						/* Fill buffer and switch to parsing state. */
-						FillBuffer(length + _first_empty);
+						if(!AppendBuffer(end_bound))
+							return ST_ERROR;
 						_state = PARSE_ST;
 						break;
 					}
@@ -486,11 +1101,65 @@ BNJ::PullParser::State BNJ::PullParser::Pull(char const * const * key_set,
 	}
 }
 
+#ifndef BNJ_NO_EXCEPTIONS
 BNJ::PullParser::State BNJ::PullParser::Up(void){
+	const State s = TryUp();
+	if(ST_ERROR == s)
+		ThrowError();
+	return s;
+}
+
+BNJ::PullParser::State BNJ::PullParser::Skip(void){
+	const State s = TrySkip();
+	if(ST_ERROR == s)
+		ThrowError();
+	return s;
+}
+#endif
+
+BNJ::PullParser::State BNJ::PullParser::TryUp(void) throw(){
 	/* Loop until parser depth goes above destination depth. Drop the data. */
 	const unsigned dest_depth = _depth - 1;
-	while(dest_depth < _depth)
-		Pull();
+	while(dest_depth < _depth){
+		if(ST_ERROR == TryPull())
+			return ST_ERROR;
+	}
+	return _parser_state;
+}
+
+BNJ::PullParser::State BNJ::PullParser::TrySkip(void) throw(){
+	if(ST_MAP == _parser_state || ST_LIST == _parser_state){
+		const unsigned dest_depth = _depth - 1;
+
+		/* Unless the c parser already left the map or list, have it skip the
+		 * rest. Any values not yet pulled are inside it. */
+		if(_pstate.depth >= _depth){
+			bnj_skip(&_pstate, _depth);
+			_state = PARSE_ST;
+		}
+
+		while(dest_depth < _depth){
+			if(ST_ERROR == TryPull())
+				return ST_ERROR;
+		}
+		return _parser_state;
+	}
+
+	/* Mark a fragmented string complete, so Pull() does not read the rest.
+	 * If the c parser already saw its closing quote, Pull() just finishes it. */
+	if(VALUE_ST == _state && _val_idx < _val_len){
+		bnj_val& val = _valbuff[_val_idx];
+		if(bnj_val_type(&val) == BNJ_STRING && bnj_incomplete(&_pstate, &val)){
+			bnj_skip(&_pstate, _pstate.depth + 1);
+			if(_pstate.skip_depth){
+				val.type &= ~BNJ_VFLAG_VAL_FRAGMENT;
+				val.cp1_count = val.cp2_count = val.cp3_count = 0;
+				val.exp_val = 0;
+				val.significand_val = BNJ_EMPTY_CP;
+				_chunk_remaining = 0;
+			}
+		}
+	}
 	return _parser_state;
 }
 
@@ -499,21 +1168,46 @@ BNJ::PullParser::State BNJ::PullParser::Up(void){
  * -_first_unparsed
  * -_buffer
  * */
-void BNJ::PullParser::FillBuffer(unsigned end_bound){
-	/* If started parsing with NULL reader, buffer DID not contain entire
-	 * JSON contents. */
-	if(!_reader)
-		throw std::runtime_error("Incomplete buffer.");
+bool BNJ::PullParser::FillBuffer(bool eof_ok) throw(){
+	/* In place data slides its window past all of it. */
+	if(_end){
+		_data += _first_empty;
+		_first_empty = 0;
+		_offset = 0;
+		return AppendBuffer(_len, eof_ok);
+	}
 
+	/* A mirrored buffer reads a whole ring from wherever it left off. */
 	_first_empty %= _len;
+	return AppendBuffer(_mirrored ? _first_empty + _len : _len, eof_ok);
+}
+
+bool BNJ::PullParser::AppendBuffer(unsigned end_bound, bool eof_ok) throw(){
+	/* In place data ran out; it did not contain entire JSON contents. */
+	if(_data + _first_empty == _end){
+		if(!eof_ok)
+			Abort(ERR_EOF, "Incomplete buffer.");
+		return false;
+	}
+
 	_first_unparsed = _first_empty;
-	while(_first_empty < end_bound){
+
+	/* In place data takes in what follows the window. */
+	if(_end){
+		const size_t rest = _end - (_data + _first_empty);
+		const unsigned room = end_bound - _first_empty;
+		_first_empty += (rest < room) ? rest : room;
+	}
+
+	while(_first_empty < end_bound && _reader){
 		int bytes_read =
 			_reader->Read(_buffer + _first_empty, end_bound - _first_empty);
 
 		/* FIXME Handle signal interruption. */
-		if(bytes_read < 0)
-			throw std::runtime_error("PullParser::Pull Read error.");
+		if(bytes_read < 0){
+			Abort(ERR_READ, "PullParser::Pull Read error.");
+			return false;
+		}
 
 		if(0 == bytes_read)
 			break;
@@ -521,60 +1215,206 @@ void BNJ::PullParser::FillBuffer(unsigned end_bound){
 	}
 
 	/* If buffer did not fill then error. */
-	if(0 == _first_empty - _first_unparsed)
-		throw std::runtime_error("PullParser::Pull early EOF.");
+	if(0 == _first_empty - _first_unparsed){
+		if(!eof_ok)
+			Abort(ERR_EOF, "PullParser::Pull early EOF.");
+		return false;
+	}
+	return true;
 }
 
-unsigned BNJ::GetKey(char* dest, unsigned destlen, const PullParser& p){
+BNJ::PullParser::State BNJ::PullParser::NextDocument(void) throw(){
+	/* First document needs no separator before it. */
+	bool newline = !_documents;
+	bool record = false;
+	while(true){
+		/* Skip whitespace, noting separators. */
+		while(_first_unparsed != _first_empty){
+			const uint8_t c = _data[_first_unparsed];
+			if('\n' == c)
+				newline = true;
+			else if(0x1E == c && FRAME_RECORDS == _framing)
+				record = true;
+			else if(' ' != c && '\t' != c && '\r' != c)
+				break;
+			++_first_unparsed;
+			++_total_parsed;
+		}
+		if(_first_unparsed != _first_empty)
+			break;
+
+		/* Input ending between documents ends the stream. */
+		if(!FillBuffer(true)){
+			if(ST_ERROR == _parser_state)
+				return ST_ERROR;
+			_parser_state = ST_NO_DATA;
+			return _parser_state;
+		}
+	}
+
+	if(FRAME_LINES == _framing && !newline)
+		return Abort(ERR_SYNTAX, "Missing newline between documents!");
+	if(FRAME_RECORDS == _framing && !record)
+		return Abort(ERR_SYNTAX, "Missing record separator!");
+
+	/* Data already buffered stays; only the c parser starts over. */
+	bnj_state_init(&_pstate, _pstate.stack, _pstate.stack_length);
+	_doc_start = false;
+	_parser_state = ST_BEGIN;
+	return ST_BEGIN;
+}
+
+int BNJ::TryGetKey(char* dest, unsigned destlen, const PullParser& p) throw(){
+	if(!p.ValidValue()){
+		p.SetError(PullParser::ERR_NO_VALUE, s_no_value);
+		return -1;
+	}
 	const bnj_val& val = p.GetValue();
 	if(dest){
-		if(val.key_length > destlen)
-			throw PullParser::input_error("Key value overlong!", p.FileOffset(val));
-		return bnj_stpkeycpy(dest, &val, p.Buff()) - dest;
+		if(val.key_length >= destlen){
+			p.SetError(PullParser::ERR_LENGTH, "Key value overlong!");
+			return -1;
+		}
+
+		/* No key copies nothing. */
+		const char* end = bnj_stpkeycpy(dest, &val, p.Buff());
+		if(!end){
+			*dest = '\0';
+			return 0;
+		}
+		return end - dest;
 	}
 	return 0;
 }
 
-void BNJ::Get(unsigned& u, const PullParser& p, unsigned key_enum){
+int BNJ::TryGetNumText(char* dest, unsigned destlen, const PullParser& p)
+	throw()
+{
+	if(!p.ValidValue()){
+		p.SetError(PullParser::ERR_NO_VALUE, s_no_value);
+		return -1;
+	}
 	const bnj_val& val = p.GetValue();
-	if(key_enum != 0xFFFFFFFF && val.key_enum != key_enum)
-		s_throw_key_error(p, key_enum);
-	if(bnj_val_type(&val) != BNJ_NUMERIC)
-		s_throw_type_error(p, BNJ_NUMERIC);
+	if(bnj_val_type(&val) != BNJ_NUMERIC){
+		p.SetError(PullParser::ERR_TYPE, NULL, BNJ_NUMERIC);
+		return -1;
+	}
 
-	if(val.exp_val)
-		throw PullParser::invalid_value("Non-integral numeric value!", p);
+	unsigned len;
+	const uint8_t* text = bnj_numtext(&val, p.Buff(), &len);
+	if(!len){
+		p.SetError(PullParser::ERR_LENGTH, "Number text not kept!");
+		return -1;
+	}
 
-	/* Check sign. */
-	if(val.type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND)
-		throw PullParser::invalid_value("Must be nonnegative!", p);
+	const unsigned neg = (val.type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? 1 : 0;
+	if(len + neg >= destlen){
+		p.SetError(PullParser::ERR_LENGTH, "Number text overlong!");
+		return -1;
+	}
 
-	u = val.significand_val;
+	if(neg)
+		*dest = '-';
+	memcpy(dest + neg, text, len);
+	dest[neg + len] = '\0';
+	return neg + len;
 }
 
-void BNJ::Get(int& ret, const PullParser& p, unsigned key_enum){
+/* Exact integer in range of T, or record why not. */
+template<typename T>
+static BNJ::PullParser::Error s_get_integer(T& dest, const BNJ::PullParser& p,
+	unsigned key_enum)
+{
+	using BNJ::PullParser;
+	const PullParser::Error err = s_check_key(p, key_enum);
+	if(err)
+		return err;
 	const bnj_val& val = p.GetValue();
-	if(key_enum != 0xFFFFFFFF && val.key_enum != key_enum)
-		s_throw_key_error(p, key_enum);
 	if(bnj_val_type(&val) != BNJ_NUMERIC)
-		s_throw_type_error(p, BNJ_NUMERIC);
+		return p.SetError(PullParser::ERR_TYPE, NULL, BNJ_NUMERIC);
+
+	SIGNIFICAND mag = 0;
+	const unsigned res = bnj_integer(&val, p.Buff(), &mag);
+	if(BNJ_INT_FRACTION == res)
+		return p.SetError(PullParser::ERR_VALUE, "Non-integral numeric value!");
+
+	/* -0 is just 0. */
+	const bool neg = (val.type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND)
+		&& (mag || BNJ_INT_RANGE == res);
+	if(neg && !std::numeric_limits<T>::is_signed)
+		return p.SetError(PullParser::ERR_VALUE, "Must be nonnegative!");
+	if(BNJ_INT_RANGE == res)
+		return p.SetError(PullParser::ERR_VALUE, "Out of range integer!");
+
+	/* Negative magnitude may be one more than max. */
+	if(neg){
+		if(mag - 1 > (SIGNIFICAND)std::numeric_limits<T>::max())
+			return p.SetError(PullParser::ERR_VALUE, "Out of range integer!");
+		dest = -(T)(mag - 1) - 1;
+	}
+	else{
+		if(mag > (SIGNIFICAND)std::numeric_limits<T>::max())
+			return p.SetError(PullParser::ERR_VALUE, "Out of range integer!");
+		dest = mag;
+	}
+	return PullParser::ERR_NONE;
+}
 
-	if(val.exp_val)
-		throw PullParser::input_error("Non-integral numeric value!", p.FileOffset(val));
+BNJ::PullParser::Error BNJ::TryGet(uint8_t& u, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	return s_get_integer(u, p, key_enum);
+}
 
-	if(val.significand_val > LONG_MAX)
-		throw PullParser::input_error("Out of range integer!", p.FileOffset(val));
+BNJ::PullParser::Error BNJ::TryGet(int8_t& i, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	return s_get_integer(i, p, key_enum);
+}
 
-	ret = val.significand_val;
-	if(val.type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND)
-		ret = -ret;
+BNJ::PullParser::Error BNJ::TryGet(uint16_t& u, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	return s_get_integer(u, p, key_enum);
 }
 
+BNJ::PullParser::Error BNJ::TryGet(int16_t& i, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	return s_get_integer(i, p, key_enum);
+}
 
-void BNJ::Get(float& f, const PullParser& p, unsigned key_enum){
+BNJ::PullParser::Error BNJ::TryGet(unsigned& u, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	return s_get_integer(u, p, key_enum);
+}
+
+BNJ::PullParser::Error BNJ::TryGet(int& i, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	return s_get_integer(i, p, key_enum);
+}
+
+BNJ::PullParser::Error BNJ::TryGet(uint64_t& u, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	return s_get_integer(u, p, key_enum);
+}
+
+BNJ::PullParser::Error BNJ::TryGet(int64_t& i, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	return s_get_integer(i, p, key_enum);
+}
+
+BNJ::PullParser::Error BNJ::TryGet(float& f, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	const PullParser::Error err = s_check_key(p, key_enum);
+	if(err)
+		return err;
 	const bnj_val& val = p.GetValue();
-	if(key_enum != 0xFFFFFFFF && val.key_enum != key_enum)
-		s_throw_key_error(p, key_enum);
 
 	unsigned t = bnj_val_type(&val);
 	if(BNJ_NUMERIC == t){
@@ -587,13 +1427,17 @@ void BNJ::Get(float& f, const PullParser& p, unsigned key_enum){
 			f = (val.type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -INFINITY: INFINITY;
 	}
 	else
-		s_throw_type_error(p, BNJ_NUMERIC);
+		return p.SetError(PullParser::ERR_TYPE, NULL, BNJ_NUMERIC);
+	return PullParser::ERR_NONE;
 }
 
-void BNJ::Get(double& d, const PullParser& p, unsigned key_enum){
+BNJ::PullParser::Error BNJ::TryGet(double& d, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	const PullParser::Error err = s_check_key(p, key_enum);
+	if(err)
+		return err;
 	const bnj_val& val = p.GetValue();
-	if(key_enum != 0xFFFFFFFF && val.key_enum != key_enum)
-		s_throw_key_error(p, key_enum);
 
 	unsigned t = bnj_val_type(&val);
 	if(BNJ_NUMERIC == t){
@@ -606,56 +1450,162 @@ void BNJ::Get(double& d, const PullParser& p, unsigned key_enum){
 			d = (val.type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -INFINITY: INFINITY;
 	}
 	else
-		s_throw_type_error(p, BNJ_NUMERIC);
+		return p.SetError(PullParser::ERR_TYPE, NULL, BNJ_NUMERIC);
+	return PullParser::ERR_NONE;
 }
 
-void BNJ::Get(bool& b, const PullParser& p, unsigned key_enum){
+BNJ::PullParser::Error BNJ::TryGet(bool& b, const PullParser& p,
+	unsigned key_enum) throw()
+{
+	const PullParser::Error err = s_check_key(p, key_enum);
+	if(err)
+		return err;
 	const bnj_val& val = p.GetValue();
-	if(key_enum != 0xFFFFFFFF && val.key_enum != key_enum)
-		s_throw_key_error(p, key_enum);
 
 	unsigned t = bnj_val_type(&val);
 	if(BNJ_SPECIAL == t){
 		if(BNJ_SPC_FALSE == val.significand_val){
 			b = false;
-			return;
+			return PullParser::ERR_NONE;
 		}
 		else if(BNJ_SPC_TRUE == val.significand_val){
 			b = true;
-			return;
+			return PullParser::ERR_NONE;
 		}
 	}
-	s_throw_type_error(p, BNJ_SPECIAL);
+	return p.SetError(PullParser::ERR_TYPE, NULL, BNJ_SPECIAL);
 }
 
 
-void BNJ::VerifyNull(const PullParser& p, unsigned key_enum){
+BNJ::PullParser::Error BNJ::TryVerifyNull(const PullParser& p,
+	unsigned key_enum) throw()
+{
+	const PullParser::Error err = s_check_key(p, key_enum);
+	if(err)
+		return err;
 	const bnj_val& val = p.GetValue();
-	if(key_enum != 0xFFFFFFFF && val.key_enum != key_enum)
-		s_throw_key_error(p, key_enum);
 	if(bnj_val_type(&val) != BNJ_SPECIAL
 		|| val.significand_val != BNJ_SPC_NULL)
 	{
-		s_throw_type_error(p, BNJ_SPECIAL);
+		return p.SetError(PullParser::ERR_TYPE, NULL, BNJ_SPECIAL);
 	}
+	return PullParser::ERR_NONE;
 }
 
-void BNJ::VerifyList(const PullParser& p, unsigned key_enum){
+BNJ::PullParser::Error BNJ::TryVerifyList(const PullParser& p,
+	unsigned key_enum) throw()
+{
 	if(key_enum != 0xFFFFFFFF){
-		const bnj_val& val = p.GetValue();
-		if(val.key_enum != key_enum)
-			s_throw_key_error(p, key_enum);
+		const PullParser::Error err = s_check_key(p, key_enum);
+		if(err)
+			return err;
+	}
+	if(p.GetState() != PullParser::ST_LIST){
+		if(!p.ValidValue())
+			return p.SetError(PullParser::ERR_NO_VALUE, s_no_value);
+		return p.SetError(PullParser::ERR_TYPE, "Expected List!");
 	}
-	if(p.GetState() != PullParser::ST_LIST)
-		throw PullParser::input_error("Expected List!", p.FileOffset(p.GetValue()));
+	return PullParser::ERR_NONE;
 }
 
-void BNJ::VerifyMap(const PullParser& p, unsigned key_enum){
+BNJ::PullParser::Error BNJ::TryVerifyMap(const PullParser& p,
+	unsigned key_enum) throw()
+{
 	if(key_enum != 0xFFFFFFFF){
-		const bnj_val& val = p.GetValue();
-		if(val.key_enum != key_enum)
-			s_throw_key_error(p, key_enum);
+		const PullParser::Error err = s_check_key(p, key_enum);
+		if(err)
+			return err;
+	}
+	if(p.GetState() != PullParser::ST_MAP){
+		if(!p.ValidValue())
+			return p.SetError(PullParser::ERR_NO_VALUE, s_no_value);
+		return p.SetError(PullParser::ERR_TYPE, "Expected Map!");
 	}
-	if(p.GetState() != PullParser::ST_MAP)
-		throw PullParser::input_error("Expected Map!", p.FileOffset(p.GetValue()));
+	return PullParser::ERR_NONE;
+}
+
+#ifndef BNJ_NO_EXCEPTIONS
+unsigned BNJ::GetKey(char* dest, unsigned destlen, const PullParser& p){
+	const int ret = TryGetKey(dest, destlen, p);
+	if(ret < 0)
+		p.ThrowError();
+	return ret;
+}
+
+unsigned BNJ::GetNumText(char* dest, unsigned destlen, const PullParser& p){
+	const int ret = TryGetNumText(dest, destlen, p);
+	if(ret < 0)
+		p.ThrowError();
+	return ret;
+}
+
+void BNJ::Get(uint8_t& u, const PullParser& p, unsigned key_enum){
+	if(TryGet(u, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(int8_t& i, const PullParser& p, unsigned key_enum){
+	if(TryGet(i, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(uint16_t& u, const PullParser& p, unsigned key_enum){
+	if(TryGet(u, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(int16_t& i, const PullParser& p, unsigned key_enum){
+	if(TryGet(i, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(unsigned& u, const PullParser& p, unsigned key_enum){
+	if(TryGet(u, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(int& i, const PullParser& p, unsigned key_enum){
+	if(TryGet(i, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(uint64_t& u, const PullParser& p, unsigned key_enum){
+	if(TryGet(u, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(int64_t& i, const PullParser& p, unsigned key_enum){
+	if(TryGet(i, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(float& f, const PullParser& p, unsigned key_enum){
+	if(TryGet(f, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(double& d, const PullParser& p, unsigned key_enum){
+	if(TryGet(d, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::Get(bool& b, const PullParser& p, unsigned key_enum){
+	if(TryGet(b, p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::VerifyNull(const PullParser& p, unsigned key_enum){
+	if(TryVerifyNull(p, key_enum))
+		p.ThrowError();
 }
+
+void BNJ::VerifyList(const PullParser& p, unsigned key_enum){
+	if(TryVerifyList(p, key_enum))
+		p.ThrowError();
+}
+
+void BNJ::VerifyMap(const PullParser& p, unsigned key_enum){
+	if(TryVerifyMap(p, key_enum))
+		p.ThrowError();
+}
+#endif
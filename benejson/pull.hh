@@ -7,12 +7,18 @@
 #ifndef __BENEGON_JSON_PULL_PARSER_HH__
 #define __BENEGON_JSON_PULL_PARSER_HH__
 
+#include <assert.h>
 #include <stdexcept>
 
 extern "C" {
 	#include "benejson.h"
 }
 
+/* Without exceptions (-fno-exceptions) only the Try*() API is available. */
+#if !defined(__cpp_exceptions) && !defined(__EXCEPTIONS)
+#define BNJ_NO_EXCEPTIONS
+#endif
+
 namespace BNJ {
 	/** @brief 
 	 * -Handles input details
@@ -28,6 +34,14 @@ namespace BNJ {
 	 *  block is sufficient to wrap around the entire pull parsing process.
 	 * -It is unnecessary to wrap individual Pull(), Get(), etc calls with try{}.
 	 *  There are methods to detect types, keys, etc without throwing exceptions.
+	 * -Each throwing call has a Try*() counterpart that returns an error status
+	 *  instead. The error is recorded in the parser; LastError() tells what
+	 *  went wrong and ErrorMessage() formats the text only when asked.
+	 *  Probing optional fields with TryGet() costs no more than a successful
+	 *  Get(). ThrowError() turns a recorded error into the exception the
+	 *  throwing call would have thrown.
+	 * -When the library is built without exceptions (BNJ_NO_EXCEPTIONS), it
+	 *  only defines the Try*() calls.
 	 *  */
 	class PullParser {
 		public:
@@ -51,9 +65,66 @@ namespace BNJ {
 				ST_ASCEND_MAP,
 
 				/** @brief Ascend out of list. */
-				ST_ASCEND_LIST
+				ST_ASCEND_LIST,
+
+				/** @brief After Try*(), parsing failed; see LastError().
+				 *  Final state until the next Begin(). */
+				ST_ERROR,
+
+				/** @brief With SetFraming(), finished a document at depth 0.
+				 *  Next Pull() starts the next document. */
+				ST_DOC_END
 			} State;
 
+			/** @brief How documents follow each other in a stream. */
+			typedef enum {
+				/** @brief Single document; data after it is ignored. */
+				FRAME_NONE,
+
+				/** @brief Concatenated documents, optionally separated by
+				 *  whitespace. */
+				FRAME_CONCAT,
+
+				/** @brief Newline delimited (NDJSON, JSON Lines); at least one
+				 *  newline between documents. Blank lines are skipped. */
+				FRAME_LINES,
+
+				/** @brief RFC 7464 JSON text sequence; each document follows a
+				 *  record separator (0x1E). Empty records are skipped. */
+				FRAME_RECORDS
+			} Framing;
+
+			/** @brief Error status for the Try*() API. */
+			typedef enum {
+				/** @brief Success. */
+				ERR_NONE,
+
+				/** @brief JSON syntax error. */
+				ERR_SYNTAX,
+
+				/** @brief Reader::Read() failed or file could not be mapped. */
+				ERR_READ,
+
+				/** @brief Input ended before the JSON data did. */
+				ERR_EOF,
+
+				/** @brief No value available. */
+				ERR_NO_VALUE,
+
+				/** @brief Key enum mismatch. */
+				ERR_KEY,
+
+				/** @brief Type or context mismatch. */
+				ERR_TYPE,
+
+				/** @brief Valid JSON value, but not acceptable to destination
+				 *  (non-integral, negative, out of range). */
+				ERR_VALUE,
+
+				/** @brief Destination too small, or text not available. */
+				ERR_LENGTH
+			} Error;
+
 			/** @brief Adapter class for pulling more input data. */
 			class Reader {
 				public:
@@ -73,7 +144,7 @@ namespace BNJ {
 			 * Not used for errors thrown for failures from Reader::Read(). */
 			class input_error : public virtual std::exception{
 				public:
-					input_error(const char* msg, unsigned file_offset);
+					input_error(const char* msg, STREAM_OFFSET file_offset);
 					const char* what(void) const throw();
 
 				private:
@@ -102,6 +173,16 @@ namespace BNJ {
 			 *  @param maxdepth Maximum json depth to parse.  */
 			PullParser(unsigned maxdepth, uint32_t* stack);
 
+			/** @brief Initialize with scratch space for value batches.
+			 *  Each parse pass stops after batch values or a depth change, so
+			 *  larger batches re-enter the c parser less often on wide maps
+			 *  and lists.
+			 *  @param maxdepth Maximum json depth to parse.
+			 *  @param batch Most values per parse pass; at least 1.
+			 *  @param batch_space Preallocated memory for batch values. */
+			PullParser(unsigned maxdepth, uint32_t* stack, unsigned batch,
+				bnj_val* batch_space);
+
 			~PullParser();
 
 
@@ -112,30 +193,145 @@ namespace BNJ {
 			 *  Allows instance reuse.
 			 *  @param buffer Where to buffer character data during parsing session.
 			 *  Do NOT mess with the contents of the buffer while parsing!
-			 *  @param len Size of buffer
-			 *  @param reader From where to pull data. */
-			void Begin(uint8_t* buffer, unsigned len, Reader* reader) throw();
+			 *  @param len Size of buffer; at most BUFF_OFFSET_MAX, 64 KiB less a
+			 *  byte without BNJ_WIDE_OFFSETS.
+			 *  @param reader From where to pull data.
+			 *  @throw input_error if len exceeds BUFF_OFFSET_MAX. */
+			void Begin(uint8_t* buffer, unsigned len, Reader* reader);
+
+			/** @brief Begin(buffer, len, reader) without exceptions.
+			 *  @return ERR_NONE, or ERR_LENGTH if len exceeds BUFF_OFFSET_MAX;
+			 *  then the parser stays in ST_ERROR. */
+			Error TryBegin(uint8_t* buffer, unsigned len, Reader* reader) throw();
+
+			/** @brief Begin(buffer, len, reader) on a mirrored buffer.
+			 *  Byte i + len must alias byte i, as with MirrorBuffer. Key and
+			 *  number fragments stay in place while the ring fills past them,
+			 *  so they are never moved to the buffer start.
+			 *  @param buffer First of two back to back mappings of the ring.
+			 *  @param len Size of one mapping; at most BUFF_OFFSET_MAX
+			 *  @param reader From where to pull data.
+			 *  @throw input_error if len exceeds BUFF_OFFSET_MAX. */
+			void BeginMirrored(uint8_t* buffer, unsigned len, Reader* reader);
+
+			/** @brief BeginMirrored() without exceptions.
+			 *  @return ERR_NONE, or ERR_LENGTH if len exceeds BUFF_OFFSET_MAX;
+			 *  then the parser stays in ST_ERROR. */
+			Error TryBeginMirrored(uint8_t* buffer, unsigned len, Reader* reader)
+				throw();
 
 			/** @brief Prepare parser for iteration operations.
 			 *  Does NOT Pull any values.
 			 *  Allows instance reuse.
+			 *  Parses in place through a window of at most BUFF_OFFSET_MAX
+			 *  bytes sliding along buffer, so len is not limited by it. Key and
+			 *  number fragments at a window's end must fit the window.
 			 *  @param buffer Contains all raw JSON data to be parsed.
 			 *  @param len Size of buffer */
 			void Begin(const uint8_t* buffer, unsigned len) throw();
 
+			/** @brief Prepare parser for iteration operations on data followed
+			 *  by BNJ_PADDING readable bytes; see bnj_parse_padded().
+			 *  Does NOT Pull any values.
+			 *  Allows instance reuse. Windowed as Begin(buffer, len).
+			 *  @param buffer Contains all raw JSON data to be parsed, then
+			 *  padding. buffer[len] must be 0.
+			 *  @param len Size of buffer, excluding padding. */
+			void BeginPadded(const uint8_t* buffer, unsigned len) throw();
+
+#ifndef _WIN32
+			/** @brief Prepare parser for iteration operations on a file mapped
+			 *  into memory. Parses in place with no copies, windowed as
+			 *  Begin(buffer, len), so any file size fits BUFF_OFFSET. Pages
+			 *  behind parsed values are released as parsing advances, so
+			 *  resident memory stays small.
+			 *  Does NOT Pull any values.
+			 *  Allows instance reuse. The mapping lasts until the next Begin()
+			 *  or destruction.
+			 *  @param path File to parse.
+			 *  @throw std::runtime_error if the file cannot be mapped. */
+			void BeginMapped(const char* path);
+
+			/** @brief BeginMapped() without exceptions. On failure, any
+			 *  earlier document is dropped and the state is ST_ERROR.
+			 *  @return ERR_NONE, or ERR_READ if the file cannot be mapped. */
+			Error TryBeginMapped(const char* path) throw();
+#endif
+
+			/** @brief Parse a stream of documents from one input.
+			 *  Each document starts from a fresh c parser state, but data
+			 *  already buffered is kept. After each document Pull() returns
+			 *  ST_DOC_END at depth 0; ST_NO_DATA once input ends between
+			 *  documents. An empty stream is not an error.
+			 *  As with one document, a top level scalar needs a byte after it,
+			 *  such as the newline ending its record.
+			 *  Call after Begin*(), which resets framing to FRAME_NONE.
+			 *  @param framing How documents are separated. */
+			void SetFraming(Framing framing) throw();
+
+			/** @brief Report only the values projection selects; see
+			 *  bnj_projection. Values left out are never pulled, but are still
+			 *  validated unless the projection is structural. At depths whose
+			 *  level has keys, key_enum indexes the level's keys, so pass them
+			 *  to Pull() as well.
+			 *  Kept across Begin*(); change only between documents.
+			 *  @param projection Must outlive parsing. NULL reports all. */
+			void SetProjection(const bnj_projection* projection) throw();
+
 			/** @brief Pull next value
 			 *  Calling Pull() invalidates values from a previous Pull() call.
-			 *  @param key_set Lexigraphically sorted array of keys to match
+			 *  @param key_set Lexigraphically sorted array of keys to match;
+			 *  keys in the data match once unescaped, see bnj_ctx.key_set.
 			 *  @param key_set_length length of key_set
 			 *  @return New parser state
 			 *  @throw on parsing errors */
 			State Pull(char const * const * key_set = NULL, unsigned key_set_length = 0);
 
+			/** @brief Pull next value, matching keys with a compiled matcher.
+			 *  Same as Pull(matcher.key_set, matcher.key_set_length), but key
+			 *  matching costs one lookup per key byte.
+			 *  @param matcher Compiled key set. Must remain valid until the
+			 *  next Pull() call.
+			 *  @return New parser state
+			 *  @throw on parsing errors */
+			State Pull(const bnj_keymatcher& matcher);
+
+			/** @brief Pull() without exceptions.
+			 *  @return New parser state; ST_ERROR on parsing errors. */
+			State TryPull(char const * const * key_set = NULL,
+				unsigned key_set_length = 0) throw();
+
+			/** @brief Pull(matcher) without exceptions.
+			 *  @return New parser state; ST_ERROR on parsing errors. */
+			State TryPull(const bnj_keymatcher& matcher) throw();
+
 			/** @brief Jump out of deepest depth map/list.
+			 *  The rest of it is parsed and validated as Pull() would, but
+			 *  not reported.
 			 *  @return Context out of which left
 			 *  (ST_ASCEND_MAP or ST_ASCEND_LIST) */
 			State Up(void);
 
+			/** @brief Up() without exceptions.
+			 *  @return ST_ASCEND_MAP or ST_ASCEND_LIST; ST_ERROR on parsing
+			 *  errors. */
+			State TryUp(void) throw();
+
+			/** @brief Skip the map, list or string value just pulled without
+			 *  parsing its contents; see bnj_skip().
+			 *  Faster than Up(), but only quotes and bracket nesting are
+			 *  validated; other malformed input inside goes unnoticed.
+			 *  After ST_MAP or ST_LIST, leaves it as Up() does. After a string
+			 *  ST_DATUM, the unread rest of the string is dropped.
+			 *  Otherwise does nothing.
+			 *  @return New parser state
+			 *  @throw on parsing errors */
+			State Skip(void);
+
+			/** @brief Skip() without exceptions.
+			 *  @return New parser state; ST_ERROR on parsing errors. */
+			State TrySkip(void) throw();
+
 
 			/* Accessors. */
 
@@ -157,9 +353,64 @@ namespace BNJ {
 			unsigned ChunkRead8(char* dest, unsigned destlen,
 				unsigned key_enum = 0xFFFFFFFF);
 
-			/* TODO UTF-16, UTF-32 versions of ChunkRead8(). */
+			/** @brief Get the whole string value, in place when possible.
+			 *  -If the string has no escapes and is not fragmented, points into
+			 *   the buffer without copying. Valid until the next Pull(); NOT null
+			 *   terminated.
+			 *  -Otherwise reads the string into dest with ChunkRead8(), so the
+			 *   same caveat about the key applies.
+			 *  @param len Set to string length in bytes.
+			 *  @param dest Where to copy the string if needed. If NULL, throws
+			 *  instead of copying.
+			 *  @param destlen Maximum size of destination.
+			 *  @param key_enum Verify key idx matches enum val. Default no matching.
+			 *  @return Beginning of UTF-8 string, in the buffer or at dest.
+			 *  @throw  type mismatch, key_enum mismatch
+			 *  or copy needed but string does not fit in dest. */
+			const char* GetStringView(unsigned& len, char* dest = NULL,
+				unsigned destlen = 0, unsigned key_enum = 0xFFFFFFFF);
+
+			/** @brief Read a chunk of UTF-16 code units into user buffer.
+			 *  -Same behavior as ChunkRead8(), in native byte order.
+			 *  -Only whole surrogate pairs read.
+			 *  -Do not mix ChunkRead*() widths on the same string.
+			 *  @param destlen Maximum size of destination in code units.
+			 *  Must be >= 3.
+			 *  @return Number of code units copied, excluding null terminator. */
+			unsigned ChunkRead16(uint16_t* dest, unsigned destlen,
+				unsigned key_enum = 0xFFFFFFFF);
+
+			/** @brief Read a chunk of UTF-32 code points into user buffer.
+			 *  -Same behavior as ChunkRead8(), in native byte order.
+			 *  -Do not mix ChunkRead*() widths on the same string.
+			 *  @param destlen Maximum size of destination in code points.
+			 *  Must be >= 2.
+			 *  @return Number of code points copied, excluding null terminator. */
+			unsigned ChunkRead32(uint32_t* dest, unsigned destlen,
+				unsigned key_enum = 0xFFFFFFFF);
+
+			/** @brief ChunkRead8() without exceptions.
+			 *  @return Number of bytes copied; < 0 on error. */
+			int TryChunkRead8(char* dest, unsigned destlen,
+				unsigned key_enum = 0xFFFFFFFF) throw();
+
+			/** @brief ChunkRead16() without exceptions.
+			 *  @return Number of code units copied; < 0 on error. */
+			int TryChunkRead16(uint16_t* dest, unsigned destlen,
+				unsigned key_enum = 0xFFFFFFFF) throw();
+
+			/** @brief ChunkRead32() without exceptions.
+			 *  @return Number of code points copied; < 0 on error. */
+			int TryChunkRead32(uint32_t* dest, unsigned destlen,
+				unsigned key_enum = 0xFFFFFFFF) throw();
+
+			/** @brief GetStringView() without exceptions.
+			 *  @return Beginning of UTF-8 string; NULL on error. */
+			const char* TryGetStringView(unsigned& len, char* dest = NULL,
+				unsigned destlen = 0, unsigned key_enum = 0xFFFFFFFF) throw();
 
 			/** @brief Get currently parsed value.
+			 *  With BNJ_NO_EXCEPTIONS, check ValidValue() first; asserts it.
 			 *  @throw When parser state is not ST_DATUM */
 			const bnj_val& GetValue(void) const;
 
@@ -205,10 +456,49 @@ namespace BNJ {
 			unsigned BuffLen(void) const;
 
 			/** @brief Indicate at what file offset value begins. */
-			unsigned FileOffset(const bnj_val& v) const throw();
+			STREAM_OFFSET FileOffset(const bnj_val& v) const throw();
 
 			/** @brief Total bytes parsed. */
-			unsigned TotalParsed() const;
+			STREAM_OFFSET TotalParsed() const;
+
+			/** @brief Keys and non-string values split across buffer refills. */
+			STREAM_OFFSET Fragments() const;
+
+			/** @brief Bytes of fragments moved to the buffer start.
+			 *  Always 0 after BeginMirrored(). */
+			STREAM_OFFSET CompactedBytes() const;
+
+			/** @brief Documents finished since SetFraming(). */
+			STREAM_OFFSET Documents() const;
+
+			/* Error status. */
+
+			/** @brief Last error recorded by a Try*() call or SetError().
+			 *  Successful calls do not clear it; Begin() does. */
+			Error LastError(void) const;
+
+			/** @brief Format the last error as the thrown exception would.
+			 *  Key and type mismatch text comes from the current value, so call
+			 *  before the next Pull().
+			 *  @param dest Where to store message.
+			 *  @param destlen Maximum size of destination.
+			 *  @return Number of bytes copied, excluding null terminator. */
+			unsigned ErrorMessage(char* dest, unsigned destlen) const throw();
+
+			/** @brief Record an error at the current value, as the Try*() calls
+			 *  do. Counterpart of throwing invalid_value.
+			 *  @param code Error status.
+			 *  @param blurb Static message. For ERR_KEY or ERR_TYPE may be NULL
+			 *  to describe the mismatch with expected.
+			 *  @param expected Expected key enum for ERR_KEY, type for ERR_TYPE.
+			 *  @return code */
+			Error SetError(Error code, const char* blurb, unsigned expected = 0)
+				const throw();
+
+			/** @brief Throw the last error, as the throwing call would have.
+			 *  Does nothing for ERR_NONE.
+			 *  @throw input_error, invalid_value or std::runtime_error */
+			void ThrowError(void) const;
 
 		private:
 
@@ -218,14 +508,61 @@ namespace BNJ {
 			/** @brief Copy ctor. */
 			PullParser(const PullParser& p);
 
-			/** @brief Fill up _buffer from beginning.
+			/** @brief Refill _buffer once all of it is parsed.
+			 *  @param eof_ok If true, end of input is not an error.
+			 *  @return false on input error, after Abort(), or at end of input. */
+			bool FillBuffer(bool eof_ok = false) throw();
+
+			/** @brief Read into _buffer from _first_empty.
 			 *  @param end_bound Offset to end of fill region.
-			 *  @throw On input error. */
-			void FillBuffer(unsigned end_bound);
+			 *  @param eof_ok If true, end of input is not an error.
+			 *  @return false on input error, after Abort(), or at end of input. */
+			bool AppendBuffer(unsigned end_bound, bool eof_ok = false) throw();
+
+			/** @brief Skip separators up to the next document of a stream and
+			 *  reset the c parser for it.
+			 *  @return ST_BEGIN if a document follows; ST_NO_DATA at end of
+			 *  input; ST_ERROR on errors. */
+			State NextDocument(void) throw();
+
+			/** @brief Pull next value with the keys already in _ctx.
+			 *  @return New parser state; ST_ERROR on errors. */
+			State PullNext(void) throw();
+
+			/** @brief TryChunkRead*() implementation for code unit type T. */
+			template<typename T>
+			int ChunkRead(T* dest, unsigned destlen, unsigned key_enum);
+
+			/** @brief Record a parsing or input error; parser stops in ST_ERROR.
+			 *  @return ST_ERROR */
+			State Abort(Error code, const char* blurb) throw();
+
+			/** @brief Message of last error without file offset.
+			 *  @param buffer 1024 bytes to compose mismatch text in.
+			 *  @return buffer or static message. */
+			const char* ErrorBody(char* buffer) const throw();
 
-			/** @brief Internal value buffer.
+			/** @brief Reset parser state for Begin*(); no input. */
+			void Reset(void) throw();
+
+			/** @brief Begin() on in place data of any length. */
+			void BeginInPlace(const uint8_t* data, size_t len) throw();
+
+			/** @brief Unmap file from BeginMapped(), if any. */
+			void Unmap(void) throw();
+
+			/** @brief Release mapped pages behind _offset. */
+			void ReleaseMapped(void) throw();
+
+			/** @brief Value buffer for parse passes. */
+			bnj_val* _valbuff;
+
+			/** @brief Length of _valbuff. */
+			unsigned _batch;
+
+			/** @brief Value buffer when user does not provide one.
 			 * Presently, 4 is arbitrarily chosen, may change in the future... */
-			bnj_val _valbuff[4];
+			bnj_val _default_batch[4];
 
 			/** @brief Current value index. */
 			unsigned _val_idx;
@@ -242,12 +579,36 @@ namespace BNJ {
 			/** @brief Read only pointer to data. */
 			const uint8_t* _data;
 
-			/** @brief Size of _buffer */
+			/** @brief Size of _buffer, or of the window on in place data. */
 			unsigned _len;
 
+			/** @brief End of in place data; NULL when reading into _buffer. */
+			const uint8_t* _end;
+
 			/** @brief Input reader. */
 			Reader* _reader;
 
+			/** @brief If true, _data is followed by BNJ_PADDING bytes. */
+			bool _padded;
+
+			/** @brief If true, _buffer + _len aliases _buffer. */
+			bool _mirrored;
+
+			/** @brief How documents are separated. */
+			Framing _framing;
+
+			/** @brief If true, next Pull() looks for the next document. */
+			bool _doc_start;
+
+			/** @brief File mapping from BeginMapped(), if any. */
+			void* _map;
+
+			/** @brief Length of _map. */
+			size_t _map_len;
+
+			/** @brief Length of _map already released from memory. */
+			size_t _released;
+
 			/** @brief Pulling state. */
 			unsigned _state;
 
@@ -264,19 +625,44 @@ namespace BNJ {
 			unsigned _depth;
 
 			/** @brief Count of bytes parsed by bnj_parse(). */
-			unsigned _total_parsed;
+			STREAM_OFFSET _total_parsed;
 
 			/** @brief Count of bytes successfully Pulled(). */
-			unsigned _total_pulled;
+			STREAM_OFFSET _total_pulled;
 
-			/** @brief How many UTF-8 bytes remaining. */
-			unsigned _utf8_remaining;
+			/** @brief Count of key and non-string value fragments. */
+			STREAM_OFFSET _fragments;
+
+			/** @brief Count of fragment bytes moved by bnj_fragcompact(). */
+			STREAM_OFFSET _compacted;
+
+			/** @brief Count of documents finished in a stream. */
+			STREAM_OFFSET _documents;
+
+			/** @brief How many code units remaining for ChunkRead*(). */
+			unsigned _chunk_remaining;
+
+			/** @brief Code unit size _chunk_remaining counts; 0 until the
+			 *  first ChunkRead*() on the current string. */
+			unsigned _chunk_width;
 
 			/** @brief Holds current user keyset. */
 			bnj_ctx _ctx;
 
 			/** @brief Parsing state. */
 			bnj_state _pstate;
+
+			/** @brief Last error status. */
+			mutable Error _err;
+
+			/** @brief Last error message or NULL; static storage. */
+			mutable const char* _err_blurb;
+
+			/** @brief Last error expected key enum or type. */
+			mutable unsigned _err_expected;
+
+			/** @brief Last error file offset. */
+			mutable STREAM_OFFSET _err_offset;
 	};
 
 
@@ -291,20 +677,93 @@ namespace BNJ {
 	 *  @param dest Where to store key string.
 	 *  @param destlen Maximum size of destination.
 	 *  @param p Parser instance.
-	 *  @return Number of bytes copied, excluding null terminator.
-	 *  @throw destlen < key length. */
+	 *  @return Number of bytes copied, excluding null terminator; 0 with
+	 *  dest set to "" when the key is empty or there is none.
+	 *  @throw destlen <= key length. */
 	unsigned GetKey(char* dest, unsigned destlen, const PullParser& p);
 
+	/** @brief GetKey() without exceptions.
+	 *  @return Number of bytes copied; < 0 on error. */
+	int TryGetKey(char* dest, unsigned destlen, const PullParser& p) throw();
+
+	/** @brief Copy exact text of a numeric value to destination buffer,
+	 *  with any leading '-'. For numbers too long for SIGNIFICAND.
+	 *  @param dest Where to store number text.
+	 *  @param destlen Maximum size of destination.
+	 *  @param p Parser instance.
+	 *  @return Number of bytes copied, excluding null terminator.
+	 *  @throw destlen <= text length or value not numeric. Also if the number
+	 *  text with its key did not fit in the buffer, so it was not kept. */
+	unsigned GetNumText(char* dest, unsigned destlen, const PullParser& p);
+
+	/** @brief GetNumText() without exceptions.
+	 *  @return Number of bytes copied; < 0 on error. */
+	int TryGetNumText(char* dest, unsigned destlen, const PullParser& p) throw();
+
+	/* Integers. Exact: values written with fractions or exponents are read
+	 * when integral (1e3, 10.0), without floating point. Throw invalid_value
+	 * when not integral or out of range of dest. */
+
+	void Get(uint8_t& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
+
+	void Get(int8_t& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
+
+	void Get(uint16_t& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
+
+	void Get(int16_t& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
+
 	void Get(unsigned& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
 
 	void Get(int& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
 
+	void Get(uint64_t& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
+
+	void Get(int64_t& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
+
+	/* Floating point and boolean. */
+
 	void Get(float& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
 
 	void Get(double& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
 
 	void Get(bool& dest, const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
 
+	/* Get() without exceptions. dest is unchanged on error.
+	 * Return ERR_NONE on success. */
+
+	PullParser::Error TryGet(uint8_t& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(int8_t& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(uint16_t& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(int16_t& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(unsigned& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(int& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(uint64_t& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(int64_t& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(float& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(double& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryGet(bool& dest, const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
 
 	/* Context/Value verification. */
 
@@ -313,6 +772,17 @@ namespace BNJ {
 	void VerifyList(const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
 
 	void VerifyMap(const PullParser& p, unsigned key_enum = 0xFFFFFFFF);
+
+	/* Verification without exceptions. Return ERR_NONE on success. */
+
+	PullParser::Error TryVerifyNull(const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryVerifyList(const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
+
+	PullParser::Error TryVerifyMap(const PullParser& p,
+		unsigned key_enum = 0xFFFFFFFF) throw();
 }
 
 /* Inlines */
@@ -326,8 +796,12 @@ inline const char* BNJ::PullParser::invalid_value::what(void) const throw(){
 }
 
 inline const bnj_val& BNJ::PullParser::GetValue(void) const{
+#ifndef BNJ_NO_EXCEPTIONS
 	if(!ValidValue())
 		throw input_error("No valid parser value!", _total_pulled);
+#else
+	assert(ValidValue());
+#endif
 	return _valbuff[_val_idx];
 }
 
@@ -371,8 +845,24 @@ inline unsigned BNJ::PullParser::BuffLen(void) const{
 	return _len;
 }
 
-inline unsigned BNJ::PullParser::TotalParsed() const{
+inline STREAM_OFFSET BNJ::PullParser::TotalParsed() const{
 	return _total_parsed;
 }
 
+inline STREAM_OFFSET BNJ::PullParser::Fragments() const{
+	return _fragments;
+}
+
+inline STREAM_OFFSET BNJ::PullParser::CompactedBytes() const{
+	return _compacted;
+}
+
+inline STREAM_OFFSET BNJ::PullParser::Documents() const{
+	return _documents;
+}
+
+inline BNJ::PullParser::Error BNJ::PullParser::LastError(void) const{
+	return _err;
+}
+
 #endif
@@ -0,0 +1,449 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#include <cstring>
+#include "query.hh"
+
+/* Bit numbers by the top 6 bits of a single bit times a de Bruijn
+ * sequence. */
+static const unsigned char s_debruijn[64] = {
+	0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+	62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+	63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+	46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+};
+
+/* @return Number of the lowest set bit of x; x must be nonzero. */
+static inline unsigned s_lowest(uint64_t x){
+	return s_debruijn[((x & -x) * 0x03F79D71B4CB0A89ULL) >> 58];
+}
+
+BNJ::PathQuery::Handler::~Handler() throw(){
+}
+
+void BNJ::PathQuery::Handler::Value(PullParser& parser){
+}
+
+void BNJ::PathQuery::StorageSize(char const * const * queries, unsigned count,
+	unsigned& steps, unsigned& text, unsigned& words) throw()
+{
+	/* Every step begins with '.' or '[', plus the END step. Counting them in
+	 * quoted keys and ".." too only overestimates. Unescaped keys with their
+	 * terminators take no more than the query text. */
+	steps = 0;
+	text = 0;
+	for(unsigned i = 0; i < count; ++i){
+		++steps;
+		for(const char* c = queries[i]; *c; ++c){
+			if('.' == *c || '[' == *c)
+				++steps;
+			++text;
+		}
+	}
+	words = 2 * ((steps + 63) / 64);
+}
+
+BNJ::PathQuery::PathQuery(Step* steps, const char** keys, unsigned step_len,
+	char* text, unsigned text_len, uint64_t* sets, unsigned set_len) throw()
+	: _steps(steps), _keys(keys), _step_len(step_len), _step_count(0),
+	_key_count(0), _text(text), _text_len(text_len), _sets(sets),
+	_set_len(set_len), _words(0), _matches(0)
+{
+}
+
+const char* BNJ::PathQuery::Compile(char const * const * queries,
+	unsigned count) throw()
+{
+	_step_count = 0;
+	_key_count = 0;
+	_words = 0;
+
+	const char* err = NULL;
+	unsigned t = 0;
+	for(unsigned i = 0; i < count && !err; ++i){
+		const char* c = queries[i];
+		if('$' != *c){
+			err = "JSONPath query must start with '$'!";
+			break;
+		}
+		++c;
+
+		while(*c && !err){
+			if('.' != *c && '[' != *c){
+				err = "JSONPath step must start with '.' or '['!";
+				break;
+			}
+
+			/* Leave room for the END step. */
+			if(_step_count + 1 >= _step_len){
+				err = "PathQuery: out of step storage!";
+				break;
+			}
+			Step& st = _steps[_step_count++];
+			st.key = NULL;
+			st.key_enum = 0;
+			st.index = 0;
+			st.query = i;
+			st.type = ANY;
+			st.descend = false;
+
+			if('.' == *c){
+				++c;
+				if('.' == *c){
+					st.descend = true;
+					++c;
+				}
+				else if('[' == *c){
+					err = "JSONPath step is empty!";
+					break;
+				}
+			}
+
+			if('[' != *c){
+				/* Dot notation name, or '*'. */
+				if('*' == *c && ('.' == c[1] || '[' == c[1] || !c[1])){
+					++c;
+					continue;
+				}
+				char* key = _text + t;
+				while(*c && '.' != *c && '[' != *c){
+					if(t == _text_len){
+						err = "PathQuery: out of text storage!";
+						break;
+					}
+					_text[t++] = *c++;
+				}
+				if(err)
+					break;
+				if(key == _text + t){
+					err = "JSONPath step is empty!";
+					break;
+				}
+				if(t == _text_len){
+					err = "PathQuery: out of text storage!";
+					break;
+				}
+				_text[t++] = '\0';
+				st.key = key;
+				st.type = KEY;
+				continue;
+			}
+
+			/* Bracket notation. */
+			++c;
+			if('*' == *c){
+				++c;
+			}
+			else if('\'' == *c || '"' == *c){
+				const char quote = *c++;
+				char* key = _text + t;
+				while(*c && quote != *c){
+					if('\\' == *c && !*++c)
+						break;
+					if(t == _text_len){
+						err = "PathQuery: out of text storage!";
+						break;
+					}
+					_text[t++] = *c++;
+				}
+				if(err)
+					break;
+				if(!*c){
+					err = "JSONPath key is missing its closing quote!";
+					break;
+				}
+				++c;
+				if(t == _text_len){
+					err = "PathQuery: out of text storage!";
+					break;
+				}
+				_text[t++] = '\0';
+				st.key = key;
+				st.type = KEY;
+			}
+			else if(*c >= '0' && *c <= '9'){
+				unsigned index = 0;
+				for(; *c >= '0' && *c <= '9'; ++c){
+					const unsigned d = *c - '0';
+					if(index > (0xFFFFFFFF - d) / 10){
+						err = "JSONPath index out of range!";
+						break;
+					}
+					index = index * 10 + d;
+				}
+				if(err)
+					break;
+				st.index = index;
+				st.type = INDEX;
+			}
+			else{
+				err = "JSONPath brackets need an index, '*' or quoted key!";
+				break;
+			}
+
+			if(']' != *c){
+				err = "JSONPath query is missing ']'!";
+				break;
+			}
+			++c;
+		}
+		if(err)
+			break;
+
+		if(_step_count == _step_len){
+			err = "PathQuery: out of step storage!";
+			break;
+		}
+		Step& end = _steps[_step_count++];
+		end.key = NULL;
+		end.key_enum = 0;
+		end.index = 0;
+		end.query = i;
+		end.type = END;
+		end.descend = false;
+	}
+
+	/* Literal keys of all queries form one sorted key set without
+	 * duplicates. */
+	for(unsigned j = 0; j < _step_count && !err; ++j){
+		if(KEY != _steps[j].type)
+			continue;
+		const char* key = _steps[j].key;
+		unsigned k = 0;
+		while(k < _key_count && strcmp(_keys[k], key) < 0)
+			++k;
+		if(k < _key_count && !strcmp(_keys[k], key))
+			continue;
+		for(unsigned m = _key_count; m > k; --m)
+			_keys[m] = _keys[m - 1];
+		_keys[k] = key;
+		++_key_count;
+	}
+	for(unsigned j = 0; j < _step_count && !err; ++j){
+		if(KEY != _steps[j].type)
+			continue;
+		unsigned k = 0;
+		while(strcmp(_keys[k], _steps[j].key))
+			++k;
+		_steps[j].key_enum = k;
+	}
+
+	_words = (_step_count + 63) / 64;
+	if(!err && 2 * _words > _set_len)
+		err = "PathQuery: out of set storage!";
+
+	if(err){
+		/* Leave no queries. */
+		_step_count = 0;
+		_key_count = 0;
+		_words = 0;
+		return err;
+	}
+	return NULL;
+}
+
+#ifndef BNJ_NO_EXCEPTIONS
+unsigned BNJ::PathQuery::Extract(PullParser& parser, Handler& handler){
+	const int ret = TryExtract(parser, handler);
+	if(ret < 0)
+		parser.ThrowError();
+	return ret;
+}
+#endif
+
+int BNJ::PathQuery::TryExtract(PullParser& parser, Handler& handler){
+	/* Finish the document an earlier call left early. */
+	while(parser.Depth()){
+		if(PullParser::ST_ERROR == parser.TryUp())
+			return -1;
+	}
+
+	PullParser::State s = parser.TryPull();
+	if(PullParser::ST_DOC_END == s)
+		s = parser.TryPull();
+	if(PullParser::ST_ERROR == s)
+		return -1;
+	if(PullParser::ST_NO_DATA == s)
+		return 0;
+
+	if(!_step_count)
+		return PullParser::ST_ERROR == parser.TrySkip() ? -1 : 0;
+
+	/* The document's value has reached the first step of each query. */
+	memset(_sets, 0, _words * sizeof(uint64_t));
+	_sets[0] = 1;
+	for(unsigned j = 1; j < _step_count; ++j){
+		if(END == _steps[j - 1].type)
+			_sets[j / 64] |= (uint64_t)1 << (j % 64);
+	}
+
+	_matches = 0;
+	if(!Visit(parser, handler, 0, s, false))
+		return -1;
+	return _matches;
+}
+
+bool BNJ::PathQuery::Visit(PullParser& parser, Handler& handler,
+	unsigned level, PullParser::State s, bool whole)
+{
+	/* Each level holds the steps reached, then the steps every child of the
+	 * value reaches whatever its key or index. */
+	uint64_t* set = _sets + level * 2 * _words;
+	uint64_t* base = set + _words;
+	const bool container =
+		PullParser::ST_MAP == s || PullParser::ST_LIST == s;
+	const bool map = PullParser::ST_MAP == s;
+	const unsigned depth = parser.Depth();
+
+	/* Report queries ending here. Of the steps going on, ANY steps and
+	 * descending steps go to the base set; only KEY steps in a map or INDEX
+	 * steps in a list stay to be matched per child. */
+	bool reached = false;
+	bool ended = false;
+	bool keys = false;
+	bool matched = false;
+	const Type literal = map ? KEY : INDEX;
+	for(unsigned w = 0; w < _words; ++w)
+		base[w] = 0;
+	for(unsigned w = 0; w < _words; ++w){
+		for(uint64_t bits = set[w]; bits; bits &= bits - 1){
+			const unsigned b = s_lowest(bits);
+			const unsigned j = w * 64 + b;
+			const Step& st = _steps[j];
+			if(END != st.type){
+				if(!container || (ANY != st.type && literal != st.type
+					&& !st.descend))
+				{
+					set[w] &= ~((uint64_t)1 << b);
+					continue;
+				}
+				if(ANY == st.type){
+					base[(j + 1) / 64] |= (uint64_t)1 << ((j + 1) % 64);
+					ended = ended || END == _steps[j + 1].type;
+					reached = true;
+				}
+				if(st.descend){
+					base[w] |= (uint64_t)1 << b;
+					reached = true;
+				}
+				if(literal == st.type)
+					keys = true;
+				else
+					set[w] &= ~((uint64_t)1 << b);
+				continue;
+			}
+
+			set[w] &= ~((uint64_t)1 << b);
+			++_matches;
+			matched = true;
+			handler.Match(st.query, parser);
+
+			/* Later queries and matches inside need the value unread. */
+			if(parser.GetState() != s || parser.Depth() != depth){
+				parser.SetError(PullParser::ERR_TYPE,
+					"PathQuery: handler pulled in Match()!");
+				return false;
+			}
+		}
+	}
+
+	/* The value is read once for all queries matching it, and for those it
+	 * lies inside. */
+	whole = whole || matched;
+	if(whole)
+		handler.Value(parser);
+
+	/* No steps continue through scalars. */
+	if(!container)
+		return true;
+	if(!reached && !keys)
+		return Leave(parser, handler, depth, whole);
+
+	if((level + 2) * 2 * _words > _set_len){
+		parser.SetError(PullParser::ERR_LENGTH,
+			"PathQuery: document nests deeper than sets hold!");
+		return false;
+	}
+	uint64_t* child = base + _words;
+
+	char const * const * key_set = (map && keys) ? _keys : NULL;
+	const unsigned key_set_length = key_set ? _key_count : 0;
+	unsigned index = 0;
+	while(true){
+		const PullParser::State c = parser.TryPull(key_set, key_set_length);
+		if(PullParser::ST_ERROR == c)
+			return false;
+
+		/* Left the container. */
+		if(parser.Depth() < depth){
+			if(whole)
+				handler.Value(parser);
+			return true;
+		}
+
+		/* Advance literal steps matching the child. A member key or index
+		 * matches only once, so steps not descending are then done. */
+		const unsigned k = key_set ? parser.GetValue().key_enum : 0;
+		const unsigned i = index++;
+		bool child_reached = reached;
+		bool child_ended = ended;
+		keys = false;
+		for(unsigned w = 0; w < _words; ++w)
+			child[w] = base[w];
+		for(unsigned w = 0; w < _words; ++w){
+			for(uint64_t bits = set[w]; bits; bits &= bits - 1){
+				const unsigned b = s_lowest(bits);
+				const unsigned j = w * 64 + b;
+				const Step& st = _steps[j];
+				if(map ? k != st.key_enum : i != st.index){
+					keys = true;
+					continue;
+				}
+
+				child[(j + 1) / 64] |= (uint64_t)1 << ((j + 1) % 64);
+				child_ended = child_ended || END == _steps[j + 1].type;
+				child_reached = true;
+				if(st.descend)
+					keys = true;
+				else
+					set[w] &= ~((uint64_t)1 << b);
+			}
+		}
+
+		/* Scalars only matter where a query ends. */
+		if(child_ended || (child_reached
+			&& (PullParser::ST_MAP == c || PullParser::ST_LIST == c)))
+		{
+			if(!Visit(parser, handler, level + 1, c, whole))
+				return false;
+		}
+		else if(whole){
+			handler.Value(parser);
+			if((PullParser::ST_MAP == c || PullParser::ST_LIST == c)
+				&& !Leave(parser, handler, parser.Depth(), true))
+			{
+				return false;
+			}
+		}
+		else if(PullParser::ST_ERROR == parser.TrySkip()){
+			return false;
+		}
+
+		/* Nothing more can match in this container. */
+		if(!reached && !keys)
+			return Leave(parser, handler, depth, whole);
+	}
+}
+
+bool BNJ::PathQuery::Leave(PullParser& parser, Handler& handler,
+	unsigned depth, bool whole)
+{
+	if(!whole)
+		return PullParser::ST_ERROR != parser.TryUp();
+	while(parser.Depth() >= depth){
+		if(PullParser::ST_ERROR == parser.TryPull())
+			return false;
+		handler.Value(parser);
+	}
+	return true;
+}
@@ -0,0 +1,201 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#ifndef __BENEGON_JSON_QUERY_HH__
+#define __BENEGON_JSON_QUERY_HH__
+
+#include <stdint.h>
+#include "pull.hh"
+
+namespace BNJ {
+	/** @brief Set of JSONPath queries matched against a document in one pass.
+	 * Supported steps, after a leading '$':
+	 *  .name ['name'] ["name"]  member; '\' escapes the next character.
+	 *  [n]                      array element.
+	 *  .* [*]                   any member or element.
+	 *  ..name ..* ..[n] ..['name']  same, at any depth below.
+	 *
+	 * Queries compile into one automaton over path steps. Each value pulled
+	 * has the set of steps its path reached, derived from its parent's set,
+	 * so memory is a pair of sets per nesting level. Literal keys of all queries
+	 * form one key set, so each member costs one match; values no step can
+	 * reach are skipped without parsing their contents, and a map or list is
+	 * left once no step can match more of it. Inside a matched map or list,
+	 * every value is pulled and handed to the Handler instead, so matches
+	 * nested in others, or of several queries at one value, are all reported.
+	 *
+	 * A value matches a query at most once, even when several paths of the
+	 * query lead to it. Map keys compare once unescaped, as PullParser key
+	 * sets do. Of duplicate keys in a map, only the first matches a literal
+	 * step.
+	 *
+	 * Storage is caller provided; see StorageSize(). */
+	class PathQuery {
+		public:
+			/** @brief Kind of step. */
+			enum Type {
+				/** @brief Map member by key. */
+				KEY,
+
+				/** @brief Array element by index. */
+				INDEX,
+
+				/** @brief Any member or element. */
+				ANY,
+
+				/** @brief Query matched. */
+				END
+			};
+
+			/** @brief Compiled step. Filled in by Compile(). */
+			typedef struct {
+				/** @brief Unescaped key of a KEY step. */
+				const char* key;
+
+				/** @brief Key set entry of key. */
+				unsigned key_enum;
+
+				/** @brief Element index of an INDEX step. */
+				unsigned index;
+
+				/** @brief Query the step belongs to. */
+				unsigned query;
+
+				/** @brief Kind of step. */
+				Type type;
+
+				/** @brief Whether the step may match at any depth below. */
+				bool descend;
+			} Step;
+
+			/** @brief Receives values matching queries. */
+			class Handler {
+				public:
+					virtual ~Handler() throw();
+
+					/** @brief Called at the value of a query, in document order;
+					 *  queries matching the same value are called in query order,
+					 *  before the value is read. Parser state is ST_DATUM, ST_MAP or
+					 *  ST_LIST. The value is read in Value(); Match() may look at it
+					 *  with GetValue() but must not pull.
+					 *  @param query Index of the query given to Compile().
+					 *  @param parser Parser at the value. */
+					virtual void Match(unsigned query, PullParser& parser) = 0;
+
+					/** @brief Called once at a matched value after its Match()
+					 *  calls, then at each value and each end inside a matched map
+					 *  or list, in document order; so matches overlapping in any way
+					 *  each see their whole value. A scalar may be read with
+					 *  GetValue(), Get() or ChunkRead*(); a member's key with GetKey().
+					 *  Must not pull; the contents of a map or list follow as later
+					 *  calls, up to its ST_ASCEND_MAP or ST_ASCEND_LIST.
+					 *  Does nothing unless overridden.
+					 *  @param parser Parser at the value or end. */
+					virtual void Value(PullParser& parser);
+			};
+
+			/** @brief Storage Compile() needs.
+			 *  @param queries JSONPath queries.
+			 *  @param count Length of queries.
+			 *  @param steps Set to entries needed in steps and keys.
+			 *  @param text Set to bytes needed in text.
+			 *  @param words Set to entries needed in sets per nesting level. A
+			 *  document nested n deep takes n + 1 levels. */
+			static void StorageSize(char const * const * queries, unsigned count,
+				unsigned& steps, unsigned& text, unsigned& words) throw();
+
+			/** @brief Initialize with storage for compiled queries.
+			 *  @param steps Compiled steps.
+			 *  @param keys Key set; same length as steps.
+			 *  @param step_len Length of steps and keys.
+			 *  @param text Unescaped keys.
+			 *  @param text_len Length of text.
+			 *  @param sets Step sets of nesting levels.
+			 *  @param set_len Length of sets. */
+			PathQuery(Step* steps, const char** keys, unsigned step_len,
+				char* text, unsigned text_len, uint64_t* sets, unsigned set_len)
+				throw();
+
+			/** @brief Compile JSONPath queries, replacing any previous ones.
+			 *  @param queries Queries; need not outlive this call.
+			 *  @param count Length of queries.
+			 *  @return NULL on success; otherwise a static error message. */
+			const char* Compile(char const * const * queries, unsigned count)
+				throw();
+
+			/** @brief Match the queries against the next document.
+			 *  Pulls the document's value, then returns once the document
+			 *  ended or nothing more can match. An earlier call's document is
+			 *  finished first, so with SetFraming() each call handles the next
+			 *  document of the stream.
+			 *  @param parser Parser after Begin*(), or after a previous call.
+			 *  @param handler Receives the values.
+			 *  @return Matches found. 0 with parser.GetState() == ST_NO_DATA
+			 *  when no document is left.
+			 *  @throw on parsing errors, as Pull(), when the document nests
+			 *  deeper than sets hold, or when handler pulls in Match(). */
+#ifndef BNJ_NO_EXCEPTIONS
+			unsigned Extract(PullParser& parser, Handler& handler);
+#endif
+
+			/** @brief Extract() without exceptions from parsing; exceptions
+			 *  from handler pass through.
+			 *  @return Matches found; < 0 on errors, see parser.LastError(). */
+			int TryExtract(PullParser& parser, Handler& handler);
+
+		private:
+			PathQuery(const PathQuery& q);
+			PathQuery& operator=(const PathQuery& q);
+
+			/** @brief Report matches at and below the value of a level.
+			 *  @param level Nesting level; its set holds the steps reached.
+			 *  @param s Parser state at the value.
+			 *  @param whole Whether the value lies in a matched map or list, so
+			 *  all of it goes to handler.Value().
+			 *  @return false on parsing errors. */
+			bool Visit(PullParser& parser, Handler& handler, unsigned level,
+				PullParser::State s, bool whole);
+
+			/** @brief Leave the map or list at depth.
+			 *  @param whole Pass what is left of it to handler.Value().
+			 *  @return false on parsing errors. */
+			bool Leave(PullParser& parser, Handler& handler, unsigned depth,
+				bool whole);
+
+			/** @brief Steps of all queries; each query ends with an END step. */
+			Step* _steps;
+
+			/** @brief Sorted literal keys. */
+			const char** _keys;
+
+			/** @brief Length of _steps and _keys. */
+			unsigned _step_len;
+
+			/** @brief Steps in use. */
+			unsigned _step_count;
+
+			/** @brief Keys in use. */
+			unsigned _key_count;
+
+			/** @brief Unescaped key storage. */
+			char* _text;
+
+			/** @brief Length of _text. */
+			unsigned _text_len;
+
+			/** @brief Per level, the set of steps reached and the set every
+			 *  child reaches; _words each. */
+			uint64_t* _sets;
+
+			/** @brief Length of _sets. */
+			unsigned _set_len;
+
+			/** @brief Words in a step set. */
+			unsigned _words;
+
+			/** @brief Matches in the current document. */
+			unsigned _matches;
+	};
+}
+
+#endif
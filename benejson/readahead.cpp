@@ -0,0 +1,103 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#include <cstring>
+#include "readahead.hh"
+
+BNJ::ReadAheadReader::ReadAheadReader(PullParser::Reader& src, uint8_t* ring,
+	unsigned len)
+	: _src(src), _ring(ring), _len(len), _head(0), _tail(0), _end(1),
+	_stop(false), _fill_sleeping(false), _read_sleeping(false),
+	_thread(&ReadAheadReader::Fill, this)
+{
+}
+
+BNJ::ReadAheadReader::~ReadAheadReader() throw(){
+	_stop = true;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_wake.notify_all();
+	}
+	_thread.join();
+}
+
+/* Sleeping side sets its flag before checking its condition, and the other
+ * side publishes its counter before checking that flag. With sequentially
+ * consistent atomics at least one of them sees the other, so no wake up is
+ * lost. Each side clears only its own flag. */
+
+void BNJ::ReadAheadReader::Fill(void) throw(){
+	while(!_stop){
+		const unsigned long long h = _head.load(std::memory_order_relaxed);
+		const unsigned long long t = _tail;
+
+		/* Ring full, wait for Read() to drain some. */
+		if(h - t == _len){
+			std::unique_lock<std::mutex> lock(_mutex);
+			_fill_sleeping = true;
+			while(_tail == t && !_stop)
+				_wake.wait(lock);
+			_fill_sleeping = false;
+			continue;
+		}
+
+		/* Read as much as fits without wrapping. */
+		const unsigned at = h % _len;
+		unsigned space = _len - (unsigned)(h - t);
+		if(space > _len - at)
+			space = _len - at;
+		const int ret = _src.Read(_ring + at, space);
+
+		/* Publish data, or the end of it. */
+		if(ret > 0)
+			_head = h + ret;
+		else
+			_end = ret;
+
+		if(_read_sleeping){
+			std::lock_guard<std::mutex> lock(_mutex);
+			_wake.notify_all();
+		}
+
+		if(ret <= 0)
+			return;
+	}
+}
+
+int BNJ::ReadAheadReader::Read(uint8_t* buff, unsigned len) throw(){
+	const unsigned long long t = _tail.load(std::memory_order_relaxed);
+	unsigned long long h = _head;
+
+	/* Nothing read ahead. If Fill() is done, _head is final once _end is. */
+	while(h == t){
+		const int end = _end;
+		h = _head;
+		if(h != t)
+			break;
+		if(end <= 0)
+			return end;
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		_read_sleeping = true;
+		while(_head == t && _end > 0)
+			_wake.wait(lock);
+		_read_sleeping = false;
+		h = _head;
+	}
+
+	/* Copy out, in two parts if the data wraps around the ring. */
+	unsigned avail = (unsigned)(h - t);
+	if(len > avail)
+		len = avail;
+	const unsigned at = t % _len;
+	const unsigned first = (len < _len - at) ? len : _len - at;
+	memcpy(buff, _ring + at, first);
+	memcpy(buff + first, _ring, len - first);
+
+	_tail = t + len;
+	if(_fill_sleeping){
+		std::lock_guard<std::mutex> lock(_mutex);
+		_wake.notify_all();
+	}
+	return len;
+}
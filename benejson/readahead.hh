@@ -0,0 +1,87 @@
+/* Copyright (c) 2010 David Bender assigned to Benegon Enterprises LLC
+ * See the file LICENSE for full license information. */
+
+#ifndef __BENEGON_JSON_READ_AHEAD_HH__
+#define __BENEGON_JSON_READ_AHEAD_HH__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "pull.hh"
+
+namespace BNJ {
+	/** @brief Reader adapter that reads ahead on a helper thread.
+	 * The helper thread keeps a ring of input filled from another Reader while
+	 * PullParser parses. Read() copies out of the ring, so I/O waits overlap
+	 * parsing instead of stalling it.
+	 *
+	 * Handoff is lock free: producer and consumer only publish byte counters.
+	 * The mutex is taken only when one side must sleep on an empty or full
+	 * ring.
+	 *
+	 * The source Reader is only called from the helper thread. Once Read()
+	 * returns 0 or < 0, the source may be examined again from the caller's
+	 * thread. */
+	class ReadAheadReader : public PullParser::Reader {
+		public:
+			/** @brief Start reading ahead from src.
+			 *  @param src Where to read data from; must outlive this instance.
+			 *  @param ring Preallocated memory for data read ahead.
+			 *  Should be a few times the PullParser buffer size.
+			 *  @param len Size of ring.
+			 *  @throw std::system_error if the helper thread cannot start. */
+			ReadAheadReader(PullParser::Reader& src, uint8_t* ring, unsigned len);
+
+			/** @brief Stop and join the helper thread.
+			 *  Waits for a Read() in progress on the source to return. */
+			~ReadAheadReader() throw();
+
+			/** @brief Override. Blocks only if no data was read ahead. */
+			int Read(uint8_t* buff, unsigned len) throw();
+
+		private:
+			ReadAheadReader(const ReadAheadReader& r);
+			ReadAheadReader& operator=(const ReadAheadReader& r);
+
+			/** @brief Helper thread body. */
+			void Fill(void) throw();
+
+			/** @brief Source of data. */
+			PullParser::Reader& _src;
+
+			/** @brief Ring storage. */
+			uint8_t* _ring;
+
+			/** @brief Length of _ring. */
+			const unsigned _len;
+
+			/** @brief Total bytes written into the ring. Only Fill() stores. */
+			std::atomic<unsigned long long> _head;
+
+			/** @brief Total bytes read from the ring. Only Read() stores. */
+			std::atomic<unsigned long long> _tail;
+
+			/** @brief Last source Read() result once it was 0 or < 0. */
+			std::atomic<int> _end;
+
+			/** @brief Set when the destructor wants Fill() to return. */
+			std::atomic<bool> _stop;
+
+			/** @brief Set while Fill() sleeps on a full ring. */
+			std::atomic<bool> _fill_sleeping;
+
+			/** @brief Set while Read() sleeps on an empty ring. */
+			std::atomic<bool> _read_sleeping;
+
+			/** @brief Sleep support for empty or full ring. */
+			std::mutex _mutex;
+			std::condition_variable _wake;
+
+			/** @brief Helper thread; last so it starts after everything else. */
+			std::thread _thread;
+	};
+}
+
+#endif
@@ -0,0 +1,191 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+#include <benejson/filter.hh>
+
+/* NDJSON record filter benchmark.
+ * Generates log records, each a "heartbeat" or an "event", and keeps the
+ * events: once parsing whole records and testing the type afterwards, once
+ * with a RecordFilter rejecting records at their type, and once more with
+ * its projection. Repeats for several shares of events; prints records/s.
+ * All passes must agree.
+ * Usage: filterbench [doc_mb] */
+
+using BNJ::PullParser;
+using BNJ::RecordFilter;
+
+static unsigned s_rng = 12345;
+
+static unsigned s_rand(void){
+	s_rng = s_rng * 1103515245 + 12345;
+	return (s_rng >> 16) & 0x7FFF;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Sorted keys of the fields read. */
+static const char* s_keys[] = {"host", "ts", "type"};
+
+enum {
+	KEY_HOST,
+	KEY_TS,
+	KEY_TYPE,
+	KEY_COUNT
+};
+
+/* Sums ts and host lengths of a record. */
+class Summer : public RecordFilter::Handler {
+	public:
+		Summer(void) throw() : sum(0), record(0) {}
+
+		void Begin(void){
+			record = 0;
+		}
+
+		void Field(unsigned field, PullParser& parser){
+			if(KEY_TS == field)
+				record += parser.GetValue().significand_val;
+			else
+				record += parser.ChunkRead8(host, sizeof(host));
+		}
+
+		unsigned long long sum;
+		unsigned long long record;
+		char host[64];
+};
+
+/* Parse every record whole; keep events. */
+static unsigned long long s_whole(const uint8_t* doc, size_t len){
+	uint32_t pstack[16];
+	PullParser parser(16, pstack);
+	parser.Begin(doc, len);
+	parser.SetFraming(PullParser::FRAME_LINES);
+
+	unsigned long long sum = 0;
+	char str[64];
+	while(true){
+		PullParser::State s = parser.Pull();
+		if(PullParser::ST_DOC_END == s)
+			s = parser.Pull();
+		if(PullParser::ST_NO_DATA == s)
+			break;
+
+		unsigned long long record = 0;
+		bool event = false;
+		while(parser.Pull(s_keys, KEY_COUNT) != PullParser::ST_ASCEND_MAP){
+			switch(parser.GetValue().key_enum){
+				case KEY_HOST:
+					record += parser.ChunkRead8(str, sizeof(str));
+					break;
+
+				case KEY_TS:
+					record += parser.GetValue().significand_val;
+					break;
+
+				case KEY_TYPE:
+					{
+						unsigned n = parser.ChunkRead8(str, sizeof(str));
+						event = (5 == n) && !memcmp(str, "event", 5);
+					}
+					break;
+
+				default:
+					parser.Skip();
+			}
+		}
+		if(event)
+			sum += record;
+	}
+	return sum;
+}
+
+/* Keep events with a RecordFilter. */
+static unsigned long long s_filter(const uint8_t* doc, size_t len,
+	bool project)
+{
+	const RecordFilter::Predicate predicates[] = {
+		{"type", RecordFilter::EQUALS, "event", 0, 0}
+	};
+	static const char* fields[] = {"host", "ts"};
+	RecordFilter::Slot slots[3];
+	const char* keys[3];
+	RecordFilter filter(slots, keys, 3);
+	if(filter.Compile(predicates, 1, fields, 2))
+		return 0;
+
+	uint32_t pstack[16];
+	PullParser parser(16, pstack);
+	parser.Begin(doc, len);
+	parser.SetFraming(PullParser::FRAME_LINES);
+	if(project)
+		parser.SetProjection(filter.Projection());
+
+	Summer summer;
+	while(filter.Next(parser, summer))
+		summer.sum += summer.record;
+	return summer.sum;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 32;
+
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = (uint8_t*)malloc(cap + 1024);
+
+	static const unsigned percents[] = {1, 10, 50, 100};
+	for(unsigned p = 0; p < sizeof(percents) / sizeof(percents[0]); ++p){
+		/* Records of about 400 bytes, the type near the front. */
+		size_t len = 0;
+		unsigned records = 0;
+		while(len < cap){
+			const bool event = s_rand() % 100 < percents[p];
+			len += sprintf((char*)doc + len,
+				"{\"ts\":%u,\"type\":\"%s\",\"host\":\"host%02u\",\"seq\":%u,"
+				"\"payload\":{\"msg\":\"", s_rand(),
+				event ? "event" : "heartbeat", s_rand() % 64, s_rand());
+			for(unsigned c = 0; c < 200; ++c)
+				doc[len++] = 'a' + s_rand() % 26;
+			len += sprintf((char*)doc + len,
+				"\",\"vals\":[%u,%u,%u,%u],\"ok\":true},"
+				"\"tags\":[\"t%u\",\"t%u\",\"t%u\"],\"level\":%u}\n",
+				s_rand(), s_rand(), s_rand(), s_rand(), s_rand() % 8, s_rand() % 8,
+				s_rand() % 8, s_rand() % 5);
+			++records;
+		}
+
+		unsigned long long sums[3];
+		double times[3];
+
+		double begin = s_now();
+		sums[0] = s_whole(doc, len);
+		times[0] = s_now() - begin;
+
+		begin = s_now();
+		sums[1] = s_filter(doc, len, false);
+		times[1] = s_now() - begin;
+
+		begin = s_now();
+		sums[2] = s_filter(doc, len, true);
+		times[2] = s_now() - begin;
+
+		printf("%3u%% events, %u records: whole %.2fM/s, filter %.2fM/s, "
+			"filter with projection %.2fM/s\n", percents[p], records,
+			records / times[0] / 1e6, records / times[1] / 1e6,
+			records / times[2] / 1e6);
+
+		if(sums[1] != sums[0] || sums[2] != sums[0]){
+			fprintf(stderr, "checksum mismatch\n");
+			free(doc);
+			return 1;
+		}
+	}
+
+	free(doc);
+	return 0;
+}
@@ -0,0 +1,181 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <benejson/filter.hh>
+#include "posix.hh"
+
+/* Record filter tests. Each NDJSON stream is filtered in place and through
+ * readers fed a few bytes per read into a small buffer, so members span
+ * refills, with and without the filter's projection. The "id" field of each
+ * record passing is traced, then accepted and rejected counts. */
+
+using BNJ::PullParser;
+using BNJ::RecordFilter;
+
+/* Long enough that records span several refills of the buffer. */
+#define PAD "\"pad\":\"0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdef\","
+
+struct filter_test {
+	const char* json;
+	RecordFilter::Predicate predicates[3];
+	unsigned count;
+	const char* trace;
+};
+
+static const filter_test s_filter[] = {
+	/* PREFIX: decided within the string, at its end, or not a string. */
+	{
+		"{\"id\":1,\"s\":\"abc\"}\n"
+		"{\"id\":2,\"s\":\"xab\"}\n"
+		"{\"id\":3,\"s\":\"ab\"}\n"
+		"{\"id\":4,\"s\":\"a\"}\n"
+		"{\"id\":5,\"s\":1}\n"
+		"{\"id\":6}\n"
+		"{" PAD "\"s\":\"ab0123456789abcdefghijklmnopqrstuvwxyz\",\"id\":7}\n"
+		"{\"id\":8,\"s\":\"\\u0061\\u0062c\"}\n"
+		"{\"id\":9," PAD "\"s\":\"a0123456789abcdefghijklmnopqrstuvwxyz\"}\n",
+		{{"s", RecordFilter::PREFIX, "ab", 0, 0}}, 1, "1 3 7 8 /4/5"
+	},
+	{
+		"{\"id\":1,\"s\":\"0123456789abcdefghijklmnopqrstuvwxyz0123456789\"}\n"
+		"{\"id\":2,\"s\":\"0123456789abcdefghijklmnopqrstuvwxyz012345678\"}\n"
+		"{\"id\":3,\"s\":\"0123456789abcdefghijklmnopqrstuvwxyz01234567899\"}\n",
+		{{"s", RecordFilter::PREFIX,
+			"0123456789abcdefghijklmnopqrstuvwxyz0123456789", 0, 0}}, 1,
+		"1 3 /2/1"
+	},
+
+	/* RANGE: inclusive bounds, any spelling of a number. */
+	{
+		"{\"id\":1,\"n\":1.5}\n"
+		"{\"id\":2,\"n\":10}\n"
+		"{\"id\":3,\"n\":10.0001}\n"
+		"{\"id\":4,\"n\":-3}\n"
+		"{\"id\":5,\"n\":\"5\"}\n"
+		"{\"id\":6,\"n\":1e1}\n"
+		"{\"id\":7," PAD "\"n\":15e-1}\n"
+		"{\"id\":8,\"n\":1.4999999999}\n"
+		"{\"id\":9}\n"
+		"{\"id\":10,\"n\":[5]}\n"
+		"{" PAD "\"n\":3.25,\"id\":11}\n",
+		{{"n", RecordFilter::RANGE, NULL, 1.5, 10}}, 1, "1 2 6 7 11 /5/6"
+	},
+
+	/* ABSENT: any value of the member rejects, wherever it is. */
+	{
+		"{\"id\":1}\n"
+		"{\"id\":2,\"x\":null}\n"
+		"{\"x\":{\"a\":[1]},\"id\":3}\n"
+		"{\"id\":4," PAD "\"y\":1}\n"
+		"{\"id\":5," PAD "\"x\":1}\n"
+		"{}\n"
+		"{\"id\":7,\"xx\":1,\"X\":2}\n"
+
+		/* Rejected while the parser is inside a nested key. */
+		"{\"x\":0,\"m\":{\"0123456789abcdefghij\":{\"0123456789abcdef\":1}}}\n"
+		"{\"x\":10,\"m\":{\"0123456789abcdefghij\":{\"0123456789abcdef\":1}}}\n"
+		"{\"x\":200,\"m\":{\"0123456789abcdefghij\":{\"0123456789abcdef\":1}}}\n"
+		"{\"id\":11}\n",
+		{{"x", RecordFilter::ABSENT, NULL, 0, 0}}, 1, "1 4 0 7 11 /5/6"
+	},
+
+	/* All must hold. */
+	{
+		"{\"id\":1,\"k\":\"v\",\"n\":2}\n"
+		"{\"id\":2,\"k\":\"v\",\"n\":2,\"x\":0}\n"
+		"{\"id\":3,\"k\":\"w\",\"n\":2}\n"
+		"{\"id\":4,\"n\":6,\"k\":\"v\"}\n"
+		"{\"n\":0," PAD "\"k\":\"v\",\"id\":5}\n"
+		"{\"id\":6,\"n\":0}\n"
+		"[1]\n"
+		"7\n",
+		{
+			{"k", RecordFilter::EQUALS, "v", 0, 0},
+			{"n", RecordFilter::RANGE, NULL, 0, 5},
+			{"x", RecordFilter::ABSENT, NULL, 0, 0}
+		}, 3, "1 5 /2/6"
+	},
+};
+
+/* Keep the id of the current record. */
+class Recorder : public RecordFilter::Handler {
+	public:
+		void Begin(void){
+			id = 0;
+		}
+
+		void Field(unsigned field, PullParser& parser){
+			BNJ::Get(id, parser);
+		}
+
+		unsigned id;
+};
+
+/* @param chunk Bytes per read; 0 filters in place.
+ * @return trace of filtering the stream. */
+static std::string s_trace(const filter_test& t, unsigned chunk, bool project){
+	static const char* fields[] = {"id"};
+	RecordFilter::Slot slots[4];
+	const char* keys[4];
+	RecordFilter filter(slots, keys, 4);
+	if(filter.Compile(t.predicates, t.count, fields, 1))
+		return "compile error";
+
+	const unsigned len = strlen(t.json);
+	Mem_Reader reader(t.json, len, chunk);
+	uint32_t pstack[8];
+	uint8_t buffer[32];
+	PullParser parser(8, pstack);
+	if(chunk)
+		parser.Begin(buffer, sizeof(buffer), &reader);
+	else
+		parser.Begin((const uint8_t*)t.json, len);
+	parser.SetFraming(PullParser::FRAME_LINES);
+	if(project)
+		parser.SetProjection(filter.Projection());
+
+	std::string trace;
+	char text[32];
+	Recorder recorder;
+	int ret;
+	while((ret = filter.TryNext(parser, recorder)) > 0){
+		snprintf(text, sizeof(text), "%u ", recorder.id);
+		trace += text;
+	}
+	if(ret < 0)
+		return trace + "E";
+	snprintf(text, sizeof(text), "/%llu/%llu", filter.Accepted(),
+		filter.Rejected());
+	return trace + text;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned succeeded, failed;
+
+	const unsigned filter_length = sizeof(s_filter) / sizeof(filter_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < filter_length; ++i){
+		bool pass = true;
+		for(unsigned chunk = 0; chunk <= 64; chunk = chunk ? chunk * 4 : 1){
+			for(unsigned project = 0; project < 2; ++project){
+				const std::string trace = s_trace(s_filter[i], chunk, project);
+				if(trace != s_filter[i].trace){
+					fprintf(stdout, "Filter Test %u, chunk %u%s: expected %s, got %s\n",
+						i, chunk, project ? ", projected" : "", s_filter[i].trace,
+						trace.c_str());
+					pass = false;
+				}
+			}
+		}
+		if(pass)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Filter Tests total: %u, succeeded: %u, failed %u\n",
+		filter_length, succeeded, failed);
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <string.h>
+
+#include <benejson/benejson.h>
+
+/* Number conversion benchmark.
+ * Collects every number in a JSON document from stdin, then times
+ * converting them to double with bnj_double, with the old
+ * significand * pow(10, exp) formula, and with strtod on the equivalent
+ * decimal text. Results that differ from strtod are counted.
+ * Usage: floatbench [repeat] < file.json */
+
+typedef struct {
+	bnj_val* vals;
+	unsigned count;
+	unsigned cap;
+} numbers;
+
+static int usercb(const bnj_state* state, bnj_ctx* ctx, const uint8_t* buff){
+	numbers* n = ctx->user_data;
+	unsigned k;
+	for(k = 0; k < state->vi; ++k){
+		if(BNJ_NUMERIC != bnj_val_type(state->v + k))
+			continue;
+		if(n->count == n->cap){
+			n->cap *= 2;
+			n->vals = realloc(n->vals, n->cap * sizeof(bnj_val));
+		}
+		n->vals[n->count++] = state->v[k];
+	}
+	return 0;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double s_pow_double(const bnj_val* src){
+	double dest = src->significand_val;
+	dest *= pow(10, src->exp_val);
+	return (src->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? -dest : dest;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned repeat = (argc > 1) ? strtol(argv[1], NULL, 10) : 10;
+
+	/* Slurp stdin. */
+	size_t cap = 1 << 20;
+	size_t len = 0;
+	uint8_t* doc = malloc(cap);
+	while(1){
+		if(len == cap){
+			cap *= 2;
+			doc = realloc(doc, cap);
+		}
+		ssize_t ret = read(0, doc + len, cap - len);
+		if(ret < 0)
+			return 1;
+		if(0 == ret)
+			break;
+		len += ret;
+	}
+
+	numbers n = {malloc(1024 * sizeof(bnj_val)), 0, 1024};
+	uint32_t stackbuff[128];
+	bnj_val values[16];
+	bnj_state mstate;
+	bnj_ctx ctx = {
+		.user_cb = usercb,
+		.user_data = &n,
+		.key_set = NULL,
+		.key_set_length = 0,
+	};
+	bnj_state_init(&mstate, stackbuff, 128);
+	mstate.v = values;
+	mstate.vlen = 16;
+	bnj_parse(&mstate, &ctx, doc, len);
+	if(mstate.flags & BNJ_ERROR_MASK){
+		fprintf(stderr, "Parse error %x\n", mstate.flags);
+		return 1;
+	}
+
+	/* Decimal text of each number, for strtod. */
+	char* text = malloc((size_t)n.count * 32);
+	unsigned k, r;
+	for(k = 0; k < n.count; ++k){
+		const bnj_val* v = n.vals + k;
+		snprintf(text + 32 * (size_t)k, 32, "%s%llue%d",
+			(v->type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND) ? "-" : "",
+			(unsigned long long)v->significand_val, v->exp_val);
+	}
+
+	double* ref = malloc(n.count * sizeof(double));
+	double* res = malloc(n.count * sizeof(double));
+
+	double begin = s_now();
+	for(r = 0; r < repeat; ++r)
+		for(k = 0; k < n.count; ++k)
+			ref[k] = strtod(text + 32 * (size_t)k, NULL);
+	double t_strtod = s_now() - begin;
+
+	begin = s_now();
+	for(r = 0; r < repeat; ++r)
+		for(k = 0; k < n.count; ++k)
+			res[k] = s_pow_double(n.vals + k);
+	double t_pow = s_now() - begin;
+	unsigned bad_pow = 0;
+	for(k = 0; k < n.count; ++k)
+		bad_pow += (0 != memcmp(res + k, ref + k, sizeof(double)));
+
+	begin = s_now();
+	for(r = 0; r < repeat; ++r)
+		for(k = 0; k < n.count; ++k)
+			res[k] = bnj_double(n.vals + k);
+	double t_bnj = s_now() - begin;
+	unsigned bad_bnj = 0;
+	for(k = 0; k < n.count; ++k)
+		bad_bnj += (0 != memcmp(res + k, ref + k, sizeof(double)));
+
+	const double scale = 1e9 / ((double)n.count * repeat);
+	printf("%u numbers\n", n.count);
+	printf("strtod     %8.1f ns/number\n", t_strtod * scale);
+	printf("pow        %8.1f ns/number, %u differ from strtod\n",
+		t_pow * scale, bad_pow);
+	printf("bnj_double %8.1f ns/number, %u differ from strtod\n",
+		t_bnj * scale, bad_bnj);
+
+	free(res);
+	free(ref);
+	free(text);
+	free(n.vals);
+	free(doc);
+	return bad_bnj ? 1 : 0;
+}
@@ -0,0 +1,150 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+#include <benejson/pull.hh>
+#include <benejson/mirror.hh>
+
+/* Fragment compaction benchmark.
+ * Pulls a generated document of long keys and numbers through a small
+ * buffer, once with Begin() and once with BeginMirrored() on a ring of the
+ * same size. Reports time, fragments and bytes moved to the buffer start;
+ * the mirrored pass should move none.
+ * Usage: fragbench [doc_mb [ring_bytes]] */
+
+using BNJ::PullParser;
+
+static unsigned s_rng = 12345;
+
+static unsigned s_rand(void){
+	s_rng = s_rng * 1103515245 + 12345;
+	return (s_rng >> 16) & 0x7FFF;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Reads a document in memory, at most 64 KiB at a time. */
+class Mem_Reader : public PullParser::Reader {
+	public:
+		Mem_Reader(const uint8_t* doc, size_t len) throw()
+			: _doc(doc), _end(doc + len) {}
+
+		int Read(uint8_t* buff, unsigned len) throw(){
+			if(len > 65536)
+				len = 65536;
+			if(len > (size_t)(_end - _doc))
+				len = _end - _doc;
+			memcpy(buff, _doc, len);
+			_doc += len;
+			return len;
+		}
+
+	private:
+		const uint8_t* _doc;
+		const uint8_t* _end;
+};
+
+/* @return checksum of all pulled keys and values. */
+static unsigned long long s_pull(PullParser& parser){
+	unsigned long long sum = 0;
+	char str[256];
+	while(true){
+		PullParser::State s = parser.Pull();
+		if(PullParser::ST_NO_DATA == s)
+			break;
+		if(PullParser::ST_DATUM != s)
+			continue;
+
+		const bnj_val& v = parser.GetValue();
+		if(v.key_length){
+			sum += BNJ::GetKey(str, sizeof(str), parser);
+			sum += (uint8_t)str[v.key_length - 1];
+		}
+		if(BNJ_NUMERIC == bnj_val_type(&v)){
+			/* Text is not kept when the buffer is beyond BUFF_OFFSET_MAX. */
+			const int n = BNJ::TryGetNumText(str, sizeof(str), parser);
+			sum += v.significand_val + ((n > 0) ? n : 0);
+		}
+	}
+	return sum;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 32;
+	unsigned ring_len = (argc > 2) ? strtol(argv[2], NULL, 10) : 4096;
+
+	BNJ::MirrorBuffer ring(ring_len);
+	if(!ring.Data()){
+		fprintf(stderr, "Could not map mirrored buffer\n");
+		return 1;
+	}
+	if(ring.Length() > BUFF_OFFSET_MAX){
+		fprintf(stderr, "Buffer exceeds BUFF_OFFSET_MAX\n");
+		return 1;
+	}
+	uint8_t* buffer = (uint8_t*)malloc(ring.Length());
+
+	/* Records with long keys and numbers, so many straddle the buffer end. */
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = (uint8_t*)malloc(cap + 4096);
+	size_t len = 0;
+	doc[len++] = '[';
+	while(len < cap){
+		doc[len++] = '{';
+		for(unsigned f = 0; f < 8; ++f){
+			len += sprintf((char*)doc + len, "%s\"", f ? "," : "");
+			for(unsigned k = 32 + s_rand() % 160; k; --k)
+				doc[len++] = 'a' + s_rand() % 26;
+			len += sprintf((char*)doc + len, "\":%u%05u%05u", s_rand(), s_rand(),
+				s_rand());
+		}
+		len += sprintf((char*)doc + len, "},");
+	}
+	doc[len - 1] = ']';
+
+	uint32_t pstack[16];
+	unsigned long long sums[2], frags[2], moved[2];
+	double times[2];
+
+	double begin = s_now();
+	{
+		Mem_Reader reader(doc, len);
+		PullParser parser(16, pstack);
+		parser.Begin(buffer, ring.Length(), &reader);
+		sums[0] = s_pull(parser);
+		frags[0] = parser.Fragments();
+		moved[0] = parser.CompactedBytes();
+	}
+	times[0] = s_now() - begin;
+
+	begin = s_now();
+	{
+		Mem_Reader reader(doc, len);
+		PullParser parser(16, pstack);
+		parser.BeginMirrored(ring.Data(), ring.Length(), &reader);
+		sums[1] = s_pull(parser);
+		frags[1] = parser.Fragments();
+		moved[1] = parser.CompactedBytes();
+	}
+	times[1] = s_now() - begin;
+
+	printf("%zu bytes, %u byte buffer:\n", len, ring.Length());
+	printf("compacted: %.2fs, %llu fragments, %llu bytes moved\n", times[0],
+		frags[0], moved[0]);
+	printf("mirrored:  %.2fs, %llu fragments, %llu bytes moved\n", times[1],
+		frags[1], moved[1]);
+
+	free(doc);
+	free(buffer);
+
+	if(sums[1] != sums[0]){
+		fprintf(stderr, "checksum mismatch\n");
+		return 1;
+	}
+	return 0;
+}
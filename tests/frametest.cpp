@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <benejson/pull.hh>
+#include "posix.hh"
+
+/* Document stream tests. Each stream is pulled whole with SetFraming(),
+ * through readers fed a few bytes per read and from memory, and the pulled
+ * values traced: numbers, brackets, '|' at each document end, then '.' at
+ * the end of input or 'E' on errors. */
+
+using BNJ::PullParser;
+
+struct frame_test {
+	PullParser::Framing framing;
+	const char* json;
+	const char* trace;
+};
+
+static const frame_test s_frame[] = {
+	{PullParser::FRAME_CONCAT, "", "."},
+	{PullParser::FRAME_CONCAT, " \n\t ", "."},
+	{PullParser::FRAME_CONCAT, "1 2\n3\n", "1|2|3|."},
+
+	/* A top level scalar needs a byte after it. */
+	{PullParser::FRAME_CONCAT, "1 2\n3", "1|2|E"},
+	{PullParser::FRAME_CONCAT, "{}[]{\"a\":1}", "{}|[]|{1}|."},
+	{PullParser::FRAME_CONCAT, "[1] \n [2]\n", "[1]|[2]|."},
+	{PullParser::FRAME_CONCAT, "[1]]", "[1]|E"},
+
+	{PullParser::FRAME_LINES, "[1]\n[2]\n", "[1]|[2]|."},
+	{PullParser::FRAME_LINES, "[1]\n[2]", "[1]|[2]|."},
+	{PullParser::FRAME_LINES, "\n\n[1]\r\n  \n\n[2]\n\n", "[1]|[2]|."},
+	{PullParser::FRAME_LINES, "{\"a\":1}\n7\n", "{1}|7|."},
+	{PullParser::FRAME_LINES, "[1] [2]\n", "[1]|E"},
+	{PullParser::FRAME_LINES, "[1]\n[2][3]\n", "[1]|[2]|E"},
+	{PullParser::FRAME_LINES, "[1]\n[2\n", "[1]|[2E"},
+
+	{PullParser::FRAME_RECORDS, "\x1E[1]\n\x1E[2]\n", "[1]|[2]|."},
+	{PullParser::FRAME_RECORDS, "\x1E[1]\x1E[2]", "[1]|[2]|."},
+	{PullParser::FRAME_RECORDS, "\x1E\x1E[1]\n\x1E\n\x1E[2]\n\x1E", "[1]|[2]|."},
+	{PullParser::FRAME_RECORDS, "[1]\n", "E"},
+	{PullParser::FRAME_RECORDS, "\x1E[1]\n[2]\n", "[1]|E"},
+	{PullParser::FRAME_RECORDS, "\x1E[1]\n\n", "[1]|."},
+};
+
+/* Ways to feed a stream. */
+enum {
+	READ_1,
+	READ_3,
+	READ_ALL,
+	IN_PLACE,
+	PADDED,
+	FEED_COUNT
+};
+
+static const char* s_feed_names[FEED_COUNT] = {
+	"1 byte reads",
+	"3 byte reads",
+	"whole reads",
+	"in place",
+	"padded"
+};
+
+/* @return trace of pulling the whole stream. */
+static std::string s_trace(const frame_test& t, unsigned feed){
+	static const unsigned chunks[] = {1, 3, 64};
+	const unsigned len = strlen(t.json);
+	char padded[128];
+	memcpy(padded, t.json, len);
+	memset(padded + len, 0, BNJ_PADDING);
+
+	Mem_Reader reader(t.json, len, (feed < IN_PLACE) ? chunks[feed] : len);
+	uint32_t pstack[8];
+	uint8_t buffer[16];
+	PullParser parser(8, pstack);
+	if(IN_PLACE == feed)
+		parser.Begin((const uint8_t*)t.json, len);
+	else if(PADDED == feed)
+		parser.BeginPadded((const uint8_t*)padded, len);
+	else
+		parser.Begin(buffer, sizeof(buffer), &reader);
+	parser.SetFraming(t.framing);
+
+	std::string trace;
+	while(true){
+		const PullParser::State s = parser.TryPull();
+		switch(s){
+			case PullParser::ST_ERROR:
+				return trace + "E";
+
+			case PullParser::ST_NO_DATA:
+				return trace + ".";
+
+			case PullParser::ST_DOC_END:
+				trace += "|";
+				break;
+
+			case PullParser::ST_MAP:
+				trace += "{";
+				break;
+
+			case PullParser::ST_LIST:
+				trace += "[";
+				break;
+
+			case PullParser::ST_ASCEND_MAP:
+				trace += "}";
+				break;
+
+			case PullParser::ST_ASCEND_LIST:
+				trace += "]";
+				break;
+
+			case PullParser::ST_DATUM:
+				{
+					unsigned n;
+					char num[16];
+					if(PullParser::ERR_NONE != BNJ::TryGet(n, parser))
+						return trace + "E";
+					snprintf(num, sizeof(num), "%u", n);
+					trace += num;
+				}
+				break;
+
+			default:
+				return trace + "?";
+		}
+	}
+}
+
+int main(int argc, const char* argv[]){
+	unsigned succeeded, failed;
+
+	const unsigned frame_length = sizeof(s_frame) / sizeof(frame_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < frame_length; ++i){
+		bool pass = true;
+		for(unsigned feed = 0; feed < FEED_COUNT; ++feed){
+			const std::string trace = s_trace(s_frame[i], feed);
+			if(trace != s_frame[i].trace){
+				fprintf(stdout, "Frame Test %u, %s: expected %s, got %s\n", i,
+					s_feed_names[feed], s_frame[i].trace, trace.c_str());
+				pass = false;
+			}
+		}
+		if(pass)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Frame Tests total: %u, succeeded: %u, failed %u\n",
+		frame_length, succeeded, failed);
+
+	return 0;
+}
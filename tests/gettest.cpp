@@ -0,0 +1,552 @@
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include <benejson/pull.hh>
+#include "posix.hh"
+
+/* Value getter tests. Each document is read through a small buffer, fed a
+ * few bytes per read, so values span refills. */
+
+using BNJ::PullParser;
+
+struct numtext_test {
+	const char* json;
+	unsigned buffsize;
+	unsigned chunk;
+
+	/* Expected text of the first number; NULL if it is not kept. */
+	const char* text;
+};
+
+static const numtext_test s_numtext[] = {
+	{"[123]", 64, 64, "123"},
+	{"[-0.5e-3]", 64, 1, "-0.5e-3"},
+	{"[12345678901234567890123]", 64, 64, "12345678901234567890123"},
+	{"[12345678901234567890123]", 64, 3, "12345678901234567890123"},
+	{"[-12345678901234567890123.25e+10]", 64, 5,
+		"-12345678901234567890123.25e+10"},
+	{"{\"key\":98765432109876543210}", 32, 2, "98765432109876543210"},
+	{"[\"padding padding\",18446744073709551616]", 32, 7,
+		"18446744073709551616"},
+
+	/* Text and key fill the buffer. */
+	{"[123456789012345678901234567890123]", 32, 4, NULL},
+	{"{\"long key\":1234567890123456789012345}", 32, 4, NULL},
+};
+
+struct integer_test {
+	const char* json;
+
+	/* Whether int64_t and uint64_t read it, and what they read. */
+	bool int_ok;
+	int64_t int_val;
+	bool uint_ok;
+	uint64_t uint_val;
+};
+
+static const integer_test s_integer[] = {
+	{"[0]", true, 0, true, 0},
+	{"[-0]", true, 0, true, 0},
+	{"[-0.0e5]", true, 0, true, 0},
+	{"[1e3]", true, 1000, true, 1000},
+	{"[1200e-2]", true, 12, true, 12},
+	{"[-1]", true, -1, false, 0},
+	{"[1.5]", false, 0, false, 0},
+	{"[1e-1]", false, 0, false, 0},
+	{"[9223372036854775807]", true, INT64_MAX, true, INT64_MAX},
+	{"[9223372036854775808]", false, 0, true, 9223372036854775808ULL},
+	{"[-9223372036854775808]", true, INT64_MIN, false, 0},
+	{"[-9223372036854775809]", false, 0, false, 0},
+	{"[18446744073709551615]", false, 0, true, UINT64_MAX},
+	{"[18446744073709551616]", false, 0, false, 0},
+	{"[184467440737095516150e-1]", false, 0, true, UINT64_MAX},
+	{"[1844674407370955161.5e1]", false, 0, true, UINT64_MAX},
+	{"[1e19]", false, 0, true, 10000000000000000000ULL},
+	{"[1e20]", false, 0, false, 0},
+	{"[\"1\"]", false, 0, false, 0},
+};
+
+/* @return 0 if the first value reads as expected into int64_t and
+ * uint64_t, after pad spaces, so it spans buffer refills. */
+static unsigned s_check_integer(const integer_test& t, unsigned pad){
+	char json[128];
+	snprintf(json, sizeof(json), "[%*s%s", pad, "", t.json + 1);
+	Mem_Reader reader(json, strlen(json), 3);
+	uint32_t pstack[8];
+	uint8_t buffer[32];
+	PullParser parser(8, pstack);
+	parser.Begin(buffer, sizeof(buffer), &reader);
+	parser.Pull();
+	parser.Pull();
+
+	/* dest is unchanged on errors. */
+	int64_t i = 5;
+	uint64_t u = 5;
+	const bool int_ok = PullParser::ERR_NONE == BNJ::TryGet(i, parser);
+	const bool uint_ok = PullParser::ERR_NONE == BNJ::TryGet(u, parser);
+	if(int_ok != t.int_ok || i != (int_ok ? t.int_val : 5))
+		return 1;
+	if(uint_ok != t.uint_ok || u != (uint_ok ? t.uint_val : 5))
+		return 1;
+
+	/* Get() throws where TryGet() fails: invalid_value for numbers,
+	 * input_error for other types. */
+	bool thrown = false;
+	try{
+		BNJ::Get(i, parser);
+	}
+	catch(const PullParser::invalid_value& e){
+		thrown = true;
+	}
+	catch(const PullParser::input_error& e){
+		thrown = true;
+	}
+	if(thrown == t.int_ok)
+		return 1;
+	while(parser.Depth())
+		parser.Up();
+	return 0;
+}
+
+struct view_test {
+	const char* json;
+
+	/* Expected flags of the first value. */
+	unsigned flags;
+
+	/* Expected text of the first string; NULL if it is a number. */
+	const char* text;
+};
+
+static const view_test s_view[] = {
+	{"[\"plain\"]", 0, "plain"},
+	{"[\"a\\nb\"]", BNJ_VFLAG_ESCAPED, "a\nb"},
+	{"[\"\\u00e9t\\u00e9\"]", BNJ_VFLAG_ESCAPED, "\xC3\xA9t\xC3\xA9"},
+	{"[\"a long string with an escape at its very end\\/\"]",
+		BNJ_VFLAG_ESCAPED, "a long string with an escape at its very end/"},
+	{"[1e-3]", BNJ_VFLAG_NEGATIVE_EXPONENT, NULL},
+	{"[-1e-3]", BNJ_VFLAG_NEGATIVE_EXPONENT | BNJ_VFLAG_NEGATIVE_SIGNIFICAND,
+		NULL},
+};
+
+/* @return 0 if the first value has the expected flags and text. */
+static unsigned s_check_view(const view_test& t, unsigned chunk){
+	static const unsigned flags = BNJ_VFLAG_NEGATIVE_SIGNIFICAND
+		| BNJ_VFLAG_NEGATIVE_EXPONENT | BNJ_VFLAG_ESCAPED;
+	Mem_Reader reader(t.json, strlen(t.json), chunk);
+	uint32_t pstack[8];
+	uint8_t buffer[32];
+	PullParser parser(8, pstack);
+	parser.Begin(buffer, sizeof(buffer), &reader);
+	parser.Pull();
+	parser.Pull();
+
+	if(t.text){
+		char dest[64];
+		unsigned len;
+		const char* view = parser.GetStringView(len, dest, sizeof(dest));
+		if(len != strlen(t.text) || memcmp(view, t.text, len))
+			return 1;
+
+		/* Only plain strings whole in the buffer are read in place. */
+		if((view == dest) != (t.flags || strlen(t.json) >= sizeof(buffer)))
+			return 1;
+	}
+
+	/* A fragmented string's last piece carries the flags of all of it.
+	 * String and number flags do not share bits. */
+	const unsigned type = parser.GetValue().type;
+	const unsigned other =
+		t.text ? BNJ_VFLAG_NEGATIVE_EXPONENT : BNJ_VFLAG_ESCAPED;
+	if((type & flags) != t.flags || (type & other))
+		return 1;
+	while(parser.Depth())
+		parser.Up();
+	return 0;
+}
+
+/* @return 0 if the first number's text is as expected. */
+static unsigned s_check_numtext(const numtext_test& t){
+	Mem_Reader reader(t.json, strlen(t.json), t.chunk);
+	uint32_t pstack[8];
+	uint8_t buffer[256];
+	PullParser parser(8, pstack);
+	parser.Begin(buffer, t.buffsize, &reader);
+
+	parser.Pull();
+	while(PullParser::ST_DATUM != parser.Pull()
+		|| BNJ_NUMERIC != bnj_val_type(&parser.GetValue()))
+	{
+	}
+
+	char text[64];
+	const int len = BNJ::TryGetNumText(text, sizeof(text), parser);
+	if(!t.text){
+		if(len >= 0 || PullParser::ERR_LENGTH != parser.LastError()){
+			fprintf(stdout, "expected text not kept\n");
+			return 1;
+		}
+	}
+	else if(len != (int)strlen(t.text) || strcmp(text, t.text)){
+		fprintf(stdout, "expected %s, got %s\n", t.text, len < 0 ? "error" : text);
+		return 1;
+	}
+
+	/* The rest parses as before. */
+	while(parser.Depth())
+		parser.Up();
+	return 0;
+}
+
+/* @return 0 if keys, empty ones and missing ones included, copy out whole
+ * only into room for them and a null terminator. */
+static unsigned s_check_keys(void){
+	static const char json[] = "{\"\":1,\"ab\":[2]}";
+	Mem_Reader reader(json, strlen(json), 64);
+	uint32_t pstack[8];
+	uint8_t buffer[64];
+	PullParser parser(8, pstack);
+	parser.Begin(buffer, sizeof(buffer), &reader);
+	parser.Pull();
+
+	/* Empty key. */
+	char dest[8];
+	parser.Pull();
+	memset(dest, '#', sizeof(dest));
+	if(0 != BNJ::TryGetKey(dest, 1, parser) || dest[0] || '#' != dest[1])
+		return 1;
+	if(0 != BNJ::GetKey(dest, sizeof(dest), parser) || dest[0])
+		return 1;
+	if(BNJ::TryGetKey(dest, 0, parser) >= 0)
+		return 1;
+
+	/* Key just fits with its terminator, or does not. */
+	parser.Pull();
+	memset(dest, '#', sizeof(dest));
+	if(BNJ::TryGetKey(dest, 2, parser) >= 0
+		|| PullParser::ERR_LENGTH != parser.LastError() || '#' != dest[2])
+	{
+		return 1;
+	}
+	if(2 != BNJ::TryGetKey(dest, 3, parser) || strcmp(dest, "ab")
+		|| '#' != dest[3])
+	{
+		return 1;
+	}
+
+	/* List element has no key. */
+	parser.Pull();
+	memset(dest, '#', sizeof(dest));
+	if(0 != BNJ::GetKey(dest, sizeof(dest), parser) || dest[0])
+		return 1;
+	while(parser.Depth())
+		parser.Up();
+	return 0;
+}
+
+/* @return 0 if a string spanning refills reads back whole through dest of
+ * destlen units, never writing past them. */
+static unsigned s_check_chunk(unsigned chunk, unsigned destlen){
+	char str[101];
+	for(unsigned i = 0; i < 100; ++i)
+		str[i] = 'a' + i % 26;
+	str[100] = 0;
+
+	char json[128];
+	snprintf(json, sizeof(json), "[\"%s\"]", str);
+	Mem_Reader reader(json, strlen(json), chunk);
+	uint32_t pstack[8];
+	uint8_t buffer[32];
+	PullParser parser(8, pstack);
+	parser.Begin(buffer, sizeof(buffer), &reader);
+	parser.Pull();
+	parser.Pull();
+
+	char dest[128];
+	char out[128];
+	unsigned total = 0;
+	int len;
+	do{
+		memset(dest, '#', sizeof(dest));
+		len = parser.TryChunkRead8(dest, destlen);
+		if(len < 0 || dest[destlen] != '#' || total + len > 100)
+			return 1;
+		memcpy(out + total, dest, len);
+		total += len;
+	} while(len);
+	out[total] = 0;
+	return strcmp(out, str) ? 1 : 0;
+}
+
+/* @return 0 if a document several windows long, with a string longer than
+ * BUFF_OFFSET_MAX, reads back whole from an in place buffer. */
+static unsigned s_check_in_place(bool padded){
+	const unsigned slen = 200000;
+	char* json = (char*)malloc(slen + 64 + BNJ_PADDING);
+	unsigned len = sprintf(json, "{\"a\":[1,\"");
+	for(unsigned i = 0; i < slen; ++i)
+		json[len++] = 'a' + i % 26;
+	len += sprintf(json + len, "\",2],\"b\":12345}");
+	memset(json + len, 0, BNJ_PADDING);
+
+	uint32_t pstack[8];
+	PullParser parser(8, pstack);
+	if(padded)
+		parser.BeginPadded((const uint8_t*)json, len);
+	else
+		parser.Begin((const uint8_t*)json, len);
+
+	unsigned ret = 1;
+	char dest[1000];
+	unsigned total = 0;
+	unsigned n, b;
+	parser.Pull();
+	parser.Pull();
+	parser.Pull();
+	if(PullParser::ST_DATUM != parser.Pull())
+		goto done;
+	while((n = parser.ChunkRead8(dest, sizeof(dest)))){
+		for(unsigned i = 0; i < n; ++i){
+			if(dest[i] != (char)('a' + (total + i) % 26))
+				goto done;
+		}
+		total += n;
+	}
+	if(total != slen || PullParser::ST_DATUM != parser.Pull())
+		goto done;
+	BNJ::Get(b, parser);
+	if(2 != b || PullParser::ST_ASCEND_LIST != parser.Pull()
+		|| PullParser::ST_DATUM != parser.Pull())
+		goto done;
+	BNJ::Get(b, parser);
+	ret = (12345 != b || PullParser::ST_ASCEND_MAP != parser.Pull()
+		|| PullParser::ST_NO_DATA != parser.Pull());
+
+done:
+	free(json);
+	return ret;
+}
+
+/* @return 0 if a buffer past BUFF_OFFSET_MAX is refused. */
+static unsigned s_check_too_long(void){
+	if(BUFF_OFFSET_MAX >= UINT_MAX)
+		return 0;
+
+	uint8_t* buffer = (uint8_t*)malloc(BUFF_OFFSET_MAX + 1u);
+	Mem_Reader reader("[]", 2, 2);
+	uint32_t pstack[8];
+	PullParser parser(8, pstack);
+	unsigned ret = 0;
+	if(PullParser::ERR_LENGTH
+		!= parser.TryBegin(buffer, BUFF_OFFSET_MAX + 1u, &reader)
+		|| PullParser::ST_ERROR != parser.TryPull())
+	{
+		ret = 1;
+	}
+	if(PullParser::ERR_LENGTH
+		!= parser.TryBeginMirrored(buffer, BUFF_OFFSET_MAX + 1u, &reader))
+	{
+		ret = 1;
+	}
+	try{
+		parser.Begin(buffer, BUFF_OFFSET_MAX + 1u, &reader);
+		ret = 1;
+	}
+	catch(const PullParser::input_error& e){
+	}
+
+	/* At the limit is fine. */
+	if(PullParser::ERR_NONE != parser.TryBegin(buffer, BUFF_OFFSET_MAX, &reader)
+		|| PullParser::ST_LIST != parser.TryPull())
+	{
+		ret = 1;
+	}
+	free(buffer);
+	return ret;
+}
+
+/* @return 0 if a file that cannot be mapped leaves nothing to pull. */
+static unsigned s_check_mapped(void){
+	char path[] = "/tmp/gettestXXXXXX";
+	const int fd = mkstemp(path);
+	if(-1 == fd)
+		return 1;
+	const bool written = 5 == write(fd, "[1,2]", 5);
+	close(fd);
+
+	uint32_t pstack[8];
+	PullParser parser(8, pstack);
+	unsigned ret = 0;
+	if(!written || PullParser::ERR_NONE != parser.TryBeginMapped(path)
+		|| PullParser::ST_LIST != parser.TryPull())
+	{
+		ret = 1;
+	}
+
+	/* The failed begin drops the document being pulled. */
+	if(PullParser::ERR_READ != parser.TryBeginMapped("/nonexistent/gettest")
+		|| PullParser::ST_ERROR != parser.GetState()
+		|| PullParser::ST_ERROR != parser.TryPull() || parser.Depth())
+	{
+		ret = 1;
+	}
+
+	/* And the parser can begin again. */
+	if(PullParser::ERR_NONE != parser.TryBeginMapped(path)
+		|| PullParser::ST_LIST != parser.TryPull()
+		|| PullParser::ST_DATUM != parser.TryPull())
+	{
+		ret = 1;
+	}
+	unlink(path);
+	return ret;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned succeeded, failed;
+
+	/* Number text test. */
+	const unsigned numtext_length = sizeof(s_numtext) / sizeof(numtext_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < numtext_length; ++i){
+		unsigned ret;
+		try{
+			ret = s_check_numtext(s_numtext[i]);
+		}
+		catch(const std::exception& e){
+			fprintf(stdout, "%s\n", e.what());
+			ret = 1;
+		}
+		if(ret){
+			fprintf(stdout, "Number Text Test %u failed\n", i);
+			++failed;
+		}
+		else{
+			++succeeded;
+		}
+	}
+	fprintf(stdout, "Number Text Tests total: %u, succeeded: %u, failed %u\n",
+		numtext_length, succeeded, failed);
+
+	/* Integer test. */
+	const unsigned integer_length = sizeof(s_integer) / sizeof(integer_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < integer_length; ++i){
+		unsigned ret = 0;
+		for(unsigned pad = 0; pad < 32; ++pad){
+			try{
+				ret |= s_check_integer(s_integer[i], pad);
+			}
+			catch(const std::exception& e){
+				fprintf(stdout, "%s\n", e.what());
+				ret = 1;
+			}
+		}
+		if(ret){
+			fprintf(stdout, "Integer Test %u failed\n", i);
+			++failed;
+		}
+		else{
+			++succeeded;
+		}
+	}
+	fprintf(stdout, "Integer Tests total: %u, succeeded: %u, failed %u\n",
+		integer_length, succeeded, failed);
+
+	/* String view test. */
+	const unsigned view_length = sizeof(s_view) / sizeof(view_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < view_length; ++i){
+		unsigned ret = 0;
+		for(unsigned chunk = 1; chunk <= 64; chunk *= 4){
+			try{
+				ret |= s_check_view(s_view[i], chunk);
+			}
+			catch(const std::exception& e){
+				fprintf(stdout, "%s\n", e.what());
+				ret = 1;
+			}
+		}
+		if(ret){
+			fprintf(stdout, "String View Test %u failed\n", i);
+			++failed;
+		}
+		else{
+			++succeeded;
+		}
+	}
+	fprintf(stdout, "String View Tests total: %u, succeeded: %u, failed %u\n",
+		view_length, succeeded, failed);
+
+	/* Chunk read test. */
+	succeeded = 0;
+	failed = 0;
+	for(unsigned chunk = 1; chunk <= 16; chunk *= 2){
+		for(unsigned destlen = 2; destlen <= 101; ++destlen){
+			if(s_check_chunk(chunk, destlen)){
+				fprintf(stdout, "Chunk Read Test chunk %u, destlen %u failed\n",
+					chunk, destlen);
+				++failed;
+			}
+			else{
+				++succeeded;
+			}
+		}
+	}
+	fprintf(stdout, "Chunk Read Tests total: %u, succeeded: %u, failed %u\n",
+		succeeded + failed, succeeded, failed);
+
+	/* Key copy test. */
+	unsigned ret;
+	try{
+		ret = s_check_keys();
+	}
+	catch(const std::exception& e){
+		fprintf(stdout, "%s\n", e.what());
+		ret = 1;
+	}
+	fprintf(stdout, "Key Copy Tests total: 1, succeeded: %u, failed %u\n",
+		!ret, ret);
+
+	/* Buffer length test. */
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < 3; ++i){
+		unsigned ret;
+		try{
+			ret = (i < 2) ? s_check_in_place(i) : s_check_too_long();
+		}
+		catch(const std::exception& e){
+			fprintf(stdout, "%s\n", e.what());
+			ret = 1;
+		}
+		if(ret){
+			fprintf(stdout, "Buffer Length Test %u failed\n", i);
+			++failed;
+		}
+		else{
+			++succeeded;
+		}
+	}
+	fprintf(stdout, "Buffer Length Tests total: %u, succeeded: %u, failed %u\n",
+		succeeded + failed, succeeded, failed);
+
+	/* Mapped file test. */
+	try{
+		ret = s_check_mapped();
+	}
+	catch(const std::exception& e){
+		fprintf(stdout, "%s\n", e.what());
+		ret = 1;
+	}
+	fprintf(stdout, "Mapped Tests total: 1, succeeded: %u, failed %u\n",
+		!ret, ret);
+
+	return 0;
+}
@@ -0,0 +1,185 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <string.h>
+
+#include <benejson/benejson.h>
+
+/* Parse throughput benchmark.
+ * Reads a JSON document from stdin, then times parsing it in memory
+ * as given, compacted (no whitespace outside strings) and pretty printed
+ * (newline and two space indent per level).
+ * Usage: jsonbench [buffsize [repeat]] < file.json */
+
+static size_t s_put(uint8_t* dst, size_t pos, uint8_t c, unsigned n){
+	while(n--){
+		if(dst)
+			dst[pos] = c;
+		++pos;
+	}
+	return pos;
+}
+
+/* Reformat src into dst.
+ * @param dst If NULL, only compute the output length.
+ * @param indent If zero, compact. Otherwise spaces per nesting level.
+ * @return Length written. */
+static size_t s_reformat(uint8_t* dst, const uint8_t* src, size_t len,
+	unsigned indent)
+{
+	size_t d = 0;
+	unsigned depth = 0;
+	int in_str = 0;
+	size_t i;
+	for(i = 0; i < len; ++i){
+		const uint8_t c = src[i];
+		if(in_str){
+			d = s_put(dst, d, c, 1);
+			if('\\' == c && i + 1 < len)
+				d = s_put(dst, d, src[++i], 1);
+			else if('"' == c)
+				in_str = 0;
+			continue;
+		}
+
+		switch(c){
+			case ' ':
+			case '\t':
+			case '\n':
+			case '\r':
+				break;
+
+			case '"':
+				in_str = 1;
+				d = s_put(dst, d, c, 1);
+				break;
+
+			case '{':
+			case '[':
+				d = s_put(dst, d, c, 1);
+				++depth;
+				if(indent){
+					d = s_put(dst, d, '\n', 1);
+					d = s_put(dst, d, ' ', depth * indent);
+				}
+				break;
+
+			case '}':
+			case ']':
+				if(depth)
+					--depth;
+				if(indent){
+					d = s_put(dst, d, '\n', 1);
+					d = s_put(dst, d, ' ', depth * indent);
+				}
+				d = s_put(dst, d, c, 1);
+				break;
+
+			case ',':
+				d = s_put(dst, d, c, 1);
+				if(indent){
+					d = s_put(dst, d, '\n', 1);
+					d = s_put(dst, d, ' ', depth * indent);
+				}
+				break;
+
+			case ':':
+				d = s_put(dst, d, c, 1);
+				if(indent)
+					d = s_put(dst, d, ' ', 1);
+				break;
+
+			default:
+				d = s_put(dst, d, c, 1);
+		}
+	}
+	return d;
+}
+
+static int usercb(const bnj_state* state, bnj_ctx* ctx, const uint8_t* buff){
+	return 0;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* @return MB/s or negative on parse error. */
+static double s_time(const uint8_t* doc, size_t len, unsigned buffsize,
+	unsigned repeat)
+{
+	uint32_t stackbuff[128];
+	bnj_val values[16];
+	bnj_state mstate;
+	bnj_ctx ctx = {
+		.user_cb = usercb,
+		.user_data = NULL,
+		.key_set = NULL,
+		.key_set_length = 0,
+	};
+
+	double begin = s_now();
+	unsigned r;
+	for(r = 0; r < repeat; ++r){
+		bnj_state_init(&mstate, stackbuff, 128);
+		mstate.v = values;
+		mstate.vlen = 16;
+
+		const uint8_t* i = doc;
+		const uint8_t* end = doc + len;
+		while(i != end){
+			unsigned chunk = (end - i < buffsize) ? end - i : buffsize;
+			bnj_parse(&mstate, &ctx, i, chunk);
+			if(mstate.flags & BNJ_ERROR_MASK){
+				fprintf(stderr, "Parse error %x\n", mstate.flags);
+				return -1.0;
+			}
+			i += chunk;
+		}
+	}
+	return (double)len * repeat / (s_now() - begin) / 1e6;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned buffsize = (argc > 1) ? strtol(argv[1], NULL, 10) : 65536;
+	unsigned repeat = (argc > 2) ? strtol(argv[2], NULL, 10) : 10;
+
+	/* Slurp stdin. */
+	size_t cap = 1 << 20;
+	size_t len = 0;
+	uint8_t* doc = malloc(cap);
+	while(1){
+		if(len == cap){
+			cap *= 2;
+			doc = realloc(doc, cap);
+		}
+		ssize_t ret = read(0, doc + len, cap - len);
+		if(ret < 0)
+			return 1;
+		if(0 == ret)
+			break;
+		len += ret;
+	}
+
+	uint8_t* compact = malloc(len);
+	size_t clen = s_reformat(compact, doc, len, 0);
+	size_t plen = s_reformat(NULL, compact, clen, 2);
+	uint8_t* pretty = malloc(plen);
+	s_reformat(pretty, compact, clen, 2);
+
+	printf("input   %10zu bytes %8.1f MB/s\n", len,
+		s_time(doc, len, buffsize, repeat));
+	printf("compact %10zu bytes %8.1f MB/s\n", clen,
+		s_time(compact, clen, buffsize, repeat));
+	printf("pretty  %10zu bytes %8.1f MB/s\n", plen,
+		s_time(pretty, plen, buffsize, repeat));
+
+	free(pretty);
+	free(compact);
+	free(doc);
+	return 0;
+}
@@ -3,6 +3,7 @@
 #include <cstdlib>
 
 #include <benejson/pull.hh>
+#include <benejson/paths.hh>
 #include "posix.hh"
 
 /* Reduce typing when dealing with PullParser members.
@@ -36,11 +37,11 @@ void s_print_value(PullParser& data_parser){
 			break;
 
 		case BNJ_STRING:
-			/* TODO loop to get entire string value..for now just output fixed chars. */
 			{
 				char buffer[1024];
-				data_parser.ChunkRead8(buffer, 1024);
-				printf("%s", buffer);
+				unsigned len;
+				while((len = data_parser.ChunkRead8(buffer, 1024)))
+					fwrite(buffer, 1, len, stdout);
 			}
 			break;
 
@@ -68,14 +69,105 @@ void s_print_value(PullParser& data_parser){
 	}
 }
 
+/* Convert legacy JSON array path, such as ["a",0], to a JSON Pointer. */
+static void s_array_to_pointer(char* dest, unsigned destlen, const char* path){
+	uint32_t path_stack[3];
+	PullParser path_parser(3, path_stack);
+	path_parser.Begin(reinterpret_cast<const uint8_t*>(path), strlen(path));
+	if(PullParser::ST_LIST != path_parser.Pull())
+		throw PullParser::invalid_value("Path must be an array!", path_parser);
+
+	unsigned len = 0;
+	while(PullParser::ST_ASCEND_LIST != path_parser.Pull()){
+		char segment[512];
+		const bnj_val& v = path_parser.GetValue();
+		unsigned type = bnj_val_type(&v);
+		if(BNJ_NUMERIC == type){
+			unsigned idx;
+			BNJ::Get(idx, path_parser);
+			snprintf(segment, sizeof(segment), "%u", idx);
+		}
+		else if(BNJ_STRING == type){
+			path_parser.ChunkRead8(segment, sizeof(segment));
+		}
+		else
+			throw PullParser::invalid_value("Element must be string or integer!", path_parser);
+
+		/* Escape '~' and '/'. */
+		if(len + 1 >= destlen)
+			throw std::runtime_error("Path too long!");
+		dest[len++] = '/';
+		for(const char* c = segment; *c; ++c){
+			if(len + 2 >= destlen)
+				throw std::runtime_error("Path too long!");
+			if('~' == *c || '/' == *c){
+				dest[len++] = '~';
+				dest[len++] = ('~' == *c) ? '0' : '1';
+			}
+			else
+				dest[len++] = *c;
+		}
+	}
+	dest[len] = '\0';
+}
+
+/* Print values as found; prefix with the path when grabbing several. */
+class Printer : public BNJ::PathSet::Handler {
+	public:
+		Printer(const char* const* pointers, bool* found, unsigned count)
+			: _pointers(pointers), _found(found), _count(count)
+		{
+		}
+
+		void Match(unsigned path, PullParser& parser){
+			_found[path] = true;
+			if(_count > 1)
+				printf("%s\t", _pointers[path]);
+			s_print_value(parser);
+			if(_count > 1)
+				printf("\n");
+		}
+
+	private:
+		const char* const* _pointers;
+		bool* _found;
+		unsigned _count;
+};
+
 int main(int argc, const char* argv[]){
 
 	if(argc < 2){
-		fprintf(stderr, "Usage: %s JSON_PATH\n", argv[0]);
+		fprintf(stderr, "Usage: %s JSON_POINTER...\n", argv[0]);
+		fprintf(stderr, "Paths are JSON Pointers (\"/a/0\") or JSON arrays ([\"a\",0]).\n");
 		return 1;
 	}
 
 	try{
+		/* Normalize paths to JSON Pointers. */
+		const unsigned count = argc - 1;
+		const char* pointers[count];
+		char converted[count][1024];
+		for(unsigned i = 0; i < count; ++i){
+			if('[' == argv[i + 1][0]){
+				s_array_to_pointer(converted[i], sizeof(converted[i]), argv[i + 1]);
+				pointers[i] = converted[i];
+			}
+			else
+				pointers[i] = argv[i + 1];
+		}
+
+		/* Compile all paths, so one pass finds them all. */
+		unsigned node_len, text_len;
+		BNJ::PathSet::StorageSize(pointers, count, node_len, text_len);
+		BNJ::PathSet::Node nodes[node_len];
+		const char* keys[node_len];
+		char text[text_len + 1];
+		BNJ::PathSet paths(nodes, keys, node_len, text, text_len + 1);
+		const char* err = paths.Compile(pointers, count);
+		if(err){
+			fprintf(stderr, "%s\n", err);
+			return 1;
+		}
 
 		/* Read json from std input. */
 		FD_Reader reader(0);
@@ -87,71 +179,17 @@ int main(int argc, const char* argv[]){
 		PullParser data_parser(64, data_stack);
 		data_parser.Begin(buffer, 1024, &reader);
 
-		/* Begin parsing the path string; make sure we are in an array.*/
-		uint32_t path_stack[3];
-		PullParser path_parser(3, path_stack);
-		int len = strlen(argv[1]);
-		path_parser.Begin(reinterpret_cast<const uint8_t*>(argv[1]), len);
-		if(PullParser::ST_LIST != path_parser.Pull())
-			throw PullParser::invalid_value("Path must be an array!", path_parser);
-
-		/* Get the first element. */
-		data_parser.Pull();
-		while(PullParser::ST_ASCEND_LIST != path_parser.Pull()){
-			/* Expecting to descend into the data. */
-			if(!data_parser.Descended())
-				throw PullParser::invalid_value("Expecting a map or array in data!", data_parser);
-
-			const bnj_val& v = path_parser.GetValue();
-			unsigned type = bnj_val_type(&v);
-			if(BNJ_NUMERIC == type){
-				/* Data parser must be in an array. */
-				if(data_parser.InMap())
-					throw PullParser::invalid_value("Expected array in data!", data_parser);
-
-				unsigned idx;
-				BNJ::Get(idx, path_parser);
-
-				/* Iterate until idx is reached. */
-				unsigned count = 0;
-				while(count < idx){
-					if(PullParser::ST_ASCEND_LIST == data_parser.Pull())
-						throw PullParser::invalid_value("Premature end of array!", data_parser);
-					/* If descended, go back up. */
-					if(data_parser.Descended())
-						data_parser.Up();
-					++count;
-				}
-				data_parser.Pull();
-			}
-			else if(BNJ_STRING == type){
-				/* Data parser must be in a map. */
-				if(!data_parser.InMap())
-					throw PullParser::invalid_value("Expected map in data!", data_parser);
-
-				/* Define keyset we are looking for (only the key at this level). */
-				char keybuff[512];
-				path_parser.ChunkRead8(keybuff, 512);
-				const char* keys[] = {
-					keybuff
-				};
+		bool found[count];
+		memset(found, 0, sizeof(found));
+		Printer printer(pointers, found, count);
+		if(paths.Extract(data_parser, printer) == count)
+			return 0;
 
-				/* Iterate until key is matched. */
-				while(true){
-					if(data_parser.Pull(keys, 1) == PullParser::ST_ASCEND_MAP)
-						throw PullParser::invalid_value("Expected key in data!", data_parser);
-					if(0 == data_parser.GetValue().key_enum)
-						break;
-					if(data_parser.Descended())
-						data_parser.Up();
-				}
-			}
-			else
-				throw PullParser::invalid_value("Element must be string or integer!", path_parser);
+		for(unsigned i = 0; i < count; ++i){
+			if(!found[i])
+				fprintf(stderr, "Expected path in data: %s\n", pointers[i]);
 		}
-
-		s_print_value(data_parser);
-		return 0;
+		return 1;
 	}
 	catch(const std::exception& e){
 		fprintf(stderr, "%s\n", e.what());
@@ -0,0 +1,228 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <benejson/pull.hh>
+#include <benejson/query.hh>
+#include "posix.hh"
+
+/* Reduce typing when dealing with PullParser members.
+ * Not doing full BNJ namespace since Get() conversion methods should
+ * remain within namespace. */
+using BNJ::PullParser;
+
+/* Append chars as the inside of a JSON string. */
+static void s_escape(std::string& out, const char* str, unsigned len){
+	for(unsigned i = 0; i < len; ++i){
+		const unsigned char c = str[i];
+		char esc[8];
+		if('"' == c || '\\' == c){
+			out += '\\';
+			out += c;
+		}
+		else if('\n' == c){
+			out += "\\n";
+		}
+		else if(c < 0x20){
+			snprintf(esc, sizeof(esc), "\\u%04x", c);
+			out += esc;
+		}
+		else{
+			out += c;
+		}
+	}
+}
+
+/* Append the scalar the parser is at as compact JSON. */
+static void s_scalar_json(std::string& out, PullParser& parser){
+	const bnj_val& v = parser.GetValue();
+	switch(bnj_val_type(&v)){
+		case BNJ_NUMERIC:
+			{
+				char num[1024];
+				BNJ::GetNumText(num, sizeof(num), parser);
+				out += num;
+			}
+			break;
+
+		case BNJ_STRING:
+			{
+				char buffer[1024];
+				unsigned len;
+				out += '"';
+				while((len = parser.ChunkRead8(buffer, sizeof(buffer))))
+					s_escape(out, buffer, len);
+				out += '"';
+			}
+			break;
+
+		case BNJ_SPECIAL:
+			{
+				static const char* special[BNJ_COUNT_SPC] = {
+					"false",
+					"true",
+					"null",
+					"NaN",
+					"Infinity"
+				};
+				unsigned idx = bnj_val_special(&v);
+				if(BNJ_SPC_INFINITY == idx && (v.type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND)){
+					out += "-Infinity";
+				}
+				else{
+					out += special[idx];
+				}
+			}
+			break;
+
+		default:
+			throw PullParser::invalid_value("Unexpected value!", parser);
+	}
+}
+
+/* Print each match on its own line, in document order; prefix with the
+ * query when running several. Matches nested in others are built from the
+ * same values, so a match waits for those begun before it. */
+class Printer : public BNJ::PathQuery::Handler {
+	public:
+		Printer(const char* const* queries, unsigned count)
+			: _queries(queries), _count(count)
+		{
+		}
+
+		void Match(unsigned query, PullParser& parser){
+			Pending p;
+			p.query = query;
+			p.open = 0;
+			p.done = false;
+			_pending.push_back(p);
+		}
+
+		void Value(PullParser& parser){
+			/* Members carry their key in the matches around them. */
+			const bool member = !parser.Ascended() && !_maps.empty()
+				&& _maps.back();
+			std::string text;
+			if(parser.Ascended()){
+				text = (PullParser::ST_ASCEND_MAP == parser.GetState()) ? "}" : "]";
+				_maps.pop_back();
+			}
+			else if(parser.Descended()){
+				text = parser.InMap() ? "{" : "[";
+				_maps.push_back(parser.InMap());
+			}
+			else{
+				s_scalar_json(text, parser);
+			}
+
+			for(unsigned i = 0; i < _pending.size(); ++i){
+				Pending& p = _pending[i];
+				if(p.done)
+					continue;
+
+				/* Inside the match; not the value it begins at. */
+				if(!p.text.empty() && !parser.Ascended()){
+					const char last = p.text[p.text.size() - 1];
+					if('{' != last && '[' != last)
+						p.text += ',';
+					if(member){
+						char key[1024];
+						const unsigned len = BNJ::GetKey(key, sizeof(key), parser);
+						p.text += '"';
+						s_escape(p.text, key, len);
+						p.text += "\":";
+					}
+				}
+				p.text += text;
+
+				if(parser.Descended())
+					++p.open;
+				else if(parser.Ascended())
+					--p.open;
+				p.done = !p.open;
+			}
+
+			while(!_pending.empty() && _pending.front().done){
+				const Pending& p = _pending.front();
+				if(_count > 1)
+					printf("%s\t", _queries[p.query]);
+				printf("%s\n", p.text.c_str());
+				_pending.pop_front();
+			}
+		}
+
+	private:
+		/* Match still being built. */
+		struct Pending {
+			unsigned query;
+
+			/* Maps and lists begun and not ended. */
+			unsigned open;
+
+			bool done;
+			std::string text;
+		};
+
+		const char* const* _queries;
+		unsigned _count;
+
+		/* Matches in document order. */
+		std::deque<Pending> _pending;
+
+		/* Whether each map or list being built is a map. */
+		std::vector<bool> _maps;
+};
+
+int main(int argc, const char* argv[]){
+
+	if(argc < 2){
+		fprintf(stderr, "Usage: %s QUERY...\n", argv[0]);
+		fprintf(stderr, "Queries are JSONPath, such as '$.items[*].id' or '$..error'.\n");
+		fprintf(stderr, "Input may hold many documents, such as NDJSON.\n");
+		return 1;
+	}
+
+	try{
+		/* Compile all queries, so one pass runs them all. */
+		const unsigned count = argc - 1;
+		const char* const* queries = argv + 1;
+		unsigned step_len, text_len, words;
+		BNJ::PathQuery::StorageSize(queries, count, step_len, text_len, words);
+		BNJ::PathQuery::Step steps[step_len];
+		const char* keys[step_len];
+		char text[text_len + 1];
+
+		/* Deal with data depths up to 64 */
+		uint64_t sets[words * 65];
+		BNJ::PathQuery query(steps, keys, step_len, text, text_len + 1, sets,
+			words * 65);
+		const char* err = query.Compile(queries, count);
+		if(err){
+			fprintf(stderr, "%s\n", err);
+			return 1;
+		}
+
+		/* Read json from std input. */
+		FD_Reader reader(0);
+
+		uint32_t data_stack[64];
+		uint8_t buffer[1024];
+		PullParser data_parser(64, data_stack);
+		data_parser.Begin(buffer, 1024, &reader);
+		data_parser.SetFraming(PullParser::FRAME_CONCAT);
+
+		Printer printer(queries, count);
+		while(query.Extract(data_parser, printer)
+			|| PullParser::ST_NO_DATA != data_parser.GetState())
+		{
+		}
+		return 0;
+	}
+	catch(const std::exception& e){
+		fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+}
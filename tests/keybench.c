@@ -0,0 +1,194 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <string.h>
+
+#include <benejson/benejson.h>
+
+/* Key matching benchmark.
+ * For growing key set sizes, generates records whose keys are mostly from
+ * the key set, plus keys that are prefixes or extensions of set keys.
+ * Times parsing without a key set, with the sorted key_set binary search
+ * and with a compiled bnj_keymatcher. Every key_enum is checked.
+ * Usage: keybench [doc_mb [repeat]] */
+
+static unsigned s_rng = 12345;
+
+static unsigned s_rand(void){
+	s_rng = s_rng * 1103515245 + 12345;
+	return (s_rng >> 16) & 0x7FFF;
+}
+
+static int s_strcmp(const void* a, const void* b){
+	return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+typedef struct {
+	unsigned long long sum;
+	unsigned long long keys;
+} checksum;
+
+static int usercb(const bnj_state* state, bnj_ctx* ctx, const uint8_t* buff){
+	checksum* c = ctx->user_data;
+	unsigned k;
+	for(k = 0; k < state->vi; ++k){
+		if(state->v[k].key_length){
+			c->sum += state->v[k].key_enum;
+			++c->keys;
+		}
+	}
+	return 0;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* @return MB/s or negative on parse error. */
+static double s_time(const uint8_t* doc, size_t len, unsigned repeat,
+	bnj_ctx* ctx, checksum* c)
+{
+	uint32_t stackbuff[16];
+	bnj_val values[16];
+	bnj_state mstate;
+
+	ctx->user_cb = usercb;
+	ctx->user_data = c;
+
+	double begin = s_now();
+	unsigned r;
+	for(r = 0; r < repeat; ++r){
+		c->sum = 0;
+		c->keys = 0;
+		bnj_state_init(&mstate, stackbuff, 16);
+		mstate.v = values;
+		mstate.vlen = 16;
+		bnj_parse(&mstate, ctx, doc, len);
+		if(mstate.flags & BNJ_ERROR_MASK){
+			fprintf(stderr, "Parse error %x\n", mstate.flags);
+			return -1.0;
+		}
+	}
+	return (double)len * repeat / (s_now() - begin) / 1e6;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 16;
+	unsigned repeat = (argc > 2) ? strtol(argv[2], NULL, 10) : 5;
+	static const unsigned counts[] = {8, 32, 128, 300, 1000, 4000};
+	static const char* prefixes[] = {"", "user_", "order_", "item.", "x"};
+	int ret = 0;
+
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = malloc(cap + 64);
+
+	unsigned c;
+	for(c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c){
+		const unsigned count = counts[c];
+
+		/* Random distinct sorted keys, many sharing prefixes. */
+		char** keys = malloc(count * sizeof(char*));
+		unsigned n = 0;
+		while(n < count){
+			char* k = malloc(32);
+			char* x = stpcpy(k, prefixes[s_rand() % 5]);
+			unsigned l = 2 + s_rand() % 12;
+			while(l--)
+				*x++ = 'a' + s_rand() % 26;
+			*x = '\0';
+			keys[n++] = k;
+			if(n == count){
+				qsort(keys, n, sizeof(char*), s_strcmp);
+				unsigned d = 1;
+				unsigned j;
+				for(j = 1; j < n; ++j){
+					if(strcmp(keys[j], keys[d - 1]))
+						keys[d++] = keys[j];
+					else
+						free(keys[j]);
+				}
+				n = d;
+			}
+		}
+
+		/* Records of 32 keys. Every 8th key is a prefix or extension of a set
+		 * key, which may or may not be in the set itself. */
+		size_t len = 0;
+		unsigned long long expect_sum = 0;
+		unsigned long long expect_keys = 0;
+		doc[len++] = '[';
+		while(len < cap - 1024){
+			unsigned f;
+			doc[len++] = '{';
+			for(f = 0; f < 32; ++f){
+				char key[40];
+				strcpy(key, keys[s_rand() % count]);
+				if(0 == s_rand() % 8){
+					if(s_rand() & 1)
+						key[strlen(key) - 1] = '\0';
+					else
+						strcat(key, "z");
+				}
+				const char* kp = key;
+				char** found = bsearch(&kp, keys, count, sizeof(char*), s_strcmp);
+				expect_sum += found ? (unsigned)(found - keys) : count;
+				++expect_keys;
+				len += sprintf((char*)doc + len, "%s\"%s\":%u", f ? "," : "", key,
+					s_rand());
+			}
+			doc[len++] = '}';
+			doc[len++] = ',';
+		}
+		doc[len - 1] = ']';
+
+		const uint32_t size = bnj_keymatcher_size((char const* const*)keys, count);
+		uint16_t* storage = malloc(size * sizeof(uint16_t));
+		bnj_keymatcher km;
+		if(!bnj_keymatcher_init(&km, (char const* const*)keys, count, storage,
+			size))
+		{
+			fprintf(stderr, "bnj_keymatcher_init failed for %u keys\n", count);
+			return 1;
+		}
+
+		bnj_ctx ctx = {
+			.user_cb = usercb,
+			.user_data = NULL,
+			.key_set = NULL,
+			.key_set_length = 0,
+		};
+		checksum none, bsearch_sum, matcher_sum;
+		const double t_none = s_time(doc, len, repeat, &ctx, &none);
+		ctx.key_set = (char const* const*)keys;
+		ctx.key_set_length = count;
+		const double t_bsearch = s_time(doc, len, repeat, &ctx, &bsearch_sum);
+		ctx.key_matcher = &km;
+		const double t_matcher = s_time(doc, len, repeat, &ctx, &matcher_sum);
+
+		printf("%5u keys %6u KiB table: none %8.1f MB/s, key_set %8.1f MB/s, "
+			"matcher %8.1f MB/s\n", count, km.rows * km.stride * 2 / 1024,
+			t_none, t_bsearch, t_matcher);
+
+		if(bsearch_sum.sum != expect_sum || bsearch_sum.keys != expect_keys){
+			fprintf(stderr, "key_set enums wrong\n");
+			ret = 1;
+		}
+		if(matcher_sum.sum != expect_sum || matcher_sum.keys != expect_keys){
+			fprintf(stderr, "matcher enums wrong\n");
+			ret = 1;
+		}
+
+		free(storage);
+		unsigned j;
+		for(j = 0; j < count; ++j)
+			free(keys[j]);
+		free(keys);
+	}
+
+	free(doc);
+	return ret;
+}
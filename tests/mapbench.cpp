@@ -0,0 +1,135 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include <benejson/pull.hh>
+#include "posix.hh"
+
+/* Mapped input benchmark.
+ * Pulls every value of a file through BeginMapped(), then through an
+ * FD_Reader with a 64 KiB buffer. Reports time and peak resident memory
+ * after each; peak memory should stay small whatever the file size.
+ * With "skip", only numbers in maps and lists at the top two levels are
+ * read and everything deeper is passed over with Skip(), so parsing is
+ * cheap and the copy read() makes counts; files of long strings show it
+ * most.
+ * Usage: mapbench file [skip] */
+
+using BNJ::PullParser;
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double s_cpu(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static long s_maxrss_kb(void){
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_maxrss;
+}
+
+/* @return checksum of numbers at the top two levels. */
+static unsigned long long s_skim(PullParser& parser){
+	unsigned long long sum = 0;
+	while(true){
+		PullParser::State s = parser.Pull();
+		if(PullParser::ST_NO_DATA == s)
+			break;
+		if(PullParser::ST_DATUM == s){
+			const bnj_val& v = parser.GetValue();
+			if(BNJ_NUMERIC == bnj_val_type(&v))
+				sum += v.significand_val;
+			else
+				parser.Skip();
+		}
+		else if(parser.Depth() > 2 && (PullParser::ST_MAP == s
+			|| PullParser::ST_LIST == s))
+		{
+			parser.Skip();
+		}
+	}
+	return sum;
+}
+
+/* @return checksum of all pulled values. */
+static unsigned long long s_pull(PullParser& parser){
+	unsigned long long sum = 0;
+	char str[64];
+	while(true){
+		PullParser::State s = parser.Pull();
+		if(PullParser::ST_NO_DATA == s)
+			break;
+		if(PullParser::ST_DATUM != s)
+			continue;
+
+		const bnj_val& v = parser.GetValue();
+		if(BNJ_NUMERIC == bnj_val_type(&v))
+			sum += v.significand_val;
+		else if(BNJ_STRING == bnj_val_type(&v)){
+			unsigned len;
+			while((len = parser.ChunkRead8(str, sizeof(str))))
+				sum += len;
+		}
+	}
+	return sum;
+}
+
+int main(int argc, const char* argv[]){
+	if(argc < 2){
+		fprintf(stderr, "Usage: %s file [skip]\n", argv[0]);
+		return 1;
+	}
+	unsigned long long (*pull)(PullParser&) =
+		(argc > 2 && !strcmp(argv[2], "skip")) ? s_skim : s_pull;
+
+	uint32_t pstack[512];
+	unsigned long long sum_mapped, sum_read;
+	double t_mapped, t_read, c_mapped, c_read;
+	try{
+		double begin = s_now();
+		double cpu = s_cpu();
+		{
+			PullParser parser(512, pstack);
+			parser.BeginMapped(argv[1]);
+			sum_mapped = pull(parser);
+		}
+		t_mapped = s_now() - begin;
+		c_mapped = s_cpu() - cpu;
+		printf("mapped: %.2fs, cpu %.2fs, peak RSS %ld KiB\n", t_mapped, c_mapped,
+			s_maxrss_kb());
+
+		begin = s_now();
+		cpu = s_cpu();
+		{
+			static uint8_t buffer[(BUFF_OFFSET_MAX < 65536) ? BUFF_OFFSET_MAX : 65536];
+			FD_Reader reader(open(argv[1], O_RDONLY));
+			PullParser parser(512, pstack);
+			parser.Begin(buffer, sizeof(buffer), &reader);
+			sum_read = pull(parser);
+		}
+		t_read = s_now() - begin;
+		c_read = s_cpu() - cpu;
+		printf("read:   %.2fs, cpu %.2fs, peak RSS %ld KiB\n", t_read, c_read,
+			s_maxrss_kb());
+	}
+	catch(const std::exception& e){
+		fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+
+	if(sum_mapped != sum_read){
+		fprintf(stderr, "checksum mismatch\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <benejson/benejson.h>
+
+/* Number conversion tests. Each number is parsed inside a list, whole and
+ * a byte at a time, and its conversions compared with expected values. */
+
+struct float_test {
+	const char* json;
+	double d;
+	float f;
+};
+
+/* Correctly rounded results, round half to even. */
+static const struct float_test s_float[] = {
+	/* Signs and exact values. */
+	{"0", 0.0, 0.0f},
+	{"-0", -0.0, -0.0f},
+	{"1", 1.0, 1.0f},
+	{"-1", -1.0, -1.0f},
+	{"-2.5e-3", -0x1.47ae147ae147bp-9, -0x1.47ae14p-9f},
+	{"123456789e-5", 0x1.34a4584f4c6e7p+10, 0x1.34a458p+10f},
+
+	/* Inexact in both. */
+	{"0.1", 0x1.999999999999ap-4, 0x1.99999ap-4f},
+	{"0.3", 0x1.3333333333333p-2, 0x1.333334p-2f},
+	{"0.30000000000000004", 0x1.3333333333334p-2, 0x1.333334p-2f},
+	{"1e23", 0x1.52d02c7e14af6p+76, 0x1.52d02cp+76f},
+	{"6.02214076e23", 0x1.fe185ca57c517p+78, 0x1.fe185cp+78f},
+
+	/* Halfway between two doubles, or floats. */
+	{"9007199254740993", 0x1p+53, 0x1p+53f},
+	{"9007199254740995", 0x1.0000000000002p+53, 0x1p+53f},
+	{"16777217", 0x1.000001p+24, 0x1p+24f},
+	{"16777219", 0x1.000003p+24, 0x1.000004p+24f},
+	{"33554435", 0x1.0000018p+25, 0x1.000002p+25f},
+
+	/* Largest values and overflow. */
+	{"1e308", 0x1.1ccf385ebc8ap+1023, INFINITY},
+	{"8.98846567431158e307", 0x1p+1023, INFINITY},
+	{"1.7976931348623157e308", 0x1.fffffffffffffp+1023, INFINITY},
+	{"1.7976931348623158e308", 0x1.fffffffffffffp+1023, INFINITY},
+	{"1.7976931348623159e308", INFINITY, INFINITY},
+	{"1e400", INFINITY, INFINITY},
+	{"3.4028235e38", 0x1.fffffe54daff8p+127, 0x1.fffffep+127f},
+	{"3.4028236e38", 0x1.ffffff514a7bcp+127, INFINITY},
+
+	/* Smallest normals, subnormals and underflow. */
+	{"1e-308", 0x0.730d67819e8d2p-1022, 0.0f},
+	{"2.2250738585072014e-308", 0x1p-1022, 0.0f},
+	{"2.2250738585072011e-308", 0x0.fffffffffffffp-1022, 0.0f},
+	{"4.9e-324", 0x0.0000000000001p-1022, 0.0f},
+	{"5e-324", 0x0.0000000000001p-1022, 0.0f},
+	{"2.4703282292062328e-324", 0x0.0000000000001p-1022, 0.0f},
+	{"2.4703282292062327e-324", 0.0, 0.0f},
+	{"1e-400", 0.0, 0.0f},
+	{"1.17549435e-38", 0x1.fffffff9fdba8p-127, 0x1p-126f},
+	{"1.4e-45", 0x1.ff868bf4d956ap-150, 0x1p-149f},
+	{"7.006492321624086e-46", 0x1p-150, 0x1p-149f},
+	{"7.006492321624085e-46", 0x1p-150, 0.0f},
+	{"1e-46", 0x1.244ce242c5561p-153, 0.0f},
+};
+
+struct trunc_test {
+	const char* json;
+	SIGNIFICAND significand;
+	int exp;
+	unsigned trunc;
+	unsigned negative;
+};
+
+/* Significands beyond SIGNIFICAND's digits keep the leading digits; the
+ * exponent makes up for the digits dropped. */
+static const struct trunc_test s_trunc[] = {
+	{"123", 123, 0, 0, 0},
+	{"-0", 0, 0, 0, 1},
+	{"1e3", 1, 3, 0, 0},
+	{"10.0", 100, -1, 0, 0},
+	{"1200e-2", 1200, -2, 0, 0},
+	{"9999999999999999999", 9999999999999999999ULL, 0, 0, 0},
+	{"18446744073709551615", 1844674407370955161ULL, 1, 1, 0},
+	{"99999999999999999999", 9999999999999999999ULL, 1, 1, 0},
+	{"12345678901234567890123", 12345678901234567890ULL, 3, 3, 0},
+	{"-1234567890123456789012.5e-3", 12345678901234567890ULL, -1, 3, 1},
+	{"0.000123456789012345678901", 12345678901234567890ULL, -23, 1, 0},
+	{"1.00000000000000011102230246251565404236316680908203125",
+		10000000000000001110ULL, -19, 34, 0},
+};
+
+/* Last completed number reported. */
+struct num_result {
+	bnj_val v;
+	unsigned count;
+
+	/* Number text, if it was in the buffer. */
+	char text[128];
+	unsigned text_len;
+};
+
+static int s_num_cb(const bnj_state* state, bnj_ctx* ctx, const uint8_t* buff){
+	struct num_result* r = ctx->user_data;
+	for(unsigned i = 0; i < state->vi; ++i){
+		if(BNJ_NUMERIC == bnj_val_type(state->v + i)
+			&& !(state->v[i].type & BNJ_VFLAG_VAL_FRAGMENT))
+		{
+			r->v = state->v[i];
+			++r->count;
+
+			const uint8_t* text = bnj_numtext(state->v + i, buff, &r->text_len);
+			if(text)
+				memcpy(r->text, text, r->text_len);
+			else
+				r->text_len = 0;
+		}
+	}
+	return 0;
+}
+
+/* Parse "[json]" in pieces of step bytes.
+ * @return 0 if a number was parsed without errors. */
+static unsigned s_parse(const char* json, unsigned step, struct num_result* r){
+	uint32_t stackbuff[16];
+	bnj_val values[16];
+	bnj_state mstate;
+	bnj_ctx ctx = {
+		.user_cb = s_num_cb,
+		.user_data = r,
+	};
+	char doc[128];
+	const unsigned len = snprintf(doc, sizeof(doc), "[%s]", json);
+
+	r->count = 0;
+	bnj_state_init(&mstate, stackbuff, 16);
+	mstate.v = values;
+	mstate.vlen = 16;
+	for(unsigned x = 0; x < len; x += step){
+		const unsigned chunk = (len - x < step) ? len - x : step;
+		bnj_parse(&mstate, &ctx, (const uint8_t*)doc + x, chunk);
+		if(mstate.flags & BNJ_ERROR_MASK)
+			return 1;
+	}
+	return !r->count;
+}
+
+/* Compare bit patterns, so that -0 differs from 0. */
+static unsigned s_same_double(double a, double b){
+	return !memcmp(&a, &b, sizeof(double));
+}
+
+static unsigned s_same_float(float a, float b){
+	return !memcmp(&a, &b, sizeof(float));
+}
+
+int main(int argc, const char* argv[]){
+	unsigned i;
+	unsigned succeeded, failed;
+
+	/* Float test. */
+	const unsigned float_length = sizeof(s_float) / sizeof(struct float_test);
+	succeeded = 0;
+	failed = 0;
+	for(i = 0; i < float_length; ++i){
+		const struct float_test* ft = s_float + i;
+		unsigned ok = 1;
+		for(unsigned step = 1; step <= 128 && ok; step *= 128){
+			struct num_result r;
+			if(s_parse(ft->json, step, &r)){
+				fprintf(stdout, "Float Test %u, step %u, parse failed\n", i, step);
+				ok = 0;
+				break;
+			}
+
+			const double d = bnj_double(&r.v);
+			const float f = bnj_float(&r.v);
+			if(!s_same_double(d, ft->d)){
+				fprintf(stdout, "Float Test %u, step %u, double expected %a, got %a\n",
+					i, step, ft->d, d);
+				ok = 0;
+			}
+			if(!s_same_float(f, ft->f)){
+				fprintf(stdout, "Float Test %u, step %u, float expected %a, got %a\n",
+					i, step, ft->f, f);
+				ok = 0;
+			}
+		}
+		if(ok)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Float Tests total: %u, succeeded: %u, failed %u\n",
+		float_length, succeeded, failed);
+
+	/* Truncation test. */
+	const unsigned trunc_length = sizeof(s_trunc) / sizeof(struct trunc_test);
+	succeeded = 0;
+	failed = 0;
+	for(i = 0; i < trunc_length; ++i){
+		const struct trunc_test* tt = s_trunc + i;
+		unsigned ok = 1;
+		for(unsigned step = 1; step <= 128 && ok; step *= 128){
+			struct num_result r;
+			if(s_parse(tt->json, step, &r)){
+				fprintf(stdout, "Truncation Test %u, step %u, parse failed\n", i, step);
+				ok = 0;
+				break;
+			}
+
+			const unsigned negative =
+				!!(r.v.type & BNJ_VFLAG_NEGATIVE_SIGNIFICAND);
+			if(r.v.significand_val != tt->significand || r.v.exp_val != tt->exp
+				|| bnj_truncated(&r.v) != tt->trunc || negative != tt->negative)
+			{
+				fprintf(stdout, "Truncation Test %u, step %u, expected %llu e%d "
+					"truncated %u, got %llu e%d truncated %u\n", i, step,
+					(unsigned long long)tt->significand, tt->exp, tt->trunc,
+					(unsigned long long)r.v.significand_val, r.v.exp_val,
+					bnj_truncated(&r.v));
+				ok = 0;
+			}
+
+			/* Whole, the number text stays in the buffer, without its sign. */
+			if(step > 1){
+				const char* text = tt->json + ('-' == tt->json[0]);
+				if(r.text_len != strlen(text) || memcmp(r.text, text, r.text_len)){
+					fprintf(stdout, "Truncation Test %u, text \"%.*s\"\n", i,
+						r.text_len, r.text);
+					ok = 0;
+				}
+			}
+		}
+		if(ok)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Truncation Tests total: %u, succeeded: %u, failed %u\n",
+		trunc_length, succeeded, failed);
+
+	return 0;
+}
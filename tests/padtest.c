@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <benejson/benejson.h>
+
+/* Padded parse tests. Each document is parsed in pieces of every size
+ * from 1 to 64 and whole, with bnj_parse and with bnj_parse_padded on a
+ * copy padded with random bytes after the 0 sentinel. The values reported,
+ * flags and stop offsets must be identical. */
+
+static const char* s_docs[] = {
+	"[]",
+	"  \t\r\n {  \"a\" :\t1 ,\n\n \"b\"  :   [ true , false , null ] }   \n",
+	"[\"a long ascii string that runs on for well over sixty four bytes, "
+		"so block scans see whole blocks\"]",
+	"{\"caf\xC3\xA9\":\"\xE2\x82\xAC 100, \xF0\x9F\x98\x80 and "
+		"\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E text past one block\"}",
+	"[\"esc \\\" \\\\ \\/ \\b \\f \\n \\r \\t \\u00e9 \\ud83d\\ude00 end\"]",
+	"[0, -0, 12345678, 123456789012345678, 12345678901234567890123, "
+		"1.25e-300, -98765432.12345678e+12, 1e3]",
+	"[NaN, -Infinity, Infinity, \"\", {}, [[[]]]]",
+	"{\"k\":1}\n{\"k\":2}",
+
+	/* Errors stop both at the same place. */
+	"[\"bad \xC0\x80 utf8\"]",
+	"[\"bad \\q escape\"]",
+	"[\"raw \x01 control\"]",
+	"[1,,2]",
+	"[12345678x]",
+	"{\"x\" 1}",
+	"[tru]",
+	"[\"unterminated                                            ",
+};
+
+/* Values reported, folded into a hash. */
+struct digest {
+	uint64_t hash;
+	unsigned count;
+};
+
+static void s_fold(struct digest* d, uint64_t v){
+	d->hash = (d->hash ^ v) * 0x100000001B3ULL;
+}
+
+static int s_cb(const bnj_state* state, bnj_ctx* ctx, const uint8_t* buff){
+	struct digest* d = ctx->user_data;
+	for(unsigned i = 0; i < state->vi; ++i){
+		const bnj_val* v = state->v + i;
+		s_fold(d, v->type);
+		s_fold(d, v->key_length);
+		s_fold(d, v->key_enum);
+		s_fold(d, v->key_offset);
+		s_fold(d, v->strval_offset);
+		s_fold(d, v->cp1_count);
+		s_fold(d, v->cp2_count);
+		s_fold(d, v->cp3_count);
+		s_fold(d, v->num_length);
+		s_fold(d, v->trunc_count);
+		s_fold(d, (uint64_t)(int64_t)v->exp_val);
+		s_fold(d, v->significand_val);
+		++d->count;
+	}
+	return 0;
+}
+
+static const char* s_keys[] = {"a", "b", "caf\xC3\xA9", "k"};
+
+/* Parse doc in pieces of step bytes; step 0 parses it whole.
+ * @return digest of values, flags and stop offsets. */
+static struct digest s_parse(const char* doc, unsigned step, unsigned padded){
+	uint32_t stackbuff[16];
+	bnj_val values[4];
+	bnj_state mstate;
+	struct digest d = {0xCBF29CE484222325ULL, 0};
+	bnj_ctx ctx = {
+		.user_cb = s_cb,
+		.user_data = &d,
+		.key_set = s_keys,
+		.key_set_length = 4,
+	};
+	const unsigned len = strlen(doc);
+	if(!step)
+		step = len;
+
+	/* Fields a value type does not use keep what the array held. */
+	memset(values, 0, sizeof(values));
+	bnj_state_init(&mstate, stackbuff, 16);
+	mstate.v = values;
+	mstate.vlen = 4;
+	for(unsigned x = 0; x < len; x += step){
+		const unsigned chunk = (len - x < step) ? len - x : step;
+
+		/* Tight allocations, so reads past the padding are caught. */
+		uint8_t* buff = malloc(chunk + BNJ_PADDING);
+		memcpy(buff, doc + x, chunk);
+		buff[chunk] = 0;
+		for(unsigned p = 1; p < BNJ_PADDING; ++p)
+			buff[chunk + p] = rand();
+
+		const uint8_t* res = padded
+			? bnj_parse_padded(&mstate, &ctx, buff, chunk)
+			: bnj_parse(&mstate, &ctx, buff, chunk);
+		s_fold(&d, x + (res - buff));
+		s_fold(&d, mstate.flags);
+		free(buff);
+		if(mstate.flags & BNJ_ERROR_MASK)
+			break;
+	}
+	return d;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned succeeded, failed;
+
+	const unsigned doc_length = sizeof(s_docs) / sizeof(const char*);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < doc_length; ++i){
+		unsigned ok = 1;
+		for(unsigned step = 0; step <= 64; ++step){
+			const struct digest a = s_parse(s_docs[i], step, 0);
+			const struct digest b = s_parse(s_docs[i], step, 1);
+			if(a.hash != b.hash || a.count != b.count){
+				fprintf(stdout, "Padded Test %u, step %u, differs from bnj_parse\n",
+					i, step);
+				ok = 0;
+			}
+		}
+		if(ok)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Padded Tests total: %u, succeeded: %u, failed %u\n",
+		doc_length, succeeded, failed);
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+#include <benejson/paths.hh>
+
+/* Multiple path extraction benchmark.
+ * Generates one large document of records, then finds 20 JSON Pointers
+ * spread through it: once with a PathSet per pointer, one pass each, as
+ * running jsongrab per path does, and once with all of them in one PathSet.
+ * Both must find the same values.
+ * Usage: pathbench [doc_mb] */
+
+using BNJ::PullParser;
+using BNJ::PathSet;
+
+static unsigned s_rng = 12345;
+
+static unsigned s_rand(void){
+	s_rng = s_rng * 1103515245 + 12345;
+	return (s_rng >> 16) & 0x7FFF;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Sums numeric values found. */
+class Summer : public PathSet::Handler {
+	public:
+		Summer(void) throw() : sum(0) {}
+
+		void Match(unsigned path, PullParser& parser){
+			sum += parser.GetValue().significand_val;
+		}
+
+		unsigned long long sum;
+};
+
+/* @return Paths found in doc. */
+static unsigned s_extract(const char* const* pointers, unsigned count,
+	const uint8_t* doc, size_t len, Summer& summer)
+{
+	PathSet::Node nodes[64];
+	const char* keys[64];
+	char text[1024];
+	PathSet paths(nodes, keys, 64, text, sizeof(text));
+	if(paths.Compile(pointers, count))
+		return 0;
+
+	uint32_t pstack[16];
+	PullParser parser(16, pstack);
+	parser.Begin(doc, len);
+	return paths.Extract(parser, summer);
+}
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 32;
+
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = (uint8_t*)malloc(cap + 1024);
+
+	/* Records in a list, then a summary at the end. */
+	size_t len = sprintf((char*)doc, "{\"records\":[");
+	unsigned records = 0;
+	while(len < cap){
+		len += sprintf((char*)doc + len,
+			"%s{\"id\":%u,\"user\":\"u%u\",\"score\":%u,\"tags\":[%u,%u]}",
+			records ? "," : "", s_rand(), s_rand(), s_rand(), s_rand() % 16,
+			s_rand() % 16);
+		++records;
+	}
+	len += sprintf((char*)doc + len, "],\"summary\":{\"count\":%u,\"max\":%u}}",
+		records, s_rand());
+
+	/* 18 fields spread through the records, plus the summary. */
+	const unsigned count = 20;
+	char storage[count][64];
+	const char* pointers[count];
+	for(unsigned i = 0; i < count - 2; ++i){
+		static const char* fields[] = {"id", "score", "tags/1"};
+		sprintf(storage[i], "/records/%u/%s",
+			(unsigned)((unsigned long long)records * i / (count - 2)),
+			fields[i % 3]);
+		pointers[i] = storage[i];
+	}
+	pointers[count - 2] = "/summary/count";
+	pointers[count - 1] = "/summary/max";
+
+	Summer sums[2];
+	unsigned found[2] = {0, 0};
+	double times[2];
+
+	double begin = s_now();
+	for(unsigned i = 0; i < count; ++i)
+		found[0] += s_extract(pointers + i, 1, doc, len, sums[0]);
+	times[0] = s_now() - begin;
+
+	begin = s_now();
+	found[1] = s_extract(pointers, count, doc, len, sums[1]);
+	times[1] = s_now() - begin;
+
+	printf("%zu bytes, %u paths: pass per path %.2fs, one pass %.2fs\n",
+		len, count, times[0], times[1]);
+
+	free(doc);
+
+	if(found[0] != count || found[1] != count || sums[0].sum != sums[1].sum){
+		fprintf(stderr, "checksum mismatch\n");
+		return 1;
+	}
+	return 0;
+}
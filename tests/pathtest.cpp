@@ -0,0 +1,173 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <benejson/pull.hh>
+#include <benejson/paths.hh>
+#include "posix.hh"
+
+/* JSON Pointer set tests. Each document is searched for a set of pointers,
+ * through readers fed a few bytes per read and in place. Matches are traced
+ * as "pointer index:value;" in document order, then the count found. */
+
+using BNJ::PullParser;
+
+struct path_test {
+	const char* json;
+	const char* pointers[4];
+	unsigned count;
+	const char* trace;
+};
+
+static const path_test s_path[] = {
+	/* Escapes; ~01 is "~1", not "/". */
+	{"{\"a/b\":1,\"m~n\":2,\"~1\":3,\"/\":4}", {"/a~1b", "/m~0n", "/~01", "/~1"},
+		4, "0:1;1:2;2:3;3:4;4"},
+	{"{\"a\\/b\":1,\"\\u007e1\":2}", {"/a~1b", "/~01"}, 2, "0:1;1:2;2"},
+
+	/* Whole document and empty keys. */
+	{"[1,2]", {""}, 1, "0:[];1"},
+	{"{\"\":{\"\":5}}", {"/", "//"}, 2, "0:{};1:5;2"},
+
+	/* Array indices are canonical decimal; "-" and "01" are keys only. */
+	{"[10,11,12]", {"/1", "/01", "/-", "/3"}, 4, "0:11;1"},
+	{"{\"1\":10,\"01\":11,\"-\":12}", {"/1", "/01", "/-"}, 3,
+		"0:10;1:11;2:12;3"},
+	{"[[1,[2,3]],4]", {"/0/1/1", "/1", "/0/0"}, 3, "2:1;0:3;1:4;3"},
+
+	/* Of duplicate keys, only the first is searched. */
+	{"{\"a\":1,\"a\":2}", {"/a"}, 1, "0:1;1"},
+	{"{\"a\":{\"x\":1},\"a\":{\"x\":2,\"y\":3}}", {"/a/x", "/a/y"}, 2,
+		"0:1;1"},
+	{"{\"a\":{},\"a\":{\"x\":1}}", {"/a", "/a/x"}, 2, "0:{};1"},
+
+	/* Errors before a path fail the search. */
+	{"{\"b\":[},\"a\":1}", {"/a"}, 1, "E"},
+};
+
+struct compile_test {
+	const char* pointers[2];
+	unsigned count;
+
+	/* Whether Compile() fails. */
+	bool fails;
+};
+
+static const compile_test s_compile[] = {
+	{{"/a", "/b"}, 2, false},
+	{{"a"}, 1, true},
+	{{"/~2"}, 1, true},
+	{{"/a~"}, 1, true},
+	{{"/a", "/a"}, 2, true},
+	{{"/a~1b", "/a/b"}, 2, false},
+};
+
+/* Trace each match. */
+class Tracer : public BNJ::PathSet::Handler {
+	public:
+		void Match(unsigned path, PullParser& parser){
+			char text[64];
+			snprintf(text, sizeof(text), "%u:", path);
+			trace += text;
+			if(PullParser::ST_MAP == parser.GetState())
+				trace += "{}";
+			else if(PullParser::ST_LIST == parser.GetState())
+				trace += "[]";
+			else{
+				unsigned n;
+				BNJ::Get(n, parser);
+				snprintf(text, sizeof(text), "%u", n);
+				trace += text;
+			}
+			trace += ";";
+		}
+
+		std::string trace;
+};
+
+/* @return trace of searching the document; chunk 0 searches in place. */
+static std::string s_search(const path_test& t, unsigned chunk){
+	unsigned node_len, text_len;
+	BNJ::PathSet::StorageSize(t.pointers, t.count, node_len, text_len);
+	BNJ::PathSet::Node nodes[node_len];
+	const char* keys[node_len];
+	char text[text_len + 1];
+	BNJ::PathSet paths(nodes, keys, node_len, text, text_len + 1);
+	if(paths.Compile(t.pointers, t.count))
+		return "compile error";
+
+	const unsigned len = strlen(t.json);
+	Mem_Reader reader(t.json, len, chunk);
+	uint32_t pstack[8];
+	uint8_t buffer[32];
+	PullParser parser(8, pstack);
+	if(chunk)
+		parser.Begin(buffer, sizeof(buffer), &reader);
+	else
+		parser.Begin((const uint8_t*)t.json, len);
+
+	Tracer tracer;
+	const int found = paths.TryExtract(parser, tracer);
+	if(found < 0)
+		return tracer.trace + "E";
+	char count[16];
+	snprintf(count, sizeof(count), "%d", found);
+	return tracer.trace + count;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned succeeded, failed;
+
+	/* Search test. */
+	const unsigned path_length = sizeof(s_path) / sizeof(path_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < path_length; ++i){
+		bool pass = true;
+		for(unsigned chunk = 0; chunk <= 64; chunk = chunk ? chunk * 4 : 1){
+			std::string trace;
+			try{
+				trace = s_search(s_path[i], chunk);
+			}
+			catch(const std::exception& e){
+				trace = e.what();
+			}
+			if(trace != s_path[i].trace){
+				fprintf(stdout, "Path Test %u, chunk %u: expected %s, got %s\n", i,
+					chunk, s_path[i].trace, trace.c_str());
+				pass = false;
+			}
+		}
+		if(pass)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Path Tests total: %u, succeeded: %u, failed %u\n",
+		path_length, succeeded, failed);
+
+	/* Compile test. */
+	const unsigned compile_length = sizeof(s_compile) / sizeof(compile_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < compile_length; ++i){
+		const compile_test& t = s_compile[i];
+		unsigned node_len, text_len;
+		BNJ::PathSet::StorageSize(t.pointers, t.count, node_len, text_len);
+		BNJ::PathSet::Node nodes[node_len];
+		const char* keys[node_len];
+		char text[text_len + 1];
+		BNJ::PathSet paths(nodes, keys, node_len, text, text_len + 1);
+		if((NULL != paths.Compile(t.pointers, t.count)) != t.fails){
+			fprintf(stdout, "Compile Test %u failed\n", i);
+			++failed;
+		}
+		else{
+			++succeeded;
+		}
+	}
+	fprintf(stdout, "Compile Tests total: %u, succeeded: %u, failed %u\n",
+		compile_length, succeeded, failed);
+
+	return 0;
+}
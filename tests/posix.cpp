@@ -2,6 +2,7 @@
  * See the file LICENSE for full license information. */
 
 #include <errno.h>
+#include <string.h>
 #include <unistd.h>
 #include "posix.hh"
 
@@ -38,3 +39,19 @@ int FD_Reader::Read(uint8_t* buff, unsigned len) throw(){
 		return ret;
 	}
 }
+
+Mem_Reader::Mem_Reader(const void* data, unsigned len, unsigned chunk) throw()
+	: _data((const uint8_t*)data), _len(len), _chunk(chunk)
+{
+}
+
+int Mem_Reader::Read(uint8_t* buff, unsigned len) throw(){
+	if(len > _chunk)
+		len = _chunk;
+	if(len > _len)
+		len = _len;
+	memcpy(buff, _data, len);
+	_data += len;
+	_len -= len;
+	return len;
+}
@@ -30,6 +30,30 @@ class FD_Reader: public BNJ::PullParser::Reader {
 		int _errno;
 };
 
+/** @brief Read character data from memory, a few bytes at a time. */
+class Mem_Reader: public BNJ::PullParser::Reader {
+	public:
+		/** @brief ctor, initialize with data.
+		 *  @param data Data to read; must outlive this instance.
+		 *  @param len Length of data.
+		 *  @param chunk Most bytes returned per Read(), so values span
+		 *  refills. */
+		Mem_Reader(const void* data, unsigned len, unsigned chunk) throw();
+
+		/** @brief Override. */
+		int Read(uint8_t* buff, unsigned len) throw();
+
+	private:
+		/** @brief Data not read yet. */
+		const uint8_t* _data;
+
+		/** @brief Length of _data. */
+		unsigned _len;
+
+		/** @brief Most bytes per Read(). */
+		unsigned _chunk;
+};
+
 /* Inlines. */
 
 inline int FD_Reader::Errno(void) const throw() {
@@ -0,0 +1,134 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+#include <benejson/pull.hh>
+
+/* Projection benchmark.
+ * Generates a list of wide event records, about 2 KB each, then sums three
+ * of their fields: once skipping the other members after the C parser
+ * decoded them, once with a projection so the C parser validates them
+ * without reporting them, and once with a structural projection that only
+ * matches their quotes and brackets. All must find the same values.
+ * Usage: projbench [doc_mb] */
+
+using BNJ::PullParser;
+
+static unsigned s_rng = 12345;
+
+static unsigned s_rand(void){
+	s_rng = s_rng * 1103515245 + 12345;
+	return (s_rng >> 16) & 0x7FFF;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Sorted keys of the fields read. */
+static const char* s_keys[] = {"id", "score", "user"};
+
+enum {
+	KEY_ID,
+	KEY_SCORE,
+	KEY_USER,
+	KEY_COUNT
+};
+
+/* @return Sum of the id and score fields, plus user name lengths. */
+static unsigned long long s_sum(const uint8_t* doc, size_t len,
+	const bnj_projection* projection)
+{
+	uint32_t pstack[16];
+	PullParser parser(16, pstack);
+	parser.Begin(doc, len);
+	parser.SetProjection(projection);
+
+	unsigned long long sum = 0;
+	char user[64];
+	parser.Pull();
+	while(parser.Pull() == PullParser::ST_MAP){
+		while(parser.Pull(s_keys, KEY_COUNT) != PullParser::ST_ASCEND_MAP){
+			switch(parser.GetValue().key_enum){
+				case KEY_ID:
+				case KEY_SCORE:
+					sum += parser.GetValue().significand_val;
+					break;
+
+				case KEY_USER:
+					sum += parser.ChunkRead8(user, sizeof(user));
+					break;
+
+				default:
+					parser.Skip();
+			}
+		}
+	}
+	return sum;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 32;
+
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = (uint8_t*)malloc(cap + 4096);
+
+	/* Fields read are spread among padding, nested context and numbers. */
+	size_t len = sprintf((char*)doc, "[");
+	unsigned records = 0;
+	while(len < cap){
+		len += sprintf((char*)doc + len, "%s{\"ts\":%u.%03u,\"id\":%u,",
+			records ? "," : "", s_rand(), s_rand() % 1000, s_rand());
+		for(unsigned f = 0; f < 24; ++f){
+			len += sprintf((char*)doc + len, "\"attr%02u\":\"", f);
+			for(unsigned c = 0; c < 40; ++c)
+				doc[len++] = 'a' + s_rand() % 26;
+			len += sprintf((char*)doc + len, "\\u00e9\\n\",\"n%02u\":%d,", f,
+				(int)s_rand() - 16384);
+		}
+		len += sprintf((char*)doc + len,
+			"\"user\":\"u%u\",\"ctx\":{\"tags\":[%u,%u,%u],\"ok\":true},"
+			"\"score\":%u}", s_rand(), s_rand(), s_rand(), s_rand(), s_rand());
+		++records;
+	}
+	len += sprintf((char*)doc + len, "]");
+
+	/* Every record, but only the three members of each. */
+	const bnj_projlevel levels[] = {
+		{NULL, 0, 0, UINT32_MAX},
+		{s_keys, KEY_COUNT, 0, UINT32_MAX}
+	};
+	const bnj_projection projection = {levels, 2, 0};
+	const bnj_projection structural = {levels, 2, 1};
+
+	unsigned long long sums[3];
+	double times[3];
+
+	double begin = s_now();
+	sums[0] = s_sum(doc, len, NULL);
+	times[0] = s_now() - begin;
+
+	begin = s_now();
+	sums[1] = s_sum(doc, len, &projection);
+	times[1] = s_now() - begin;
+
+	begin = s_now();
+	sums[2] = s_sum(doc, len, &structural);
+	times[2] = s_now() - begin;
+
+	printf("%zu bytes, %u records: skip %.2fs (%.0f MB/s), "
+		"projection %.2fs (%.0f MB/s), structural %.2fs (%.0f MB/s)\n",
+		len, records, times[0], len / times[0] / 1e6, times[1],
+		len / times[1] / 1e6, times[2], len / times[2] / 1e6);
+
+	free(doc);
+
+	if(sums[0] != sums[1] || sums[0] != sums[2]){
+		fprintf(stderr, "checksum mismatch\n");
+		return 1;
+	}
+	return 0;
+}
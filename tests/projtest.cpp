@@ -0,0 +1,216 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <benejson/pull.hh>
+#include "posix.hh"
+
+/* Projection tests. Each document is pulled whole through a projection, in
+ * place and through readers fed a few bytes per read, with values left out
+ * both validated and passed over structurally. Reported values are traced:
+ * numbers, brackets, 's' for strings, then '.' at the end or 'E' on errors. */
+
+using BNJ::PullParser;
+
+static const char* s_keys_a[] = {"a"};
+static const char* s_keys_ac[] = {"a", "c"};
+
+static const bnj_projlevel s_all = {NULL, 0, 0, UINT32_MAX};
+static const bnj_projlevel s_a = {s_keys_a, 1, 0, UINT32_MAX};
+static const bnj_projlevel s_ac = {s_keys_ac, 2, 0, UINT32_MAX};
+static const bnj_projlevel s_head = {NULL, 0, 0, 1};
+static const bnj_projlevel s_second = {NULL, 0, 1, 2};
+static const bnj_projlevel s_middle = {NULL, 0, 1, 3};
+static const bnj_projlevel s_third = {NULL, 0, 2, 3};
+
+struct proj_test {
+	const char* json;
+	bnj_projlevel levels[2];
+	unsigned length;
+
+	/* Trace with values left out validated, and passed over structurally. */
+	const char* trace;
+	const char* structural;
+};
+
+static const proj_test s_proj[] = {
+	{"{\"a\":1,\"b\":{\"x\":[1,{\"y\":2}],\"z\":\"s\"},\"c\":3}", {s_ac}, 1,
+		"{13}.", "{13}."},
+	{"{\"x\":[],\"y\":{},\"a\":[]}", {s_a}, 1, "{[]}.", "{[]}."},
+	{"{\"x\":[[[[{\"k\":\"v\"}]]]],\"a\":{\"k\":\"v\"}}", {s_a}, 1,
+		"{{s}}.", "{{s}}."},
+	{"{\"s\":\"\\u00e9\\ud83d\\ude00\xC3\xA9\xF0\x9F\x98\x80\",\"a\":\"t\"}",
+		{s_a}, 1, "{s}.", "{s}."},
+	{"[1,[2,3],{\"a\":4},5,6]", {s_middle}, 1, "[[23]{4}].", "[[23]{4}]."},
+	{"[[1,2,3],[4,5,6]]", {s_all, s_second}, 2, "[[2][5]].", "[[2][5]]."},
+	{"[0,[1,[2]],{\"a\":[3]},\"s\",4]", {s_head}, 1, "[0].", "[0]."},
+	{"{\"b\":[[1],{\"x\":[2]}],\"a\":[[3,4],[5]]}", {s_a, s_head}, 2,
+		"{[[34]]}.", "{[[34]]}."},
+
+	/* Malformed only inside values left out. */
+	{"{\"x\":\"\\q\",\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":\"\xFF\",\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":\"\x01\",\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":[\"\\ud800\"],\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":[\"\xC0\x80\"],\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":[1,,2],\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":[tru],\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":[-],\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":{\"y\" 1},\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":{\"y\":[{\"z\":1,}]},\"a\":1}", {s_a}, 1, "{E", "{1}."},
+	{"{\"x\":{\"y\":1 \"z\":2},\"a\":1}", {s_a}, 1, "{E", "{1}."},
+
+	/* The error ends the batch holding 0. */
+	{"[0,[1,,2]]", {s_head}, 1, "[E", "[0]."},
+	{"[0,\"\\q\"]", {s_head}, 1, "[E", "[0]."},
+
+	/* Numbers and literals are validated either way. */
+	{"{\"x\":tru,\"a\":1}", {s_a}, 1, "{E", "{E"},
+	{"{\"x\":1e,\"a\":1}", {s_a}, 1, "{E", "{E"},
+
+	/* Brackets that do not nest. */
+	{"{\"x\":[1,2},\"a\":1}", {s_a}, 1, "{E", "{E"},
+};
+
+/* Skip() called on the first map or list at depth 2, traced '~', while the c
+ * parser may be inside values left out of it. */
+static const proj_test s_skip[] = {
+	{"[[[9,[7]],[8],0,1],5]", {s_all, s_third}, 2, "[[~]5].", "[[~]5]."},
+	{"{\"a\":[[9],{\"x\":[1]},2,3],\"b\":3}", {s_all, s_third}, 2,
+		"{[~]3}.", "{[~]3}."},
+	{"[[[[[[9]]]],[8],0,[1]],5]", {s_all, s_third}, 2, "[[~]5].", "[[~]5]."},
+	{"[[[[9]],[8],0],[0,1,[2]]]", {s_all, s_third}, 2, "[[~][[2]]].",
+		"[[~][[2]]]."},
+	{"[{\"x\":[[1]],\"y\":{\"z\":[2]},\"a\":1},5]", {s_all, s_a}, 2,
+		"[{~}5].", "[{~}5]."},
+};
+
+/* @param chunk Bytes per read; 0 parses in place.
+ * @param skip Call Skip() on the first map or list at depth 2.
+ * @return trace of pulling the document. */
+static std::string s_trace(const proj_test& t, unsigned chunk, bool structural,
+	bool skip)
+{
+	const bnj_projection projection = {t.levels, t.length, structural};
+	const unsigned len = strlen(t.json);
+	Mem_Reader reader(t.json, len, chunk);
+	uint32_t pstack[8];
+	uint8_t buffer[32];
+	PullParser parser(8, pstack);
+	if(chunk)
+		parser.Begin(buffer, sizeof(buffer), &reader);
+	else
+		parser.Begin((const uint8_t*)t.json, len);
+	parser.SetProjection(&projection);
+
+	std::string trace;
+	while(true){
+		switch(parser.TryPull()){
+			case PullParser::ST_ERROR:
+				return trace + "E";
+
+			case PullParser::ST_NO_DATA:
+				return trace + ".";
+
+			case PullParser::ST_MAP:
+			case PullParser::ST_LIST:
+				trace += (PullParser::ST_MAP == parser.GetState()) ? "{" : "[";
+				if(skip && 2 == parser.Depth()){
+					skip = false;
+					if(PullParser::ST_ERROR == parser.TrySkip())
+						return trace + "E";
+					trace += (PullParser::ST_ASCEND_MAP == parser.GetState())
+						? "~}" : "~]";
+				}
+				break;
+
+			case PullParser::ST_ASCEND_MAP:
+				trace += "}";
+				break;
+
+			case PullParser::ST_ASCEND_LIST:
+				trace += "]";
+				break;
+
+			case PullParser::ST_DATUM:
+				if(BNJ_STRING == bnj_val_type(&parser.GetValue())){
+					char text[64];
+					if(parser.TryChunkRead8(text, sizeof(text)) < 0)
+						return trace + "E";
+					trace += "s";
+				}
+				else{
+					unsigned n;
+					char num[16];
+					if(PullParser::ERR_NONE != BNJ::TryGet(n, parser))
+						return trace + "E";
+					snprintf(num, sizeof(num), "%u", n);
+					trace += num;
+				}
+				break;
+
+			default:
+				return trace + "?";
+		}
+	}
+}
+
+int main(int argc, const char* argv[]){
+	unsigned succeeded, failed;
+
+	const unsigned proj_length = sizeof(s_proj) / sizeof(proj_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < proj_length; ++i){
+		bool pass = true;
+		for(unsigned chunk = 0; chunk <= 64; chunk = chunk ? chunk * 4 : 1){
+			for(unsigned structural = 0; structural < 2; ++structural){
+				const char* expected =
+					structural ? s_proj[i].structural : s_proj[i].trace;
+				const std::string trace = s_trace(s_proj[i], chunk, structural, false);
+				if(trace != expected){
+					fprintf(stdout, "Projection Test %u, chunk %u%s: expected %s, "
+						"got %s\n", i, chunk, structural ? ", structural" : "",
+						expected, trace.c_str());
+					pass = false;
+				}
+			}
+		}
+		if(pass)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Projection Tests total: %u, succeeded: %u, failed %u\n",
+		proj_length, succeeded, failed);
+
+	/* Skip() test. */
+	const unsigned skip_length = sizeof(s_skip) / sizeof(proj_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < skip_length; ++i){
+		bool pass = true;
+		for(unsigned chunk = 0; chunk <= 64; chunk = chunk ? chunk * 4 : 1){
+			for(unsigned structural = 0; structural < 2; ++structural){
+				const char* expected =
+					structural ? s_skip[i].structural : s_skip[i].trace;
+				const std::string trace =
+					s_trace(s_skip[i], chunk, structural, true);
+				if(trace != expected){
+					fprintf(stdout, "Skip Test %u, chunk %u%s: expected %s, "
+						"got %s\n", i, chunk, structural ? ", structural" : "",
+						expected, trace.c_str());
+					pass = false;
+				}
+			}
+		}
+		if(pass)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Skip Tests total: %u, succeeded: %u, failed %u\n",
+		skip_length, succeeded, failed);
+
+	return 0;
+}
@@ -0,0 +1,146 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+#include <benejson/pull.hh>
+
+/* PullParser value batch benchmark.
+ * Generates a document of records holding a wide list of numbers and a map
+ * of short strings, then pulls every value with growing batch sizes. Each
+ * pass runs over the complete buffer and through a Reader with a 64 KiB
+ * buffer. Value checksums must match across batch sizes.
+ * Usage: pullbench [doc_mb [repeat]] */
+
+using BNJ::PullParser;
+
+static unsigned s_rng = 12345;
+
+static unsigned s_rand(void){
+	s_rng = s_rng * 1103515245 + 12345;
+	return (s_rng >> 16) & 0x7FFF;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Reads a document already in memory. */
+class Mem_Reader : public PullParser::Reader {
+	public:
+		Mem_Reader(const uint8_t* doc, size_t len) throw()
+			: _doc(doc), _end(doc + len) {}
+
+		int Read(uint8_t* buff, unsigned len) throw(){
+			if(len > (size_t)(_end - _doc))
+				len = _end - _doc;
+			memcpy(buff, _doc, len);
+			_doc += len;
+			return len;
+		}
+
+	private:
+		const uint8_t* _doc;
+		const uint8_t* _end;
+};
+
+static const char* keys[] = {"id", "name", "tags", "values"};
+
+/* @return checksum of all pulled values. */
+static unsigned long long s_pull(PullParser& parser){
+	unsigned long long sum = 0;
+	char str[64];
+	while(true){
+		PullParser::State s = parser.Pull(keys, 4);
+		if(PullParser::ST_NO_DATA == s)
+			break;
+		if(PullParser::ST_DATUM != s)
+			continue;
+
+		const bnj_val& v = parser.GetValue();
+		if(v.key_length)
+			sum += v.key_enum;
+		switch(bnj_val_type(&v)){
+			case BNJ_NUMERIC:
+				sum += v.significand_val;
+				break;
+			case BNJ_STRING:
+				sum += parser.ChunkRead8(str, sizeof(str));
+				break;
+			default:
+				break;
+		}
+	}
+	return sum;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 16;
+	unsigned repeat = (argc > 2) ? strtol(argv[2], NULL, 10) : 5;
+	static const unsigned batches[] = {1, 4, 16, 64, 256};
+	static const unsigned buffsize =
+		(BUFF_OFFSET_MAX < 65536) ? BUFF_OFFSET_MAX : 65536;
+
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = (uint8_t*)malloc(cap + 1024);
+	uint8_t* buffer = (uint8_t*)malloc(buffsize);
+
+	/* Records with a list of 64 numbers and a map of 8 strings. */
+	size_t len = 0;
+	unsigned id = 0;
+	doc[len++] = '[';
+	while(len < cap){
+		len += sprintf((char*)doc + len, "{\"id\":%u,\"values\":[", id++);
+		for(unsigned f = 0; f < 64; ++f)
+			len += sprintf((char*)doc + len, "%s%u", f ? "," : "", s_rand());
+		len += sprintf((char*)doc + len, "],\"tags\":{");
+		for(unsigned f = 0; f < 8; ++f)
+			len += sprintf((char*)doc + len, "%s\"t%u\":\"tag%u\"", f ? "," : "", f,
+				s_rand());
+		len += sprintf((char*)doc + len, "},\"name\":\"record %u\"},", id);
+	}
+	doc[len - 1] = ']';
+
+	int ret = 0;
+	unsigned long long expect = 0;
+	uint32_t pstack[16];
+	bnj_val* values = new bnj_val[256];
+	for(unsigned b = 0; b < sizeof(batches) / sizeof(batches[0]); ++b){
+		unsigned long long sum_buffer = 0;
+		unsigned long long sum_reader = 0;
+
+		double begin = s_now();
+		for(unsigned r = 0; r < repeat; ++r){
+			PullParser parser(16, pstack, batches[b], values);
+			parser.Begin(doc, len);
+			sum_buffer = s_pull(parser);
+		}
+		const double t_buffer = (double)len * repeat / (s_now() - begin) / 1e6;
+
+		begin = s_now();
+		for(unsigned r = 0; r < repeat; ++r){
+			Mem_Reader reader(doc, len);
+			PullParser parser(16, pstack, batches[b], values);
+			parser.Begin(buffer, buffsize, &reader);
+			sum_reader = s_pull(parser);
+		}
+		const double t_reader = (double)len * repeat / (s_now() - begin) / 1e6;
+
+		printf("batch %3u: buffer %8.1f MB/s, reader %8.1f MB/s\n", batches[b],
+			t_buffer, t_reader);
+
+		if(!b)
+			expect = sum_buffer;
+		if(sum_buffer != expect || sum_reader != expect){
+			fprintf(stderr, "batch %u checksum mismatch\n", batches[b]);
+			ret = 1;
+		}
+	}
+
+	delete[] values;
+	free(buffer);
+	free(doc);
+	return ret;
+}
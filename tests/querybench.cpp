@@ -0,0 +1,208 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+#include <benejson/query.hh>
+
+/* JSONPath query benchmark.
+ * Generates a document with a long list of items, some carrying an error
+ * object a few levels down, then finds $.items[*].id and $..error: once
+ * walking every value with Pull() and tracking the path by hand, and once
+ * with a PathQuery. Both must find the same values.
+ * Usage: querybench [doc_mb] */
+
+using BNJ::PullParser;
+using BNJ::PathQuery;
+
+static unsigned s_rng = 12345;
+
+static unsigned s_rand(void){
+	s_rng = s_rng * 1103515245 + 12345;
+	return (s_rng >> 16) & 0x7FFF;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Sorted keys the walk and error objects look for. */
+static const char* s_keys[] = {"code", "error", "id", "items"};
+
+enum {
+	KEY_CODE,
+	KEY_ERROR,
+	KEY_ID,
+	KEY_ITEMS,
+	KEY_COUNT
+};
+
+/* @return Code of the error object the parser is at. */
+static unsigned s_code(PullParser& parser){
+	unsigned code = 0;
+	while(parser.Pull(s_keys, KEY_COUNT) != PullParser::ST_ASCEND_MAP){
+		if(KEY_CODE == parser.GetValue().key_enum)
+			code = parser.GetValue().significand_val;
+		else
+			parser.Skip();
+	}
+	return code;
+}
+
+/* Walk the value the parser is at; where is 0 at the root, 1 in items,
+ * 2 in an item, 3 elsewhere.
+ * @return Sum of ids and error codes found. */
+static unsigned long long s_walk(PullParser& parser, unsigned where){
+	unsigned long long sum = 0;
+	const PullParser::State s = parser.GetState();
+	if(PullParser::ST_DATUM == s)
+		return 0;
+
+	const unsigned depth = parser.Depth();
+	while(true){
+		const PullParser::State c = parser.Pull(s_keys, KEY_COUNT);
+		if(parser.Depth() < depth)
+			return sum;
+
+		const unsigned k = (PullParser::ST_MAP == s)
+			? parser.GetValue().key_enum : KEY_COUNT;
+		if(KEY_ERROR == k && PullParser::ST_MAP == c){
+			sum += s_code(parser);
+			continue;
+		}
+		if(2 == where && KEY_ID == k)
+			sum += parser.GetValue().significand_val;
+
+		unsigned next = 3;
+		if(0 == where && KEY_ITEMS == k)
+			next = 1;
+		else if(1 == where)
+			next = 2;
+		sum += s_walk(parser, next);
+	}
+}
+
+/* Sums ids and error codes. */
+class Summer : public PathQuery::Handler {
+	public:
+		Summer(void) throw() : sum(0), _id(false), _error(0) {}
+
+		void Match(unsigned query, PullParser& parser){
+			if(0 == query)
+				_id = true;
+			else if(PullParser::ST_MAP == parser.GetState())
+				_error = parser.Depth();
+		}
+
+		void Value(PullParser& parser){
+			if(_id){
+				sum += parser.GetValue().significand_val;
+				_id = false;
+			}
+			else if(parser.Depth() < _error){
+				_error = 0;
+			}
+			else if(parser.Depth() == _error && !parser.Descended()){
+				char key[8];
+				if(BNJ::TryGetKey(key, sizeof(key), parser) == 4
+					&& !strcmp(key, s_keys[KEY_CODE]))
+				{
+					sum += parser.GetValue().significand_val;
+				}
+			}
+		}
+
+		unsigned long long sum;
+
+	private:
+		/* Next value is an id. */
+		bool _id;
+
+		/* Depth inside the error map being read; 0 if none. */
+		unsigned _error;
+};
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 32;
+
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = (uint8_t*)malloc(cap + 4096);
+
+	/* Items of about 500 bytes; one in 20 has an error. */
+	size_t len = sprintf((char*)doc, "{\"meta\":{\"source\":\"gen\"},\"items\":[");
+	unsigned items = 0;
+	while(len < cap){
+		len += sprintf((char*)doc + len, "%s{\"name\":\"", items ? "," : "");
+		for(unsigned c = 0; c < 40; ++c)
+			doc[len++] = 'a' + s_rand() % 26;
+		len += sprintf((char*)doc + len, "\",\"attrs\":{\"size\":%u,\"vals\":[",
+			s_rand());
+		for(unsigned v = 0; v < 24; ++v)
+			len += sprintf((char*)doc + len, "%s%u.%u", v ? "," : "", s_rand(),
+				s_rand());
+		len += sprintf((char*)doc + len, "],\"ctx\":{\"tags\":[\"t%u\",\"t%u\"]",
+			s_rand() % 8, s_rand() % 8);
+		if(!(s_rand() % 20)){
+			len += sprintf((char*)doc + len,
+				",\"error\":{\"code\":%u,\"msg\":\"failed\"}", s_rand());
+		}
+		len += sprintf((char*)doc + len, "}},\"notes\":\"");
+		for(unsigned c = 0; c < 200; ++c)
+			doc[len++] = 'a' + s_rand() % 26;
+		len += sprintf((char*)doc + len, "\",\"id\":%u}", s_rand());
+		++items;
+	}
+	len += sprintf((char*)doc + len, "]}");
+
+	static const char* queries[] = {"$.items[*].id", "$..error"};
+	unsigned step_len, text_len, words;
+	PathQuery::StorageSize(queries, 2, step_len, text_len, words);
+	PathQuery::Step steps[step_len];
+	const char* keys[step_len];
+	char text[text_len];
+	uint64_t sets[words * 17];
+	PathQuery query(steps, keys, step_len, text, text_len, sets, words * 17);
+	const char* err = query.Compile(queries, 2);
+	if(err){
+		fprintf(stderr, "%s\n", err);
+		free(doc);
+		return 1;
+	}
+
+	unsigned long long sums[2];
+	double times[2];
+	uint32_t pstack[16];
+
+	double begin = s_now();
+	{
+		PullParser parser(16, pstack);
+		parser.Begin(doc, len);
+		parser.Pull();
+		sums[0] = s_walk(parser, 0);
+	}
+	times[0] = s_now() - begin;
+
+	begin = s_now();
+	{
+		PullParser parser(16, pstack);
+		parser.Begin(doc, len);
+		Summer summer;
+		query.Extract(parser, summer);
+		sums[1] = summer.sum;
+	}
+	times[1] = s_now() - begin;
+
+	printf("%zu bytes, %u items: walk %.2fs (%.0f MB/s), "
+		"query %.2fs (%.0f MB/s)\n", len, items,
+		times[0], len / times[0] / 1e6, times[1], len / times[1] / 1e6);
+
+	free(doc);
+
+	if(sums[0] != sums[1]){
+		fprintf(stderr, "checksum mismatch\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,203 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <benejson/pull.hh>
+#include <benejson/query.hh>
+#include "posix.hh"
+
+/* JSONPath query tests. Each stream of documents is matched against a set of
+ * queries, through readers fed a few bytes per read and in place. Handler
+ * calls are traced: "query:" at each match, then the values handed over,
+ * numbers and 'strings' followed by a space, brackets as themselves. Each
+ * document ends with its match count and '|'; the stream with '.' at its
+ * end or 'E' on errors. */
+
+using BNJ::PullParser;
+using BNJ::PathQuery;
+
+struct query_test {
+	const char* json;
+	const char* queries[3];
+	unsigned count;
+	const char* trace;
+};
+
+static const query_test s_query[] = {
+	/* Members, elements and wildcards. */
+	{"{\"a\":1,\"b\":[2,3],\"c\":{\"a\":4}}", {"$.a", "$.b[1]", "$.c.*"}, 3,
+		"0:1 1:3 2:4 3|."},
+	{"{\"a b\":1,\"c.d\":2,\"e'f\":3}", {"$['a b']", "$[\"c.d\"]", "$['e\\'f']"},
+		3, "0:1 1:2 2:3 3|."},
+	{"[[1,2],[3,4]]", {"$[*][0]"}, 1, "0:1 0:3 2|."},
+	{"{\"a\":[1,2]}", {"$"}, 1, "0:{[1 2 ]}1|."},
+
+	/* Several queries at one value see it once, in query order. */
+	{"{\"a\":\"s\",\"b\":2}", {"$.a", "$.*", "$..a"}, 3, "0:1:2:'s' 1:2 4|."},
+
+	/* Matches inside others are all reported. */
+	{"{\"items\":[{\"id\":1},{\"id\":2,\"b\":\"x\"},{\"c\":{\"id\":3}}]}",
+		{"$.items[*].id", "$.items[1]"}, 2, "0:1 1:{0:2 'x' }3|."},
+	{"{\"id\":{\"id\":1},\"a\":[{\"id\":2}],\"b\":{\"c\":{\"id\":\"s\"}}}",
+		{"$..id"}, 1, "0:{0:1 }0:2 0:'s' 4|."},
+	{"{\"x\":{\"\":1,\"a\":[{\"\":\"z\"}]}}", {"$.x", "$..*"}, 2,
+		"0:1:{1:1 1:[1:{1:'z' }]}6|."},
+	{"[[1,[2]],[3]]", {"$..[0]", "$[1]"}, 2, "0:[0:1 [0:2 ]]1:[0:3 ]5|."},
+
+	/* Each call handles the next document. */
+	{"{\"b\":[1,{\"b\":2}],\"a\":0} [{\"b\":3}] 7 ", {"$.b"}, 1,
+		"0:[1 {2 }]1|0|0|."},
+};
+
+/* Trace handler calls. */
+class Tracer : public PathQuery::Handler {
+	public:
+		void Match(unsigned query, PullParser& parser){
+			char text[16];
+			snprintf(text, sizeof(text), "%u:", query);
+			trace += text;
+		}
+
+		void Value(PullParser& parser){
+			switch(parser.GetState()){
+				case PullParser::ST_MAP:
+					trace += "{";
+					break;
+
+				case PullParser::ST_LIST:
+					trace += "[";
+					break;
+
+				case PullParser::ST_ASCEND_MAP:
+					trace += "}";
+					break;
+
+				case PullParser::ST_ASCEND_LIST:
+					trace += "]";
+					break;
+
+				default:
+					if(BNJ_STRING == bnj_val_type(&parser.GetValue())){
+						char text[64];
+						const int len = parser.TryChunkRead8(text, sizeof(text));
+						trace += "'";
+						if(len > 0)
+							trace.append(text, len);
+						trace += "' ";
+					}
+					else{
+						unsigned n = 0;
+						char num[16];
+						BNJ::TryGet(n, parser);
+						snprintf(num, sizeof(num), "%u ", n);
+						trace += num;
+					}
+			}
+		}
+
+		std::string trace;
+};
+
+/* Pulls in Match(), which PathQuery does not allow. */
+class Puller : public PathQuery::Handler {
+	public:
+		void Match(unsigned query, PullParser& parser){
+			parser.TryPull();
+		}
+};
+
+/* @param chunk Bytes per read; 0 matches in place.
+ * @return trace of matching the stream. */
+static std::string s_trace(const query_test& t, unsigned chunk,
+	PathQuery::Handler* handler)
+{
+	unsigned step_len, text_len, words;
+	PathQuery::StorageSize(t.queries, t.count, step_len, text_len, words);
+	PathQuery::Step steps[step_len];
+	const char* keys[step_len];
+	char text[text_len];
+	uint64_t sets[words * 8];
+	PathQuery query(steps, keys, step_len, text, text_len, sets, words * 8);
+	if(query.Compile(t.queries, t.count))
+		return "compile error";
+
+	const unsigned len = strlen(t.json);
+	Mem_Reader reader(t.json, len, chunk);
+	uint32_t pstack[8];
+	uint8_t buffer[32];
+	PullParser parser(8, pstack);
+	if(chunk)
+		parser.Begin(buffer, sizeof(buffer), &reader);
+	else
+		parser.Begin((const uint8_t*)t.json, len);
+	parser.SetFraming(PullParser::FRAME_CONCAT);
+
+	Tracer tracer;
+	if(!handler)
+		handler = &tracer;
+	while(true){
+		const int found = query.TryExtract(parser, *handler);
+		if(found < 0)
+			return tracer.trace + "E";
+		if(!found && PullParser::ST_NO_DATA == parser.GetState())
+			return tracer.trace + ".";
+		char count[16];
+		snprintf(count, sizeof(count), "%d|", found);
+		tracer.trace += count;
+	}
+}
+
+int main(int argc, const char* argv[]){
+	unsigned succeeded, failed;
+
+	/* Query test. */
+	const unsigned query_length = sizeof(s_query) / sizeof(query_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < query_length; ++i){
+		bool pass = true;
+		for(unsigned chunk = 0; chunk <= 64; chunk = chunk ? chunk * 4 : 1){
+			const std::string trace = s_trace(s_query[i], chunk, NULL);
+			if(trace != s_query[i].trace){
+				fprintf(stdout, "Query Test %u, chunk %u: expected %s, got %s\n", i,
+					chunk, s_query[i].trace, trace.c_str());
+				pass = false;
+			}
+		}
+		if(pass)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Query Tests total: %u, succeeded: %u, failed %u\n",
+		query_length, succeeded, failed);
+
+	/* Pulling in Match() fails the document. */
+	static const query_test s_pull[] = {
+		{"{\"a\":[1]}", {"$.a"}, 1, "E"},
+		{"{\"a\":{\"b\":1},\"c\":2}", {"$.a", "$.a.b"}, 2, "E"},
+	};
+	const unsigned pull_length = sizeof(s_pull) / sizeof(query_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < pull_length; ++i){
+		bool pass = true;
+		for(unsigned chunk = 0; chunk <= 64; chunk = chunk ? chunk * 4 : 1){
+			Puller puller;
+			const std::string trace = s_trace(s_pull[i], chunk, &puller);
+			if(trace != s_pull[i].trace){
+				fprintf(stdout, "Pull Test %u, chunk %u: expected %s, got %s\n", i,
+					chunk, s_pull[i].trace, trace.c_str());
+				pass = false;
+			}
+		}
+		if(pass)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Pull Tests total: %u, succeeded: %u, failed %u\n",
+		pull_length, succeeded, failed);
+
+	return 0;
+}
@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+#include <benejson/readahead.hh>
+
+/* Read-ahead benchmark.
+ * Pulls a generated document through a Reader that sleeps as if reading from
+ * a device of fixed bandwidth, once directly and once through a
+ * ReadAheadReader. With read-ahead, time should approach the larger of I/O
+ * and parse time rather than their sum.
+ * Usage: readaheadbench [doc_mb [device_mb_per_s]] */
+
+using BNJ::PullParser;
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Reads a document in memory at a limited bandwidth. */
+class Slow_Reader : public PullParser::Reader {
+	public:
+		Slow_Reader(const uint8_t* doc, size_t len, double mb_per_s) throw()
+			: _doc(doc), _end(doc + len), _ns_per_byte(1e3 / mb_per_s) {}
+
+		int Read(uint8_t* buff, unsigned len) throw(){
+			if(len > 65536)
+				len = 65536;
+			if(len > (size_t)(_end - _doc))
+				len = _end - _doc;
+
+			const double ns = len * _ns_per_byte;
+			struct timespec ts = {(time_t)(ns / 1e9), (long)(ns - (time_t)(ns / 1e9) * 1e9)};
+			nanosleep(&ts, NULL);
+
+			memcpy(buff, _doc, len);
+			_doc += len;
+			return len;
+		}
+
+	private:
+		const uint8_t* _doc;
+		const uint8_t* _end;
+		const double _ns_per_byte;
+};
+
+/* @return checksum of all pulled values. */
+static unsigned long long s_pull(PullParser& parser){
+	unsigned long long sum = 0;
+	char str[64];
+	while(true){
+		PullParser::State s = parser.Pull();
+		if(PullParser::ST_NO_DATA == s)
+			break;
+		if(PullParser::ST_DATUM != s)
+			continue;
+
+		const bnj_val& v = parser.GetValue();
+		if(BNJ_NUMERIC == bnj_val_type(&v))
+			sum += v.significand_val;
+		else if(BNJ_STRING == bnj_val_type(&v))
+			sum += parser.ChunkRead8(str, sizeof(str));
+	}
+	return sum;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 32;
+	double device = (argc > 2) ? strtod(argv[2], NULL) : 100.0;
+	static const unsigned buffsize =
+		(BUFF_OFFSET_MAX < 65536) ? BUFF_OFFSET_MAX : 65536;
+	static const unsigned ringsize = 1 << 20;
+
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = (uint8_t*)malloc(cap + 1024);
+	uint8_t* buffer = (uint8_t*)malloc(buffsize);
+	uint8_t* ring = (uint8_t*)malloc(ringsize);
+
+	/* Records with a list of numbers and a few strings. */
+	size_t len = 0;
+	unsigned id = 0;
+	doc[len++] = '[';
+	while(len < cap){
+		len += sprintf((char*)doc + len, "{\"id\":%u,\"values\":[", id);
+		for(unsigned f = 0; f < 32; ++f)
+			len += sprintf((char*)doc + len, "%s%u", f ? "," : "", id * 31 + f);
+		len += sprintf((char*)doc + len, "],\"name\":\"record %u\",\"tag\":\"t%u\"},",
+			id, id % 97);
+		++id;
+	}
+	doc[len - 1] = ']';
+
+	uint32_t pstack[16];
+	unsigned long long sums[3];
+	double times[3];
+
+	/* Parse only, device only, and both through read-ahead. */
+	double begin = s_now();
+	{
+		PullParser parser(16, pstack);
+		parser.Begin(doc, len);
+		sums[0] = s_pull(parser);
+	}
+	times[0] = s_now() - begin;
+
+	begin = s_now();
+	{
+		Slow_Reader reader(doc, len, device);
+		PullParser parser(16, pstack);
+		parser.Begin(buffer, buffsize, &reader);
+		sums[1] = s_pull(parser);
+	}
+	times[1] = s_now() - begin;
+
+	begin = s_now();
+	{
+		Slow_Reader reader(doc, len, device);
+		BNJ::ReadAheadReader ahead(reader, ring, ringsize);
+		PullParser parser(16, pstack);
+		parser.Begin(buffer, buffsize, &ahead);
+		sums[2] = s_pull(parser);
+	}
+	times[2] = s_now() - begin;
+
+	const double io = len / (device * 1e6);
+	printf("%zu bytes, device %.0f MB/s: io %.2fs, parse %.2fs, "
+		"direct %.2fs, read-ahead %.2fs\n", len, device, io, times[0], times[1],
+		times[2]);
+
+	free(ring);
+	free(buffer);
+	free(doc);
+
+	if(sums[1] != sums[0] || sums[2] != sums[0]){
+		fprintf(stderr, "checksum mismatch\n");
+		return 1;
+	}
+	return 0;
+}
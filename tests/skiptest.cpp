@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <cstring>
+
+#include <benejson/pull.hh>
+#include "posix.hh"
+
+/* Up() and Skip() tests. The first member of each document is left with
+ * Up() and with Skip(), reading a few bytes per refill; then the member
+ * after it must be read. Up() validates what it passes over; Skip() only
+ * matches quotes and brackets. */
+
+using BNJ::PullParser;
+
+struct skip_test {
+	const char* json;
+
+	/* Whether Up() and Skip() report an error. */
+	bool up_fails;
+	bool skip_fails;
+};
+
+static const skip_test s_skip[] = {
+	{"{\"a\":{},\"b\":4}", false, false},
+	{"{\"a\":[1,2,{\"c\":[3]}],\"b\":4}", false, false},
+	{"{\"a\":{\"x\":\"]}\\\"[{\",\"y\":[[]]},\"b\":4}", false, false},
+
+	/* Malformed inside, brackets still nest. */
+	{"{\"a\":[1,,2],\"b\":4}", true, false},
+	{"{\"a\":[tru],\"b\":4}", true, false},
+	{"{\"a\":{\"x\" 1},\"b\":4}", true, false},
+	{"{\"a\":[\"\\q\"],\"b\":4}", true, false},
+	{"{\"a\":[\"\\ud800\"],\"b\":4}", true, false},
+	{"{\"a\":[\"\x01\"],\"b\":4}", true, false},
+	{"{\"a\":[\"\xC0\x80\"],\"b\":4}", true, false},
+
+	/* Brackets do not nest. */
+	{"{\"a\":[1,2},\"b\":4}", true, true},
+};
+
+/* @param up Leave with Up() rather than Skip().
+ * @return true if the parser reported an error. */
+static bool s_leave(const char* json, unsigned chunk, bool up, bool& ok){
+	static const char* keys[] = {"a", "b"};
+	Mem_Reader reader(json, strlen(json), chunk);
+	uint32_t pstack[8];
+	uint8_t buffer[64];
+	PullParser parser(8, pstack);
+	parser.Begin(buffer, sizeof(buffer), &reader);
+
+	ok = false;
+	if(PullParser::ST_MAP != parser.TryPull())
+		return true;
+	const PullParser::State s = parser.TryPull(keys, 2);
+	if(PullParser::ST_MAP != s && PullParser::ST_LIST != s)
+		return true;
+
+	if(PullParser::ST_ERROR == (up ? parser.TryUp() : parser.TrySkip()))
+		return true;
+	if(PullParser::ST_DATUM != parser.TryPull(keys, 2))
+		return true;
+
+	/* Next member read whole. */
+	unsigned b;
+	ok = 1 == parser.GetValue().key_enum
+		&& PullParser::ERR_NONE == BNJ::TryGet(b, parser) && 4 == b;
+	return PullParser::ST_ASCEND_MAP != parser.TryPull();
+}
+
+int main(int argc, const char* argv[]){
+	unsigned succeeded, failed;
+
+	const unsigned skip_length = sizeof(s_skip) / sizeof(skip_test);
+	succeeded = 0;
+	failed = 0;
+	for(unsigned i = 0; i < skip_length; ++i){
+		const skip_test& t = s_skip[i];
+		bool pass = true;
+		for(unsigned chunk = 1; chunk <= 64; chunk *= 4){
+			for(unsigned up = 0; up < 2; ++up){
+				bool ok;
+				const bool fails = s_leave(t.json, chunk, up, ok);
+				if(fails != (up ? t.up_fails : t.skip_fails) || (!fails && !ok)){
+					fprintf(stdout, "Skip Test %u, chunk %u, %s %s\n", i, chunk,
+						up ? "Up()" : "Skip()", fails ? "failed" : "passed");
+					pass = false;
+				}
+			}
+		}
+		if(pass)
+			++succeeded;
+		else
+			++failed;
+	}
+	fprintf(stdout, "Skip Tests total: %u, succeeded: %u, failed %u\n",
+		skip_length, succeeded, failed);
+
+	return 0;
+}
@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+#include <benejson/pull.hh>
+
+/* NDJSON streaming benchmark.
+ * Generates small newline delimited records, then pulls every value: once
+ * splitting lines and calling Begin() per record, and once as one stream
+ * with SetFraming(FRAME_LINES), both in memory and through a Reader with a
+ * 64 KiB buffer. All passes must agree.
+ * Usage: streambench [doc_mb] */
+
+using BNJ::PullParser;
+
+static unsigned s_rng = 12345;
+
+static unsigned s_rand(void){
+	s_rng = s_rng * 1103515245 + 12345;
+	return (s_rng >> 16) & 0x7FFF;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Reads a document in memory, at most 64 KiB at a time. */
+class Mem_Reader : public PullParser::Reader {
+	public:
+		Mem_Reader(const uint8_t* doc, size_t len) throw()
+			: _doc(doc), _end(doc + len) {}
+
+		int Read(uint8_t* buff, unsigned len) throw(){
+			if(len > 65536)
+				len = 65536;
+			if(len > (size_t)(_end - _doc))
+				len = _end - _doc;
+			memcpy(buff, _doc, len);
+			_doc += len;
+			return len;
+		}
+
+	private:
+		const uint8_t* _doc;
+		const uint8_t* _end;
+};
+
+/* @return checksum of all pulled values and document ends. */
+static unsigned long long s_pull(PullParser& parser){
+	unsigned long long sum = 0;
+	char str[64];
+	while(true){
+		PullParser::State s = parser.Pull();
+		if(PullParser::ST_NO_DATA == s)
+			break;
+		if(PullParser::ST_DOC_END == s)
+			++sum;
+		if(PullParser::ST_DATUM != s)
+			continue;
+
+		const bnj_val& v = parser.GetValue();
+		if(BNJ_NUMERIC == bnj_val_type(&v))
+			sum += v.significand_val;
+		else if(BNJ_STRING == bnj_val_type(&v)){
+			unsigned n;
+			while((n = parser.ChunkRead8(str, sizeof(str))))
+				sum += n;
+		}
+	}
+	return sum;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 32;
+
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = (uint8_t*)malloc(cap + 1024);
+	static uint8_t buffer[65536];
+
+	/* Records of a few fields each, one per line. */
+	size_t len = 0;
+	while(len < cap){
+		len += sprintf((char*)doc + len,
+			"{\"id\":%u,\"user\":\"u%u\",\"score\":%u,\"tags\":[%u,%u]}\n",
+			s_rand(), s_rand(), s_rand(), s_rand() % 16, s_rand() % 16);
+	}
+
+	uint32_t pstack[16];
+	unsigned long long sums[3] = {0, 0, 0};
+	double times[3];
+
+	/* Begin() per record, as before streaming. */
+	double begin = s_now();
+	{
+		PullParser parser(16, pstack);
+		const uint8_t* line = doc;
+		const uint8_t* const end = doc + len;
+		while(line != end){
+			const uint8_t* nl = (const uint8_t*)memchr(line, '\n', end - line);
+			parser.Begin(line, nl + 1 - line);
+			sums[0] += s_pull(parser) + 1;
+			line = nl + 1;
+		}
+	}
+	times[0] = s_now() - begin;
+
+	begin = s_now();
+	{
+		PullParser parser(16, pstack);
+		parser.Begin(doc, len);
+		parser.SetFraming(PullParser::FRAME_LINES);
+		sums[1] = s_pull(parser);
+	}
+	times[1] = s_now() - begin;
+
+	begin = s_now();
+	{
+		Mem_Reader reader(doc, len);
+		PullParser parser(16, pstack);
+		parser.Begin(buffer, sizeof(buffer) - 1, &reader);
+		parser.SetFraming(PullParser::FRAME_LINES);
+		sums[2] = s_pull(parser);
+	}
+	times[2] = s_now() - begin;
+
+	printf("%zu bytes: Begin() per record %.2fs, stream %.2fs, "
+		"stream from reader %.2fs\n", len, times[0], times[1], times[2]);
+
+	free(doc);
+
+	if(sums[1] != sums[0] || sums[2] != sums[0]){
+		fprintf(stderr, "checksum mismatch\n");
+		return 1;
+	}
+	return 0;
+}
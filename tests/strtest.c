@@ -137,6 +137,12 @@ static const char* s_bad_values[] = {
 
 	/* Start with continuation char.*/
 	"\"abc \x8F abc\"",
+
+	/* Tests 43-45 */
+	/* Beyond U+10FFFF, with the block scan in reach for the last one. */
+	"\"abc \xF4\x90\x80\x80 abc\"",
+	"\"abc \xF4\xBF\xBF\xBF abc\"",
+	"\"abc \xF4\x90\x80\x80 abcdefghijklmnopqrstuvwxyz\"",
 };
 
 static unsigned s_bad_stop[]= {
@@ -208,6 +214,11 @@ static unsigned s_bad_stop[]= {
 
 	/* Start with continuation char.*/
 	4 + 1,
+
+	/* Beyond U+10FFFF. */
+	4 + 4,
+	4 + 4,
+	4 + 4,
 };
 
 struct good_test s_good[] = {
@@ -345,6 +356,71 @@ struct good_test s_good[] = {
 
 };
 
+/* Keys sorted as unsigned bytes. */
+static const char* s_keys[] = {
+	"a",
+	"ab",
+	"b/",
+	"caf\xC3\xA9",
+	"q\"t",
+	"z",
+	"\xC3\xA9t\xC3\xA9",
+	"\xF0\x9F\x98\x80",
+};
+
+#define KEY_COUNT (sizeof(s_keys) / sizeof(const char*))
+
+struct key_test {
+	const char* json;
+	unsigned key_enum;
+	unsigned key_length;
+};
+
+/* Keys match once unescaped; key_length counts the raw bytes. */
+static const struct key_test s_key_tests[] = {
+	{"{\"a\":1}", 0, 1},
+	{"{\"ab\":1}", 1, 2},
+	{"{\"a\\u0062\":1}", 1, 7},
+	{"{\"\\u0061\\u0062\":1}", 1, 12},
+	{"{\"\\u0061\":1}", 0, 6},
+	{"{\"b\\/\":1}", 2, 3},
+	{"{\"caf\xC3\xA9\":1}", 3, 5},
+	{"{\"caf\\u00e9\":1}", 3, 9},
+	{"{\"q\\\"t\":1}", 4, 4},
+	{"{\"\\u007a\":1}", 5, 6},
+	{"{\"\xC3\xA9t\xC3\xA9\":1}", 6, 5},
+	{"{\"\\u00e9t\\u00E9\":1}", 6, 13},
+	{"{\"\xF0\x9F\x98\x80\":1}", 7, 4},
+	{"{\"\\ud83d\\ude00\":1}", 7, 12},
+
+	/* No match. */
+	{"{\"ca\":1}", KEY_COUNT, 2},
+	{"{\"caf\\u00e9x\":1}", KEY_COUNT, 10},
+	{"{\"\xC3\xA9\":1}", KEY_COUNT, 2},
+	{"{\"a\\n\":1}", KEY_COUNT, 3},
+	{"{\"\\u0000\":1}", KEY_COUNT, 6},
+};
+
+struct key_result {
+	unsigned key_enum;
+	unsigned key_length;
+	unsigned count;
+};
+
+/* Record key of the completed numeric value. */
+static int s_key_cb(const bnj_state* state, bnj_ctx* ctx, const uint8_t* buff){
+	struct key_result* r = ctx->user_data;
+	for(unsigned i = 0; i < state->vi; ++i){
+		if(BNJ_NUMERIC == (state->v[i].type & BNJ_TYPE_MASK)
+			&& !(state->v[i].type & BNJ_VFLAG_VAL_FRAGMENT))
+		{
+			r->key_enum = state->v[i].key_enum;
+			r->key_length = state->v[i].key_length;
+			++r->count;
+		}
+	}
+	return 0;
+}
 
 int main(int argc, const char* argv[]){
 	uint32_t stackbuff[128];
@@ -528,5 +604,128 @@ int main(int argc, const char* argv[]){
 	fprintf(stdout, "Good Frag Tests total: %u, succeeded: %u, failed %u\n",
 		good_length, succeeded, failed);
 
+	/* Split good test. Break each string in two at every offset, so
+	 * characters and escapes are cut off at every byte. */
+	succeeded = 0;
+	failed = 0;
+	for(i = 0; i < good_length; ++i){
+		const uint8_t* json = (const uint8_t*)s_good[i].json;
+		unsigned maxlen = strlen(s_good[i].json);
+		unsigned expect = strlen((const char*)s_good[i].utf8);
+		unsigned ok = 1;
+
+		for(unsigned x = 1; x < maxlen && ok; ++x){
+			bnj_state_init(&mstate, stackbuff, 128);
+			mstate.v = values;
+			mstate.vlen = 16;
+
+			unsigned cp_count[4] = {0, 0, 0, 0};
+			uint8_t cpbuffer[64];
+			uint8_t* w = cpbuffer;
+
+			for(unsigned half = 0; half < 2 && ok; ++half){
+				const uint8_t* begin = half ? json + x : json;
+				const unsigned len = half ? maxlen - x : x;
+				const uint8_t* res = bnj_parse(&mstate, &ctx, begin, len);
+				if(mstate.flags & BNJ_ERROR_MASK){
+					fprintf(stdout, "Split Test %u at %u, Detected error %x at %u\n",
+						i, x, mstate.flags, (unsigned)(res - json));
+					ok = 0;
+					break;
+				}
+				cp_count[0] += values->cp1_count;
+				cp_count[1] += values->cp2_count;
+				cp_count[2] += values->cp3_count;
+				cp_count[3] += values->exp_val;
+				w = bnj_stpcpy8(w, values, begin);
+			}
+			if(!ok)
+				break;
+
+			if(cp_count[0] != s_good[i].cp1_count
+				|| cp_count[1] != s_good[i].cp2_count
+				|| cp_count[2] != s_good[i].cp3_count
+				|| cp_count[3] != s_good[i].cp4_count)
+			{
+				fprintf(stdout, "Split Test %u at %u, Mismatched cp counts\n", i, x);
+				ok = 0;
+			}
+			else if(w - cpbuffer != expect || memcmp(cpbuffer, s_good[i].utf8, expect)){
+				fprintf(stdout, "Split Test %u at %u, UTF-8 content failure\n", i, x);
+				ok = 0;
+			}
+		}
+
+		if(ok)
+			++succeeded;
+		else
+			++failed;
+	}
+
+	fprintf(stdout, "Split Tests total: %u, succeeded: %u, failed %u\n",
+		good_length, succeeded, failed);
+
+	/* Key test. Match each key against a key set and a key matcher, whole
+	 * and a byte at a time. Only whole keys have one key_length. */
+	const unsigned key_length = sizeof(s_key_tests) / sizeof(struct key_test);
+	uint16_t km_storage[1024];
+	bnj_keymatcher km;
+	if(!bnj_keymatcher_init(&km, s_keys, KEY_COUNT, km_storage, 1024)){
+		fprintf(stdout, "Key matcher init failed\n");
+		return 1;
+	}
+	succeeded = 0;
+	failed = 0;
+	for(i = 0; i < key_length; ++i){
+		const struct key_test* kt = s_key_tests + i;
+		const unsigned maxlen = strlen(kt->json);
+		unsigned ok = 1;
+
+		for(unsigned mode = 0; mode < 4 && ok; ++mode){
+			struct key_result r = {0, 0, 0};
+			bnj_ctx kctx = {
+				.user_cb = s_key_cb,
+				.user_data = &r,
+				.key_set = s_keys,
+				.key_set_length = KEY_COUNT,
+				.key_matcher = (mode & 1) ? &km : NULL,
+			};
+			const unsigned step = (mode & 2) ? 1 : maxlen;
+
+			bnj_state_init(&mstate, stackbuff, 128);
+			mstate.v = values;
+			mstate.vlen = 16;
+			for(unsigned x = 0; x < maxlen; x += step){
+				bnj_parse(&mstate, &kctx, (uint8_t*)kt->json + x, step);
+				if(mstate.flags & BNJ_ERROR_MASK)
+					break;
+			}
+
+			if(mstate.flags & BNJ_ERROR_MASK){
+				fprintf(stdout, "Key Test %u, mode %u, Detected error %x\n", i, mode,
+					mstate.flags);
+				ok = 0;
+			}
+			else if(!r.count || kt->key_enum != r.key_enum){
+				fprintf(stdout, "Key Test %u, mode %u, key_enum expected %u, got %u\n",
+					i, mode, kt->key_enum, r.key_enum);
+				ok = 0;
+			}
+			else if(step != 1 && kt->key_length != r.key_length){
+				fprintf(stdout, "Key Test %u, key_length expected %u, got %u\n",
+					i, kt->key_length, r.key_length);
+				ok = 0;
+			}
+		}
+
+		if(ok)
+			++succeeded;
+		else
+			++failed;
+	}
+
+	fprintf(stdout, "Key Tests total: %u, succeeded: %u, failed %u\n",
+		key_length, succeeded, failed);
+
 	return 0;
 }
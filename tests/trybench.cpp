@@ -0,0 +1,127 @@
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+
+#include <benejson/pull.hh>
+
+/* Optional field probing benchmark.
+ * Generates records whose fields are numbers, strings or null at random,
+ * then probes every value as a number: once with Get() and catching the
+ * mismatch, once with TryGet(). Both passes must agree.
+ * Usage: trybench [doc_mb] */
+
+using BNJ::PullParser;
+
+static unsigned s_rng = 12345;
+
+static unsigned s_rand(void){
+	s_rng = s_rng * 1103515245 + 12345;
+	return (s_rng >> 16) & 0x7FFF;
+}
+
+static double s_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* @return checksum of values that are numbers, plus mismatch count. */
+static unsigned long long s_probe_throw(PullParser& parser){
+	unsigned long long sum = 0;
+	while(true){
+		PullParser::State s = parser.Pull();
+		if(PullParser::ST_NO_DATA == s)
+			break;
+		if(PullParser::ST_DATUM != s)
+			continue;
+
+		unsigned u;
+		try{
+			BNJ::Get(u, parser);
+			sum += u;
+		}
+		catch(const std::exception&){
+			++sum;
+		}
+	}
+	return sum;
+}
+
+static unsigned long long s_probe_try(PullParser& parser){
+	unsigned long long sum = 0;
+	while(true){
+		PullParser::State s = parser.TryPull();
+		if(PullParser::ST_NO_DATA == s || PullParser::ST_ERROR == s)
+			break;
+		if(PullParser::ST_DATUM != s)
+			continue;
+
+		unsigned u;
+		if(BNJ::TryGet(u, parser))
+			++sum;
+		else
+			sum += u;
+	}
+	return sum;
+}
+
+int main(int argc, const char* argv[]){
+	unsigned doc_mb = (argc > 1) ? strtol(argv[1], NULL, 10) : 8;
+
+	size_t cap = (size_t)doc_mb << 20;
+	uint8_t* doc = (uint8_t*)malloc(cap + 1024);
+
+	/* Records of 8 fields; about half are not numbers. */
+	size_t len = 0;
+	doc[len++] = '[';
+	while(len < cap){
+		doc[len++] = '{';
+		for(unsigned f = 0; f < 8; ++f){
+			len += sprintf((char*)doc + len, "%s\"f%u\":", f ? "," : "", f);
+			switch(s_rand() % 4){
+				case 0:
+					len += sprintf((char*)doc + len, "\"s%u\"", s_rand());
+					break;
+				case 1:
+					len += sprintf((char*)doc + len, "null");
+					break;
+				default:
+					len += sprintf((char*)doc + len, "%u", s_rand());
+					break;
+			}
+		}
+		len += sprintf((char*)doc + len, "},");
+	}
+	doc[len - 1] = ']';
+
+	uint32_t pstack[16];
+	unsigned long long sums[2];
+	double times[2];
+
+	double begin = s_now();
+	{
+		PullParser parser(16, pstack);
+		parser.Begin(doc, len);
+		sums[0] = s_probe_throw(parser);
+	}
+	times[0] = s_now() - begin;
+
+	begin = s_now();
+	{
+		PullParser parser(16, pstack);
+		parser.Begin(doc, len);
+		sums[1] = s_probe_try(parser);
+	}
+	times[1] = s_now() - begin;
+
+	printf("%zu bytes: Get/catch %.2fs, TryGet %.2fs\n", len, times[0],
+		times[1]);
+
+	free(doc);
+
+	if(sums[1] != sums[0]){
+		fprintf(stderr, "checksum mismatch\n");
+		return 1;
+	}
+	return 0;
+}